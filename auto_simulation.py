@@ -12,6 +12,7 @@ from requirements import FusionValidator
 # --- Configuration & Path Mapping ---
 BASE_RESULTS_DIR = "./simulation_results"
 LOG_SOURCE = "./logs/logs/results.csv"  # Path where C++ writes inside the shared volume
+SUMMARY_SOURCE = "./logs/logs/summary.csv"  # Per-track accuracy summary written at shutdown
 SIM_TIME = "30"                    # Duration in seconds for each test
 
 # --- DO-178C Test Suite Definition ---
@@ -47,9 +48,10 @@ class TestExecutive:
         subprocess.run(["docker-compose", "down", "-v"], env=full_env, capture_output=True)
         
         # Clean any residual CSV log files to ensure fresh state
-        if os.path.exists(LOG_SOURCE):
-            os.remove(LOG_SOURCE)
-            print(f"[INFO] Cleared residual log: {LOG_SOURCE}")
+        for residual in (LOG_SOURCE, SUMMARY_SOURCE):
+            if os.path.exists(residual):
+                os.remove(residual)
+                print(f"[INFO] Cleared residual log: {residual}")
 
         # 2. Launch simulation
         try:
@@ -65,6 +67,9 @@ class TestExecutive:
             print(f"[ERROR] Fatal error during {tc_id}: {e}")
 
         # 3. Retrieve results
+        if os.path.exists(SUMMARY_SOURCE):
+            shutil.copy(SUMMARY_SOURCE, os.path.join(self.batch_path, f"{tc_id}_summary.csv"))
+
         if os.path.exists(LOG_SOURCE):
             dest_file = f"{tc_id}_{config['name']}.csv"
             dest_path = os.path.join(self.batch_path, dest_file)
@@ -120,6 +125,14 @@ class TestExecutive:
                 for srid, check in res['checks'].items():
                     status = "PASS" if check['pass'] else "FAIL"
                     f.write(f"  {srid}: Measured={check['val']} | {check['detail']} -> [{status}]\n")
+
+                # Per-track statistics computed online by the fusion service
+                summary_path = os.path.join(self.batch_path, f"{res['id']}_summary.csv")
+                if os.path.exists(summary_path):
+                    for _, row in pd.read_csv(summary_path).iterrows():
+                        f.write(f"  Track {int(row['track_id'])}: RMSE={row['rmse_m']:.2f}m | "
+                                f"NEES={row['avg_nees']:.3g} | NIS={row['avg_nis']:.3g} | "
+                                f"Converged={row['convergence_s']:.2f}s | Purity={row['purity']:.2f}\n")
                 f.write("\n")
 
         print(f"\n>>> [COMPLETED] Final SVR Report generated: {report_path}")
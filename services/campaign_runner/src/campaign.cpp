@@ -0,0 +1,155 @@
+#include "campaign.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "geo_utils.h"
+#include "kalman_filter.h"
+#include "track_update.h"
+
+namespace
+{
+    constexpr uint64_t TICK_MS = 100;       // Radar look and fusion cycle period
+    constexpr uint64_t UAV_PERIOD_MS = 1000;
+    constexpr uint64_t EPOCH_MS = 1;        // Keeps timestamps non-zero ("never fused")
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+
+    struct Detection
+    {
+        const std::string* sensor_id;
+        double lat;
+        double lon;
+        double range_rate;
+        double range_rate_sigma;
+        double bearing;
+    };
+}
+
+uint64_t TrialSeed(uint64_t base_seed, uint64_t index)
+{
+    // splitmix64
+    uint64_t z = base_seed + (index + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+TrialResult RunTrial(const Scenario& scenario, uint64_t seed)
+{
+    std::seed_seq seq{(uint32_t)seed, (uint32_t)(seed >> 32)};
+    std::mt19937 gen(seq);
+
+    models::UavState uav = scenario.uav;
+    KalmanFilter kf;
+    uint64_t last_fusion_ns = 0;
+    std::vector<models::RadarModel> radars(scenario.radars.begin(), scenario.radars.end());
+    std::vector<Detection> batch;
+    batch.reserve(scenario.radars.size());
+
+    TrialResult r;
+    double sum_sq = 0.0, sum = 0.0;
+    uint64_t looks = 0, detections = 0;
+    uint32_t position_updates = 0;
+    const uint64_t duration_ms = (uint64_t)(scenario.duration_s * 1000.0);
+    const uint64_t warmup_ms = (uint64_t)(scenario.warmup_s * 1000.0);
+    const uint64_t look_ms = std::max(TICK_MS, scenario.look_period_ms / TICK_MS * TICK_MS);
+
+    for (uint64_t t = 0; t < duration_ms; t += TICK_MS)
+    {
+        // Telemetry (and the truth radars see) changes once a second.
+        if (t % UAV_PERIOD_MS == 0)
+            models::StepUav(uav);
+
+        if (t % look_ms != 0)
+            continue;
+        batch.clear();
+        for (models::RadarModel& radar : radars)
+        {
+            ++looks;
+            models::RadarDetection det;
+            if (radar.Detect({uav.lat, uav.lon, uav.alt, uav.heading, uav.v_north, uav.v_east}, gen, det))
+            {
+                ++detections;
+                batch.push_back({&radar.config().id, det.lat, det.lon, det.range_rate, radar.range_rate_sigma(),
+                                 det.bearing});
+            }
+        }
+        if (batch.empty())
+            continue;
+
+        // Same per-track steps as FusionServiceImpl::ProcessBatch.
+        uint64_t ts = (EPOCH_MS + t) * 1000000;
+        kf.Predict(PredictInterval(last_fusion_ns, ts));
+        last_fusion_ns = ts;
+        for (const Detection& d : batch)
+        {
+            if (std::abs(d.lat) < 1.0)
+                continue;
+            if (GatedUpdate(kf, *d.sensor_id, d.lat, d.lon))
+                ++r.gated;
+            RangeRateUpdate(kf, d.range_rate, d.bearing, d.range_rate_sigma);
+            ++position_updates;
+        }
+
+        double f_lat, f_lon, v_lat, v_lon;
+        kf.GetState(f_lat, f_lon, v_lat, v_lon);
+        double err = geo_utils::CalculateHaversine(f_lat, f_lon, uav.lat, uav.lon);
+        r.final_error_m = err;
+
+        // Velocity states are deg/s; the truth is the UAV's last step in m/s.
+        double v_err = std::hypot(v_lat * METERS_PER_DEG_LAT - uav.v_north,
+                                  v_lon * METERS_PER_DEG_LAT * std::cos(f_lat * M_PI / 180.0) - uav.v_east);
+        r.final_velocity_error_m_s = v_err;
+        if (v_err > scenario.velocity_tol_mps)
+            r.velocity_converged_updates = -1;
+        else if (r.velocity_converged_updates < 0)
+        {
+            r.velocity_converged_updates = (int32_t)position_updates;
+            r.velocity_converged_s = (t + TICK_MS) / 1000.0;
+        }
+        if (t < warmup_ms)
+            continue;
+        sum += err;
+        sum_sq += err * err;
+        r.max_error_m = std::max(r.max_error_m, err);
+        ++r.updates;
+    }
+
+    if (r.updates > 0)
+    {
+        r.rmse_m = std::sqrt(sum_sq / r.updates);
+        r.mean_error_m = sum / r.updates;
+    }
+    r.detection_rate = looks ? (double)detections / looks : 0.0;
+    if (r.velocity_converged_updates < 0)
+        r.velocity_converged_s = -1.0;
+    return r;
+}
+
+Estimate MeanCi(const std::vector<double>& values)
+{
+    Estimate e;
+    if (values.empty())
+        return e;
+    double n = (double)values.size();
+    for (double v : values)
+        e.mean += v;
+    e.mean /= n;
+    if (values.size() < 2)
+        return e;
+    double ss = 0.0;
+    for (double v : values)
+        ss += (v - e.mean) * (v - e.mean);
+    e.ci95 = 1.96 * std::sqrt(ss / (n - 1.0)) / std::sqrt(n);
+    return e;
+}
+
+double Percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    size_t idx = std::min(values.size() - 1, (size_t)(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sensor_models.h"
+
+// One parameter combination of a campaign.
+struct Scenario
+{
+    std::string label;                       // "rain=5 rcs=on ..." (swept keys only)
+    models::UavState uav;
+    std::vector<models::RadarConfig> radars;
+    double duration_s = 30.0;
+    double warmup_s = 5.0;                   // Errors before this are not scored
+    uint64_t look_period_ms = 100;           // Radar revisit time, multiple of 100 ms
+    double velocity_tol_mps = 5.0;           // Velocity accuracy for convergence
+};
+
+// Outcome of one seeded trial.
+struct TrialResult
+{
+    double rmse_m = 0.0;
+    double mean_error_m = 0.0;
+    double max_error_m = 0.0;
+    double final_error_m = 0.0;
+    double detection_rate = 0.0;             // Detections per radar look
+    uint32_t updates = 0;                    // Scored fusion cycles
+    uint32_t gated = 0;                      // Measurements with inflated R
+    double final_velocity_error_m_s = 0.0;
+    // Position updates (and seconds) from track start until the velocity
+    // error stays within velocity_tol_mps; -1 when it never settles.
+    int32_t velocity_converged_updates = -1;
+    double velocity_converged_s = -1.0;
+};
+
+// Runs one trial on a virtual clock: the UAV model steps at 1 Hz, each
+// radar looks at the latest UAV state every look_period_ms, and each 100 ms
+// batch is fused through the fusion service's filter code, including the
+// Doppler range-rate update of radars that measure it.
+TrialResult RunTrial(const Scenario& scenario, uint64_t seed);
+
+// Mean with a 95% normal-approximation confidence half-width.
+struct Estimate
+{
+    double mean = 0.0;
+    double ci95 = 0.0;
+};
+Estimate MeanCi(const std::vector<double>& values);
+double Percentile(std::vector<double> values, double p);
+
+// Seed of trial `index`, shared by all scenarios (common random numbers,
+// so differences between scenarios are not masked by noise).
+uint64_t TrialSeed(uint64_t base_seed, uint64_t index);
@@ -0,0 +1,306 @@
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "campaign.h"
+
+namespace
+{
+    struct CampaignConfig
+    {
+        size_t trials = 1000;
+        double duration_s = 30.0;
+        double warmup_s = 5.0;
+        double velocity_tol_mps = 5.0;
+        uint64_t seed = 1;
+        unsigned threads = 0;  // 0: hardware concurrency
+        std::string out_path;
+        std::vector<std::pair<std::string, std::vector<std::string>>> sweeps;
+    };
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: campaign_runner [options]\n"
+                  << "  --trials=N            Monte Carlo trials per scenario (default 1000)\n"
+                  << "  --duration=SEC        Simulated seconds per trial (default 30)\n"
+                  << "  --warmup=SEC          Leading seconds not scored (default 5)\n"
+                  << "  --vel-tol=M/S         Velocity error counted as converged (default 5)\n"
+                  << "  --seed=N              Base seed (default 1)\n"
+                  << "  --threads=N           Worker threads (default: all cores)\n"
+                  << "  --sweep=KEY=V1,V2,..  Sweep a parameter; repeat for a full grid. Keys:\n"
+                  << "                        rain (mm/h), rcs (on|off), freq (GHz), range_sigma (m),\n"
+                  << "                        bearing_sigma (deg), doppler (Hz noise, 0 = off),\n"
+                  << "                        look_ms (radar revisit), uav_lat, uav_lon, heading (deg)\n"
+                  << "  --out=PATH            Also write the summary as CSV\n";
+    }
+
+    bool ParseArg(const std::string &arg, const std::string &key, std::string &value)
+    {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+
+    std::vector<std::string> Split(const std::string &s, char sep)
+    {
+        std::vector<std::string> parts;
+        std::stringstream ss(s);
+        std::string item;
+        while (std::getline(ss, item, sep))
+        {
+            if (!item.empty())
+                parts.push_back(item);
+        }
+        return parts;
+    }
+
+    // The docker-compose scenario: one UAV and the two radars.
+    Scenario BaseScenario(const CampaignConfig &cfg)
+    {
+        Scenario s;
+        s.uav.lat = 39.920;
+        s.uav.lon = 32.850;
+        s.uav.heading = 90.0;
+        s.uav.speed = 120.0;
+        s.duration_s = cfg.duration_s;
+        s.warmup_s = cfg.warmup_s;
+        s.velocity_tol_mps = cfg.velocity_tol_mps;
+
+        models::RadarConfig long_range;
+        long_range.id = "TPS-77-LONG-RANGE";
+        long_range.lat = 39.750;
+        long_range.lon = 32.700;
+        long_range.range_sigma = 50.0;
+        long_range.bearing_sigma = 1.5;
+        long_range.dynamic_rcs = true;
+        long_range.sensitivity = 1e-20;
+        long_range.carrier_freq_hz = 1.3e9;
+
+        models::RadarConfig patriot;
+        patriot.id = "AN-MPQ-53-PATRIOT";
+        patriot.lat = 39.940;
+        patriot.lon = 32.855;
+        patriot.range_sigma = 5.0;
+        patriot.bearing_sigma = 0.1;
+        patriot.dynamic_rcs = true;
+        patriot.sensitivity = 1e-15;
+        patriot.carrier_freq_hz = 5.5e9;
+
+        s.radars = {long_range, patriot};
+        return s;
+    }
+
+    bool Apply(Scenario &s, const std::string &key, const std::string &value)
+    {
+        try
+        {
+            if (key == "rcs")
+            {
+                if (value != "on" && value != "off")
+                    return false;
+                for (auto &r : s.radars)
+                    r.dynamic_rcs = value == "on";
+            }
+            else if (key == "rain")
+                for (auto &r : s.radars)
+                    r.rain_rate_mmh = std::stod(value);
+            else if (key == "freq")
+                for (auto &r : s.radars)
+                    r.carrier_freq_hz = std::stod(value) * 1e9;
+            else if (key == "range_sigma")
+                for (auto &r : s.radars)
+                    r.range_sigma = std::stod(value);
+            else if (key == "bearing_sigma")
+                for (auto &r : s.radars)
+                    r.bearing_sigma = std::stod(value);
+            else if (key == "doppler")
+                for (auto &r : s.radars)
+                    r.doppler_sigma_hz = std::stod(value);
+            else if (key == "look_ms")
+            {
+                if (std::stoul(value) < 100)
+                    return false;
+                s.look_period_ms = std::stoul(value);
+            }
+            else if (key == "uav_lat")
+                s.uav.lat = std::stod(value);
+            else if (key == "uav_lon")
+                s.uav.lon = std::stod(value);
+            else if (key == "heading")
+                s.uav.heading = std::stod(value);
+            else
+                return false;
+        }
+        catch (...)
+        {
+            return false;
+        }
+        s.label += (s.label.empty() ? "" : " ") + key + "=" + value;
+        return true;
+    }
+
+    // Cartesian product of the sweeps over the base scenario.
+    bool BuildScenarios(const CampaignConfig &cfg, std::vector<Scenario> &out)
+    {
+        out = {BaseScenario(cfg)};
+        for (const auto &sweep : cfg.sweeps)
+        {
+            std::vector<Scenario> next;
+            for (const Scenario &s : out)
+            {
+                for (const std::string &v : sweep.second)
+                {
+                    Scenario c = s;
+                    if (!Apply(c, sweep.first, v))
+                    {
+                        std::cerr << "[CAMPAIGN] Bad sweep value " << sweep.first << "=" << v << std::endl;
+                        return false;
+                    }
+                    next.push_back(std::move(c));
+                }
+            }
+            out.swap(next);
+        }
+        if (out.size() == 1 && out[0].label.empty())
+            out[0].label = "baseline";
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    CampaignConfig cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], v;
+        if (ParseArg(arg, "trials", v)) cfg.trials = std::stoul(v);
+        else if (ParseArg(arg, "duration", v)) cfg.duration_s = std::stod(v);
+        else if (ParseArg(arg, "warmup", v)) cfg.warmup_s = std::stod(v);
+        else if (ParseArg(arg, "vel-tol", v)) cfg.velocity_tol_mps = std::stod(v);
+        else if (ParseArg(arg, "seed", v)) cfg.seed = std::stoull(v);
+        else if (ParseArg(arg, "threads", v)) cfg.threads = (unsigned)std::stoul(v);
+        else if (ParseArg(arg, "out", v)) cfg.out_path = v;
+        else if (ParseArg(arg, "sweep", v) && v.find('=') != std::string::npos)
+            cfg.sweeps.emplace_back(v.substr(0, v.find('=')), Split(v.substr(v.find('=') + 1), ','));
+        else
+        {
+            PrintUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    std::vector<Scenario> scenarios;
+    if (cfg.trials == 0 || !BuildScenarios(cfg, scenarios))
+    {
+        PrintUsage();
+        return 1;
+    }
+    unsigned threads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t jobs = scenarios.size() * cfg.trials;
+    std::cout << "[CAMPAIGN] " << scenarios.size() << " scenarios x " << cfg.trials << " trials x "
+              << cfg.duration_s << " s on " << threads << " threads" << std::endl;
+
+    // Each job writes its own slot, so the summary does not depend on scheduling.
+    std::vector<TrialResult> results(jobs);
+    std::atomic<size_t> next{0};
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&]
+                          {
+                              size_t job;
+                              while ((job = next.fetch_add(1)) < jobs)
+                              {
+                                  size_t scenario = job / cfg.trials, trial = job % cfg.trials;
+                                  results[job] = RunTrial(scenarios[scenario], TrialSeed(cfg.seed, trial));
+                              }
+                          });
+    }
+    for (auto &t : pool)
+        t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::ofstream csv;
+    if (!cfg.out_path.empty())
+    {
+        csv.open(cfg.out_path, std::ios::trunc);
+        csv << "scenario,trials,rmse_m,rmse_ci95,rmse_p50,rmse_p95,mean_error_m,max_error_m,"
+               "detection_rate,detection_ci95,gated_per_trial,velocity_converged_fraction,"
+               "velocity_converged_updates_p50,velocity_converged_updates_p95,velocity_converged_s_p50,"
+               "final_velocity_error_m_s\n";
+    }
+
+    std::cout << std::left << std::setw(40) << "scenario" << std::right
+              << std::setw(18) << "rmse m (95% CI)" << std::setw(10) << "p95 m"
+              << std::setw(10) << "max m" << std::setw(18) << "Pd (95% CI)"
+              << std::setw(14) << "v conv upd" << std::setw(12) << "v conv s" << std::setw(12) << "v err m/s"
+              << std::endl;
+    for (size_t s = 0; s < scenarios.size(); ++s)
+    {
+        std::vector<double> rmse, mean_err, max_err, pd, gated, conv_updates, conv_s, v_err;
+        for (size_t t = 0; t < cfg.trials; ++t)
+        {
+            const TrialResult &r = results[s * cfg.trials + t];
+            if (r.updates == 0)
+                continue; // Never detected after warmup: counted in Pd only
+            rmse.push_back(r.rmse_m);
+            mean_err.push_back(r.mean_error_m);
+            max_err.push_back(r.max_error_m);
+            gated.push_back(r.gated);
+        }
+        for (size_t t = 0; t < cfg.trials; ++t)
+        {
+            const TrialResult &r = results[s * cfg.trials + t];
+            pd.push_back(r.detection_rate);
+            v_err.push_back(r.final_velocity_error_m_s);
+            if (r.velocity_converged_updates >= 0)
+            {
+                conv_updates.push_back(r.velocity_converged_updates);
+                conv_s.push_back(r.velocity_converged_s);
+            }
+        }
+        double converged = (double)conv_updates.size() / cfg.trials;
+        double conv_updates_p50 = Percentile(conv_updates, 0.50), conv_s_p50 = Percentile(conv_s, 0.50);
+
+        Estimate e_rmse = MeanCi(rmse), e_pd = MeanCi(pd);
+        double p50 = Percentile(rmse, 0.50), p95 = Percentile(rmse, 0.95);
+        double max_mean = MeanCi(max_err).mean;
+
+        std::ostringstream rmse_col, pd_col;
+        rmse_col << std::fixed << std::setprecision(1) << e_rmse.mean << " +/- " << e_rmse.ci95;
+        pd_col << std::fixed << std::setprecision(3) << e_pd.mean << " +/- " << e_pd.ci95;
+        std::cout << std::left << std::setw(40) << scenarios[s].label << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(18) << rmse_col.str() << std::setw(10) << p95
+                  << std::setw(10) << max_mean << std::setw(18) << pd_col.str()
+                  << std::setw(14) << std::setprecision(0) << conv_updates_p50
+                  << std::setw(12) << std::setprecision(1) << conv_s_p50
+                  << std::setw(12) << std::setprecision(2) << MeanCi(v_err).mean << std::endl;
+
+        if (csv.is_open())
+        {
+            csv << "\"" << scenarios[s].label << "\"," << rmse.size() << "," << std::setprecision(3)
+                << e_rmse.mean << "," << e_rmse.ci95 << "," << p50 << "," << p95 << ","
+                << MeanCi(mean_err).mean << "," << max_mean << "," << std::setprecision(4) << e_pd.mean << ","
+                << e_pd.ci95 << "," << std::setprecision(2) << MeanCi(gated).mean << "," << converged << ","
+                << conv_updates_p50 << "," << Percentile(conv_updates, 0.95) << "," << conv_s_p50 << ","
+                << std::setprecision(3) << MeanCi(v_err).mean << "\n";
+        }
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << "[CAMPAIGN] " << jobs << " trials in " << std::setprecision(3) << elapsed << " s ("
+              << (size_t)(jobs / std::max(elapsed, 1e-9)) << " trials/s)" << std::endl;
+    if (csv.is_open())
+        std::cout << "[CAMPAIGN] Summary written to " << cfg.out_path << std::endl;
+    return 0;
+}
@@ -27,4 +27,17 @@ double BearingDegrees(double lat1, double lon1, double lat2, double lon2)
     return (bearing < 0) ? bearing + 360.0 : bearing;
 }
 
+void DestinationPoint(double lat, double lon, double range_m, double bearing_deg,
+                      double &out_lat, double &out_lon)
+{
+    double ad = range_m / EARTH_RADIUS;
+    double brng = bearing_deg * M_PI / 180.0;
+    double phi1 = lat * M_PI / 180.0;
+    double lam1 = lon * M_PI / 180.0;
+    double phi2 = asin(sin(phi1) * cos(ad) + cos(phi1) * sin(ad) * cos(brng));
+    double lam2 = lam1 + atan2(sin(brng) * sin(ad) * cos(phi1), cos(ad) - sin(phi1) * sin(phi2));
+    out_lat = phi2 * 180.0 / M_PI;
+    out_lon = lam2 * 180.0 / M_PI;
+}
+
 } // namespace geo_utils
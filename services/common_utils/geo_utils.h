@@ -8,4 +8,8 @@ double BearingDegrees(double lat1, double lon1, double lat2, double lon2);
 // Calculate haversine distance between two points in meters
 double CalculateHaversine(double lat1, double lon1, double lat2, double lon2);
 
+// Point at `range_m` along the great circle leaving (lat, lon) on `bearing_deg`
+void DestinationPoint(double lat, double lon, double range_m, double bearing_deg,
+                      double &out_lat, double &out_lon);
+
 } // namespace geo_utils
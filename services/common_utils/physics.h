@@ -2,7 +2,8 @@
 
 namespace physics {
 
-// Calculate Dynamic RCS based on aspect angle (heading difference)
+// Calculate Dynamic RCS based on aspect angle (heading difference),
+// looked up in the RCS table (physics_tables.h) at zero elevation
 // uav_lat/lon: UAV position
 // uav_heading: UAV heading in degrees (0-360)
 // radar_lat/lon: Radar position
@@ -23,7 +24,8 @@ double CalculateSignalStrength(double rcs, double range);
 double CalculateDopplerShift(double range_rate, double carrier_freq_hz);
 
 // Calculate rain attenuation loss
-// frequency_ghz: Radar frequency in GHz (3=S-band, 10=X-band)
+// frequency_ghz: Radar frequency in GHz (3=S-band, 10=X-band); selects the
+//                ITU-R P.838 coefficients from the rain table
 // range_km: Distance to target in km
 // rain_rate_mmh: Rainfall rate in mm/hour (0=no rain, 10=heavy)
 // Returns: Two-way attenuation in dB (positive = loss)
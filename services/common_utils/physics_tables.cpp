@@ -0,0 +1,324 @@
+#include "physics_tables.h"
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace physics {
+
+namespace
+{
+    // ITU-R P.838-3, Table 5 (k_H, alpha_H)
+    struct RainCoefficient
+    {
+        double frequency_ghz;
+        double k;
+        double alpha;
+    };
+
+    constexpr RainCoefficient P838_HORIZONTAL[] = {
+        {1.0, 0.0000259, 0.9691},  {2.0, 0.0000847, 1.0664},  {3.0, 0.0001390, 1.2322},
+        {4.0, 0.0001071, 1.6009},  {5.0, 0.0002162, 1.6969},  {6.0, 0.0007056, 1.5900},
+        {7.0, 0.001915, 1.4810},   {8.0, 0.004115, 1.3905},   {9.0, 0.007535, 1.3155},
+        {10.0, 0.01217, 1.2571},   {12.0, 0.02386, 1.1825},   {15.0, 0.04481, 1.1233},
+        {20.0, 0.09164, 1.0568},   {25.0, 0.1571, 0.9991},    {30.0, 0.2403, 0.9485},
+        {35.0, 0.3374, 0.9047},    {40.0, 0.4431, 0.8673},    {50.0, 0.6600, 0.8084},
+        {60.0, 0.8606, 0.7656},    {80.0, 1.1704, 0.7115},    {100.0, 1.3671, 0.6815},
+    };
+
+    // Non-empty, non-comment CSV rows, split on commas.
+    bool ReadCsv(const std::string& path, std::vector<std::vector<std::string>>& rows, std::string& error)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::vector<std::string> cells;
+            std::stringstream ss(line);
+            std::string cell;
+            while (std::getline(ss, cell, ','))
+                cells.push_back(cell);
+            rows.push_back(std::move(cells));
+        }
+        return true;
+    }
+
+    bool ParseNumber(const std::string& s, double& out)
+    {
+        try
+        {
+            size_t used = 0;
+            out = std::stod(s, &used);
+            return used > 0;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    // Checks that `axis` is increasing with a constant step and returns 1/step.
+    bool UniformAxis(const std::vector<double>& axis, double& inv_step)
+    {
+        if (axis.size() < 2)
+            return false;
+        double step = (axis.back() - axis.front()) / (axis.size() - 1);
+        if (step <= 0.0)
+            return false;
+        for (size_t i = 1; i < axis.size(); ++i)
+        {
+            if (std::abs(axis[i] - axis[i - 1] - step) > 1e-6 * step)
+                return false;
+        }
+        inv_step = 1.0 / step;
+        return true;
+    }
+
+    PhysicsTables LoadTables()
+    {
+        PhysicsTables t;
+        std::string error;
+
+        std::string rcs_path = utils::GetEnvString("RCS_TABLE_FILE", "");
+        if (!rcs_path.empty())
+        {
+            if (t.rcs.LoadCsv(rcs_path, error))
+                std::cout << "[PHYSICS] RCS table " << rcs_path << " (" << t.rcs.aspect_bins() << " aspect x "
+                          << t.rcs.elevation_bins() << " elevation bins)" << std::endl;
+            else
+                std::cerr << "[PHYSICS] " << error << ", using the built-in RCS model" << std::endl;
+        }
+
+        std::string rain_path = utils::GetEnvString("RAIN_COEFF_FILE", "");
+        if (!rain_path.empty())
+        {
+            if (t.rain.LoadCsv(rain_path, error))
+                std::cout << "[PHYSICS] Rain coefficients " << rain_path << std::endl;
+            else
+                std::cerr << "[PHYSICS] " << error << ", using ITU-R P.838-3 coefficients" << std::endl;
+        }
+        return t;
+    }
+}
+
+// ==================== RcsTable ====================
+
+RcsTable::RcsTable()
+{
+    // Small UAV: frontal 0.1 m^2, side 2.0 m^2, 1 degree aspect bins.
+    aspect0_ = 0.0;
+    aspect_inv_step_ = 1.0;
+    aspect_n_ = 181;
+    elevation0_ = -90.0;
+    elevation_inv_step_ = 1.0 / 180.0;
+    elevation_n_ = 2;
+    rcs_.resize(aspect_n_ * elevation_n_);
+    for (size_t a = 0; a < aspect_n_; ++a)
+    {
+        double alpha = a * M_PI / 180.0;
+        double rcs = 0.1 * std::cos(alpha) * std::cos(alpha) + 2.0 * std::sin(alpha) * std::sin(alpha);
+        rcs_[a] = rcs_[aspect_n_ + a] = rcs;
+    }
+}
+
+bool RcsTable::LoadCsv(const std::string& path, std::string& error)
+{
+    std::vector<std::vector<std::string>> rows;
+    if (!ReadCsv(path, rows, error))
+        return false;
+    if (rows.size() < 3 || rows[0].size() < 3)
+    {
+        error = path + ": need at least 2 aspect columns and 2 elevation rows";
+        return false;
+    }
+
+    std::vector<double> aspects, elevations, values;
+    for (size_t c = 1; c < rows[0].size(); ++c)
+    {
+        double v;
+        if (!ParseNumber(rows[0][c], v))
+        {
+            error = path + ": bad aspect '" + rows[0][c] + "'";
+            return false;
+        }
+        aspects.push_back(v);
+    }
+    for (size_t r = 1; r < rows.size(); ++r)
+    {
+        double v;
+        if (rows[r].size() != rows[0].size() || !ParseNumber(rows[r][0], v))
+        {
+            error = path + ": row " + std::to_string(r + 1) + " does not match the header";
+            return false;
+        }
+        elevations.push_back(v);
+        for (size_t c = 1; c < rows[r].size(); ++c)
+        {
+            if (!ParseNumber(rows[r][c], v) || v < 0.0)
+            {
+                error = path + ": bad RCS '" + rows[r][c] + "' in row " + std::to_string(r + 1);
+                return false;
+            }
+            values.push_back(v);
+        }
+    }
+
+    double aspect_inv, elevation_inv;
+    if (!UniformAxis(aspects, aspect_inv) || !UniformAxis(elevations, elevation_inv))
+    {
+        error = path + ": aspect and elevation must increase in uniform steps";
+        return false;
+    }
+
+    aspect0_ = aspects.front();
+    aspect_inv_step_ = aspect_inv;
+    aspect_n_ = aspects.size();
+    elevation0_ = elevations.front();
+    elevation_inv_step_ = elevation_inv;
+    elevation_n_ = elevations.size();
+    rcs_.swap(values);
+    return true;
+}
+
+double RcsTable::Lookup(double aspect_deg, double elevation_deg) const
+{
+    double out;
+    LookupBatch(&aspect_deg, &elevation_deg, 1, &out);
+    return out;
+}
+
+void RcsTable::LookupBatch(const double* aspect_deg, const double* elevation_deg, size_t n, double* out) const
+{
+    // Inputs outside the grid clamp to its edge.
+    const double a_max = static_cast<double>(aspect_n_ - 1);
+    const double e_max = static_cast<double>(elevation_n_ - 1);
+    const double* table = rcs_.data();
+    const size_t stride = aspect_n_;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        double fa = std::min(std::max((aspect_deg[i] - aspect0_) * aspect_inv_step_, 0.0), a_max);
+        double fe = std::min(std::max((elevation_deg[i] - elevation0_) * elevation_inv_step_, 0.0), e_max);
+        size_t ia = std::min(static_cast<size_t>(fa), aspect_n_ - 2);
+        size_t ie = std::min(static_cast<size_t>(fe), elevation_n_ - 2);
+        double ta = fa - ia;
+        double te = fe - ie;
+
+        const double* row = table + ie * stride + ia;
+        double lower = row[0] + (row[1] - row[0]) * ta;
+        double upper = row[stride] + (row[stride + 1] - row[stride]) * ta;
+        out[i] = lower + (upper - lower) * te;
+    }
+}
+
+double RcsTable::max_rcs() const
+{
+    return rcs_.empty() ? 0.0 : *std::max_element(rcs_.begin(), rcs_.end());
+}
+
+// ==================== RainTable ====================
+
+RainTable::RainTable()
+{
+    for (const RainCoefficient& c : P838_HORIZONTAL)
+    {
+        log_freq_.push_back(std::log10(c.frequency_ghz));
+        log_k_.push_back(std::log10(c.k));
+        alpha_.push_back(c.alpha);
+    }
+}
+
+bool RainTable::LoadCsv(const std::string& path, std::string& error)
+{
+    std::vector<std::vector<std::string>> rows;
+    if (!ReadCsv(path, rows, error))
+        return false;
+
+    std::vector<double> log_freq, log_k, alpha;
+    for (size_t r = 0; r < rows.size(); ++r)
+    {
+        double f, k, a;
+        if (rows[r].size() != 3 || !ParseNumber(rows[r][0], f) || !ParseNumber(rows[r][1], k) ||
+            !ParseNumber(rows[r][2], a))
+        {
+            if (r == 0)
+                continue; // Header
+            error = path + ": row " + std::to_string(r + 1) + " is not frequency_ghz,k,alpha";
+            return false;
+        }
+        if (f <= 0.0 || k <= 0.0 || (!log_freq.empty() && std::log10(f) <= log_freq.back()))
+        {
+            error = path + ": frequencies must be positive and increasing, k positive";
+            return false;
+        }
+        log_freq.push_back(std::log10(f));
+        log_k.push_back(std::log10(k));
+        alpha.push_back(a);
+    }
+    if (log_freq.empty())
+    {
+        error = path + ": no coefficients";
+        return false;
+    }
+
+    log_freq_.swap(log_freq);
+    log_k_.swap(log_k);
+    alpha_.swap(alpha);
+    return true;
+}
+
+void RainTable::Coefficients(double frequency_ghz, double& k, double& alpha) const
+{
+    // Clamped to the table's frequency range.
+    double lf = std::log10(std::max(frequency_ghz, 1e-3));
+    size_t hi = std::upper_bound(log_freq_.begin(), log_freq_.end(), lf) - log_freq_.begin();
+    if (hi == 0 || hi == log_freq_.size())
+    {
+        size_t i = hi == 0 ? 0 : log_freq_.size() - 1;
+        k = std::pow(10.0, log_k_[i]);
+        alpha = alpha_[i];
+        return;
+    }
+    size_t lo = hi - 1;
+    double t = (lf - log_freq_[lo]) / (log_freq_[hi] - log_freq_[lo]);
+    k = std::pow(10.0, log_k_[lo] + (log_k_[hi] - log_k_[lo]) * t);
+    alpha = alpha_[lo] + (alpha_[hi] - alpha_[lo]) * t;
+}
+
+double RainTable::SpecificAttenuation(double frequency_ghz, double rain_rate_mmh) const
+{
+    if (rain_rate_mmh <= 0.0)
+        return 0.0;
+    double k, alpha;
+    Coefficients(frequency_ghz, k, alpha);
+    return k * std::pow(rain_rate_mmh, alpha);
+}
+
+// ==================== Tables ====================
+
+const PhysicsTables& Tables()
+{
+    static const PhysicsTables tables = LoadTables();
+    return tables;
+}
+
+double AspectAngle(double heading_deg, double bearing_from_radar_deg)
+{
+    // The radar sits at bearing_from_radar + 180 as seen from the target.
+    double a = std::fmod(std::abs(heading_deg - bearing_from_radar_deg - 180.0), 360.0);
+    return a > 180.0 ? 360.0 - a : a;
+}
+
+} // namespace physics
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Table-driven target and propagation models.
+//
+// Tables are loaded once per process and evaluated with bilinear / log-log
+// interpolation, so a radar look costs a few loads and multiplies instead of
+// trigonometry and pow() per call. The batch entry points take structure-of-
+// arrays input so a loop over many targets stays in cache.
+namespace physics {
+
+// RCS (m^2) over a uniform grid of aspect x elevation.
+//
+// Aspect is the angle between the target's nose and the line of sight to
+// the radar (0 = nose-on, 180 = tail-on; the table covers 0..180 and is
+// mirrored). Elevation is the radar's look angle up to the target.
+class RcsTable
+{
+public:
+    // Built-in small-UAV table: the frontal/side cos^2 blend, no elevation term.
+    RcsTable();
+
+    // CSV grid: first row "elevation\aspect,a0,a1,...", then one row per
+    // elevation "e,rcs,rcs,...". Both axes must be uniformly spaced.
+    bool LoadCsv(const std::string& path, std::string& error);
+
+    double Lookup(double aspect_deg, double elevation_deg) const;
+
+    // out[i] = Lookup(aspect_deg[i], elevation_deg[i]) for i < n
+    void LookupBatch(const double* aspect_deg, const double* elevation_deg, size_t n, double* out) const;
+
+    double max_rcs() const;
+
+    size_t aspect_bins() const { return aspect_n_; }
+    size_t elevation_bins() const { return elevation_n_; }
+
+private:
+    double aspect0_ = 0.0, aspect_inv_step_ = 1.0;
+    double elevation0_ = 0.0, elevation_inv_step_ = 1.0;
+    size_t aspect_n_ = 0, elevation_n_ = 0;
+    std::vector<double> rcs_;   // Row-major [elevation][aspect]
+};
+
+// ITU-R P.838-3 specific attenuation coefficients: gamma = k * R^alpha (dB/km).
+// log10(k) and alpha are interpolated linearly in log10(frequency).
+class RainTable
+{
+public:
+    // Built-in P.838-3 horizontal-polarisation coefficients, 1-100 GHz.
+    RainTable();
+
+    // CSV rows "frequency_ghz,k,alpha" in increasing frequency.
+    bool LoadCsv(const std::string& path, std::string& error);
+
+    void Coefficients(double frequency_ghz, double& k, double& alpha) const;
+
+    // One-way specific attenuation (dB/km) at a rain rate.
+    double SpecificAttenuation(double frequency_ghz, double rain_rate_mmh) const;
+
+private:
+    std::vector<double> log_freq_;
+    std::vector<double> log_k_;
+    std::vector<double> alpha_;
+};
+
+struct PhysicsTables
+{
+    RcsTable rcs;
+    RainTable rain;
+};
+
+// Process-wide tables, loaded on first use from RCS_TABLE_FILE and
+// RAIN_COEFF_FILE when set, otherwise the built-ins.
+const PhysicsTables& Tables();
+
+// Aspect angle (0..180) of a target flying `heading_deg`, seen from a radar
+// whose bearing to it is `bearing_from_radar_deg`.
+double AspectAngle(double heading_deg, double bearing_from_radar_deg);
+
+} // namespace physics
@@ -0,0 +1,136 @@
+#include "sensor_models.h"
+#include "config.h"
+#include "geo_utils.h"
+#include "physics.h"
+#include "physics_tables.h"
+#include "terrain.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace models {
+
+namespace
+{
+    constexpr double SPEED_OF_LIGHT = 299792458.0;  // m/s
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+}
+
+void StepUav(UavState& s)
+{
+    // Position changes follow simple functions of time.
+    double dlat = 0.0005;
+    double dlon = std::sin(s.time_s / 50.0) * 0.0002;
+    s.lat += dlat;
+    s.lon += dlon;
+    s.alt += std::cos(s.time_s / 10.0) * 5.0;
+    s.heading += std::sin(s.time_s / 10.0) * 2.0;
+    s.time_s += 1.0;
+    s.v_north = dlat * METERS_PER_DEG_LAT;
+    s.v_east = dlon * METERS_PER_DEG_LAT * std::cos(s.lat * M_PI / 180.0);
+}
+
+RadarModel::RadarModel(const RadarConfig& config)
+    : config_(config), range_noise_(0.0, config.range_sigma), bearing_noise_(0.0, config.bearing_sigma),
+      doppler_noise_(0.0, std::max(config.doppler_sigma_hz, 1e-9))
+{
+    // f_d = 2 v f_c / c, so the Hz noise maps to velocity through c / (2 f_c).
+    range_rate_sigma_ = config.doppler_sigma_hz > 0.0
+        ? config.doppler_sigma_hz * SPEED_OF_LIGHT / (2.0 * config.carrier_freq_hz) : 0.0;
+
+    // Two-way loss of 2*gamma dB/km as a power factor exp(-c * range_m)
+    double gamma_db_per_km = config.rain_rate_mmh < 0.1 ? 0.0
+        : physics::Tables().rain.SpecificAttenuation(config.carrier_freq_hz / 1e9, config.rain_rate_mmh);
+    rain_neper_per_m_ = 2.0 * gamma_db_per_km / 1000.0 * std::log(10.0) / 10.0;
+
+    // Terrain only matters out to where the largest RCS is still detectable.
+    double max_rcs = config.dynamic_rcs ? physics::Tables().rcs.max_rcs() : 2.0;
+    max_range_ = std::pow(max_rcs / std::max(config.sensitivity, 1e-30), 0.25);
+    max_range_ = std::min(max_range_, utils::GetEnvDouble("TERRAIN_MAX_RANGE_KM", 150.0) * 1000.0);
+    terrain_ = terrain::ProfileFor(config.lat, config.lon, config.alt, max_range_);
+    antenna_alt_ = terrain_ ? terrain_->antenna_alt() : config.alt;
+}
+
+void RadarModel::Detect(const TargetState* targets, size_t n, std::mt19937& gen, std::vector<RadarDetection>& out)
+{
+    range_.resize(n);
+    bearing_.resize(n);
+    aspect_.resize(n);
+    elevation_.resize(n);
+    rcs_.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const TargetState& t = targets[i];
+        range_[i] = geo_utils::CalculateHaversine(config_.lat, config_.lon, t.lat, t.lon);
+        bearing_[i] = geo_utils::BearingDegrees(config_.lat, config_.lon, t.lat, t.lon);
+        aspect_[i] = physics::AspectAngle(t.heading, bearing_[i]);
+        elevation_[i] = std::atan2(t.alt - antenna_alt_, range_[i]) * 180.0 / M_PI;
+    }
+
+    if (config_.dynamic_rcs)
+        physics::Tables().rcs.LookupBatch(aspect_.data(), elevation_.data(), n, rcs_.data());
+    else
+        std::fill(rcs_.begin(), rcs_.end(), 2.0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        // Signal = RCS / range^4 * weather attenuation
+        double weather_factor = rain_neper_per_m_ > 0.0 ? std::exp(-rain_neper_per_m_ * range_[i]) : 1.0;
+        double signal_strength = physics::CalculateSignalStrength(rcs_[i], range_[i]) * weather_factor;
+        if (signal_strength <= config_.sensitivity)
+            continue;
+        if (terrain_ && !terrain_->Visible(bearing_[i], range_[i], targets[i].alt))
+            continue;
+
+        RadarDetection det;
+        det.target = i;
+        det.range = range_[i] + range_noise_(gen);
+        det.bearing = bearing_[i] + bearing_noise_(gen);
+        det.rcs = rcs_[i];
+        det.range_rate = 0.0;
+        if (range_rate_sigma_ > 0.0)
+        {
+            // Radial velocity (positive opening) -> closing Doppler shift + noise -> back to m/s
+            double b = bearing_[i] * M_PI / 180.0;
+            double range_rate = targets[i].v_north * std::cos(b) + targets[i].v_east * std::sin(b);
+            double doppler_hz = physics::CalculateDopplerShift(-range_rate, config_.carrier_freq_hz) + doppler_noise_(gen);
+            det.range_rate = -doppler_hz * SPEED_OF_LIGHT / (2.0 * config_.carrier_freq_hz);
+        }
+        geo_utils::DestinationPoint(config_.lat, config_.lon, det.range, det.bearing, det.lat, det.lon);
+        out.push_back(det);
+    }
+}
+
+void RadarModel::Clutter(std::mt19937& gen, std::vector<RadarDetection>& out)
+{
+    if (config_.clutter_rate <= 0.0)
+        return;
+    const double reach = config_.clutter_range_m > 0.0 ? config_.clutter_range_m : max_range_;
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    std::normal_distribution<> range_rate_noise(0.0, std::max(range_rate_sigma_, 1e-9));
+    int n = std::poisson_distribution<int>(config_.clutter_rate)(gen);
+    for (int i = 0; i < n; ++i)
+    {
+        RadarDetection det;
+        det.target = RadarDetection::CLUTTER;
+        det.range = reach * std::sqrt(unit(gen)); // Uniform over the disc's area
+        det.bearing = 360.0 * unit(gen);
+        det.rcs = config_.sensitivity * std::pow(det.range, 4); // Just over the threshold
+        det.range_rate = range_rate_sigma_ > 0.0 ? range_rate_noise(gen) : 0.0;
+        geo_utils::DestinationPoint(config_.lat, config_.lon, det.range, det.bearing, det.lat, det.lon);
+        out.push_back(det);
+    }
+}
+
+bool RadarModel::Detect(const TargetState& target, std::mt19937& gen, RadarDetection& out)
+{
+    found_.clear();
+    Detect(&target, 1, gen, found_);
+    if (found_.empty())
+        return false;
+    out = found_.front();
+    return true;
+}
+
+} // namespace models
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace terrain {
+class HorizonProfile;
+}
+
+// Sensor models shared by the sensor services and the campaign runner.
+namespace models {
+
+// ==================== UAV ====================
+
+struct UavState
+{
+    double lat = 39.920;
+    double lon = 32.850;
+    double alt = 1200.0;
+    double heading = 45.0;  // degrees
+    double speed = 80.0;    // m/s, reported only
+    double time_s = 0.0;
+    double v_north = 0.0;   // m/s over the last step
+    double v_east = 0.0;
+};
+
+// Advances the UAV by one 1 Hz telemetry step.
+void StepUav(UavState& s);
+
+// ==================== Radar ====================
+
+struct RadarConfig
+{
+    std::string id = "RADAR-X";
+    double lat = 39.9;
+    double lon = 32.8;
+    double alt = 0.0;               // m, for the look elevation
+    double sensitivity = 1e-12;     // Minimum detectable signal
+    double range_sigma = 30.0;      // m
+    double bearing_sigma = 1.0;     // degrees
+    double carrier_freq_hz = 3e9;
+    double doppler_sigma_hz = 20.0; // Doppler frequency noise; 0 = no range rate
+    double rain_rate_mmh = 0.0;
+    bool dynamic_rcs = false;       // RCS table lookup instead of a fixed 2 m^2
+    double clutter_rate = 0.0;      // Mean false alarms per scan (Poisson); 0 = none
+    double clutter_range_m = 0.0;   // False alarms fall within this range; 0 = detection range
+};
+
+struct TargetState
+{
+    double lat;
+    double lon;
+    double alt;         // m
+    double heading;     // degrees
+    double v_north = 0.0;   // m/s
+    double v_east = 0.0;
+};
+
+struct RadarDetection
+{
+    static constexpr size_t CLUTTER = static_cast<size_t>(-1);
+
+    size_t target;      // Index into the looked-at targets, CLUTTER for a false alarm
+    double range;       // Noisy range, m
+    double bearing;     // Noisy bearing, degrees
+    double lat;         // Target position derived from range/bearing
+    double lon;
+    double rcs;         // RCS used for the SNR check, m^2
+    double range_rate;  // Noisy Doppler range rate, m/s, positive opening
+};
+
+// A radar with its frequency- and weather-dependent terms resolved from the
+// physics tables once, so a look is table lookups and arithmetic. With
+// TERRAIN_DIR set, targets hidden by terrain are not detected either.
+class RadarModel
+{
+public:
+    explicit RadarModel(const RadarConfig& config);
+
+    // One look at each of `n` targets. Appends a detection for every target
+    // whose signal (RCS, range^4, two-way rain loss) exceeds sensitivity and
+    // which the terrain does not mask. Range rate comes from the target
+    // velocity through the Doppler shift, with the noise applied in Hz.
+    void Detect(const TargetState* targets, size_t n, std::mt19937& gen, std::vector<RadarDetection>& out);
+
+    // Single-target convenience; returns false when not detected.
+    bool Detect(const TargetState& target, std::mt19937& gen, RadarDetection& out);
+
+    // One scan's false alarms: a Poisson number (mean clutter_rate) spread
+    // uniformly over the surveillance disc, with zero-mean Doppler noise.
+    void Clutter(std::mt19937& gen, std::vector<RadarDetection>& out);
+
+    const RadarConfig& config() const { return config_; }
+
+    // 1-sigma range-rate noise (m/s) the Doppler noise maps to; 0 when the
+    // radar does not measure Doppler.
+    double range_rate_sigma() const { return range_rate_sigma_; }
+
+private:
+    RadarConfig config_;
+    double rain_neper_per_m_;   // Two-way rain loss as an exponent per metre of range
+    double antenna_alt_;        // m MSL
+    double range_rate_sigma_;
+    double max_range_;          // m, where the largest RCS is still detectable
+    std::shared_ptr<const terrain::HorizonProfile> terrain_;
+    std::normal_distribution<> range_noise_;
+    std::normal_distribution<> bearing_noise_;
+    std::normal_distribution<> doppler_noise_;
+
+    // Per-look scratch, reused across calls
+    std::vector<double> range_, bearing_, aspect_, elevation_, rcs_;
+    std::vector<RadarDetection> found_;
+};
+
+} // namespace models
@@ -0,0 +1,162 @@
+#include "sensor_transport.h"
+#include "config.h"
+
+#include <cstdio>
+
+namespace transport {
+
+TransportConfig LoadTransportConfig(const std::string& name)
+{
+    TransportConfig c;
+    c.backoff_initial_ms = static_cast<int>(utils::GetEnvDouble("SENSOR_BACKOFF_INITIAL_MS", c.backoff_initial_ms));
+    c.backoff_max_ms = static_cast<int>(utils::GetEnvDouble("SENSOR_BACKOFF_MAX_MS", c.backoff_max_ms));
+    c.spool_memory_messages = static_cast<size_t>(utils::GetEnvDouble("SENSOR_SPOOL_MESSAGES", c.spool_memory_messages));
+    c.spool_disk_max_bytes = static_cast<size_t>(utils::GetEnvDouble("SENSOR_SPOOL_DISK_MB", 64.0) * 1024 * 1024);
+    c.catchup_batch = static_cast<size_t>(utils::GetEnvDouble("SENSOR_CATCHUP_BATCH", c.catchup_batch));
+    c.max_rate_hz = utils::GetEnvDouble("SENSOR_MAX_RATE_HZ", c.max_rate_hz);
+    c.drain_timeout_ms = static_cast<int>(utils::GetEnvDouble("SENSOR_DRAIN_TIMEOUT_MS", c.drain_timeout_ms));
+    c.shared_memory = utils::GetEnvString("SENSOR_TRANSPORT", "grpc") == "shm";
+    c.shm_records = static_cast<size_t>(utils::GetEnvDouble("SENSOR_SHM_RECORDS", c.shm_records));
+
+    std::string dir = utils::GetEnvString("SENSOR_SPOOL_DIR", "");
+    if (!dir.empty())
+        c.spool_path = dir + "/" + name + ".spool";
+    return c;
+}
+
+std::shared_ptr<grpc::Channel> CreateChannel(const std::string& target, const TransportConfig& config)
+{
+    grpc::ChannelArguments args;
+    args.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, config.backoff_initial_ms);
+    args.SetInt(GRPC_ARG_MIN_RECONNECT_BACKOFF_MS, config.backoff_initial_ms);
+    args.SetInt(GRPC_ARG_MAX_RECONNECT_BACKOFF_MS, config.backoff_max_ms);
+    return grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), args);
+}
+
+// ==================== Backoff ====================
+
+Backoff::Backoff(int initial_ms, int max_ms)
+    : initial_ms_(std::max(initial_ms, 1)), max_ms_(std::max(max_ms, initial_ms)),
+      current_ms_(initial_ms_), rng_(std::random_device{}())
+{}
+
+std::chrono::milliseconds Backoff::Next()
+{
+    std::uniform_real_distribution<double> jitter(0.8, 1.2);
+    int delay = static_cast<int>(current_ms_ * jitter(rng_));
+    current_ms_ = std::min(current_ms_ * 2, max_ms_);
+    return std::chrono::milliseconds(delay);
+}
+
+// ==================== MessageSpool ====================
+
+MessageSpool::MessageSpool(size_t memory_messages, const std::string& path, size_t disk_max_bytes)
+    : memory_cap_(std::max<size_t>(memory_messages, 1)), path_(path), disk_max_bytes_(disk_max_bytes)
+{
+    if (path_.empty())
+        return;
+    // The spool only bridges outages of this process; start empty.
+    file_.open(path_, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file_.is_open())
+    {
+        std::cerr << "[TRANSPORT] Cannot open spool file " << path_ << ", using memory only" << std::endl;
+        path_.clear();
+    }
+}
+
+MessageSpool::~MessageSpool()
+{
+    if (file_.is_open())
+    {
+        file_.close();
+        std::remove(path_.c_str());
+    }
+}
+
+bool MessageSpool::Push(std::string record)
+{
+    if (disk_records_ == 0 && memory_.size() < memory_cap_)
+    {
+        memory_.push_back(std::move(record));
+        return true;
+    }
+
+    if (path_.empty())
+    {
+        memory_.pop_front();
+        memory_.push_back(std::move(record));
+        ++dropped_;
+        return false;
+    }
+
+    uint32_t len = static_cast<uint32_t>(record.size());
+    if (disk_write_ + sizeof(len) + len > disk_max_bytes_)
+    {
+        ++dropped_;
+        return false;
+    }
+    file_.seekp(static_cast<std::streamoff>(disk_write_));
+    file_.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    file_.write(record.data(), len);
+    disk_write_ += sizeof(len) + len;
+    ++disk_records_;
+    return true;
+}
+
+void MessageSpool::Refill()
+{
+    file_.flush();
+    file_.seekg(static_cast<std::streamoff>(disk_read_));
+    while (disk_records_ > 0 && memory_.size() < memory_cap_)
+    {
+        uint32_t len = 0;
+        file_.read(reinterpret_cast<char*>(&len), sizeof(len));
+        std::string record(len, '\0');
+        file_.read(&record[0], len);
+        if (!file_)
+        {
+            std::cerr << "[TRANSPORT] Spool file " << path_ << " unreadable, discarding "
+                      << disk_records_ << " messages" << std::endl;
+            dropped_ += disk_records_;
+            disk_records_ = 0;
+            break;
+        }
+        disk_read_ += sizeof(len) + len;
+        --disk_records_;
+        memory_.push_back(std::move(record));
+    }
+
+    if (disk_records_ == 0)
+    {
+        // Everything is back in memory: start the file over.
+        file_.close();
+        file_.open(path_, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        disk_read_ = disk_write_ = 0;
+    }
+}
+
+void MessageSpool::PopBatch(size_t max, std::vector<std::string>& out)
+{
+    out.clear();
+    while (out.size() < max)
+    {
+        if (memory_.empty())
+        {
+            if (disk_records_ == 0)
+                break;
+            Refill();
+            continue;
+        }
+        out.push_back(std::move(memory_.front()));
+        memory_.pop_front();
+    }
+}
+
+void MessageSpool::Requeue(std::vector<std::string>& records, size_t from)
+{
+    for (size_t i = records.size(); i > from; --i)
+        memory_.push_front(std::move(records[i - 1]));
+    records.clear();
+}
+
+} // namespace transport
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace transport {
+
+// Reconnect and spooling parameters shared by the sensor clients.
+struct TransportConfig
+{
+    int backoff_initial_ms = 200;
+    int backoff_max_ms = 10000;
+    size_t spool_memory_messages = 10000;
+    std::string spool_path;                       // Empty: memory-only spool
+    size_t spool_disk_max_bytes = 64u * 1024 * 1024;
+    size_t catchup_batch = 256;                   // Messages per write burst
+    double max_rate_hz = 2000.0;                  // Send ceiling while catching up (0 = unlimited)
+    int drain_timeout_ms = 2000;                  // How long Close() keeps flushing
+    bool shared_memory = false;                   // Prefer a shm ring when fusion reads one
+    size_t shm_records = 65536;                   // Ring capacity (rounded up to a power of two)
+};
+
+// Reads SENSOR_BACKOFF_INITIAL_MS, SENSOR_BACKOFF_MAX_MS, SENSOR_SPOOL_MESSAGES,
+// SENSOR_SPOOL_DIR (spool file <dir>/<name>.spool), SENSOR_SPOOL_DISK_MB,
+// SENSOR_CATCHUP_BATCH, SENSOR_MAX_RATE_HZ, SENSOR_DRAIN_TIMEOUT_MS,
+// SENSOR_TRANSPORT (grpc | shm) and SENSOR_SHM_RECORDS.
+TransportConfig LoadTransportConfig(const std::string& name);
+
+// Insecure channel whose reconnect backoff follows the transport config, so
+// a restarted fusion service is picked up within backoff_max_ms.
+std::shared_ptr<grpc::Channel> CreateChannel(const std::string& target, const TransportConfig& config);
+
+// Exponential backoff with +/-20% jitter.
+class Backoff
+{
+public:
+    Backoff(int initial_ms, int max_ms);
+
+    std::chrono::milliseconds Next();
+    void Reset() { current_ms_ = initial_ms_; }
+
+private:
+    int initial_ms_;
+    int max_ms_;
+    int current_ms_;
+    std::mt19937 rng_;
+};
+
+// FIFO of serialized messages: an in-memory queue that overflows into an
+// append-only file once full. New messages go to the file while it holds
+// anything, so order is preserved. When memory-only, the oldest message is
+// dropped on overflow; when the file is full, the incoming one is.
+// Not thread-safe.
+class MessageSpool
+{
+public:
+    MessageSpool(size_t memory_messages, const std::string& path, size_t disk_max_bytes);
+    ~MessageSpool();
+
+    // Returns false when a message had to be dropped.
+    bool Push(std::string record);
+
+    // Moves up to `max` of the oldest messages into `out`.
+    void PopBatch(size_t max, std::vector<std::string>& out);
+
+    // Puts unsent messages back at the head, keeping their order.
+    void Requeue(std::vector<std::string>& records, size_t from);
+
+    size_t Size() const { return memory_.size() + disk_records_; }
+    uint64_t Dropped() const { return dropped_; }
+
+private:
+    void Refill();
+
+    size_t memory_cap_;
+    std::deque<std::string> memory_;
+
+    std::string path_;
+    std::fstream file_;
+    size_t disk_max_bytes_;
+    uint64_t disk_read_ = 0;
+    uint64_t disk_write_ = 0;
+    size_t disk_records_ = 0;
+
+    uint64_t dropped_ = 0;
+};
+
+// Client stream to the fusion service that survives fusion restarts.
+//
+// Send() only spools the message; a worker thread owns the gRPC stream,
+// waits for the channel with exponential backoff when a write fails, and
+// drains the backlog in buffered bursts of `catchup_batch` limited to
+// `max_rate_hz`.
+//
+// gRPC accepting a write does not mean fusion got it: a buffered burst can
+// die with the connection. The last written burst is therefore kept until
+// the next burst has gone out on the same stream after it (its final write
+// is flushed) or Close() finishes the stream OK, and is replayed after a
+// reconnect. Delivery is at-least-once: a fusion restart can see up to one
+// burst twice, but loses none of it.
+template <typename Msg, typename Ack>
+class StreamTransport
+{
+public:
+    using Opener = std::function<std::unique_ptr<grpc::ClientWriter<Msg>>(grpc::ClientContext*, Ack*)>;
+
+    StreamTransport(std::string tag, std::shared_ptr<grpc::Channel> channel, Opener opener,
+                    const TransportConfig& config)
+        : tag_(std::move(tag)), channel_(std::move(channel)), opener_(std::move(opener)), config_(config),
+          backoff_(config.backoff_initial_ms, config.backoff_max_ms),
+          spool_(config.spool_memory_messages, config.spool_path, config.spool_disk_max_bytes)
+    {
+        worker_ = std::thread(&StreamTransport::Run, this);
+    }
+
+    ~StreamTransport() { Close(); }
+
+    // Queues a message for delivery. Returns false if the spool had to drop data.
+    bool Send(const Msg& msg)
+    {
+        std::string record;
+        msg.SerializeToString(&record);
+        bool kept;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            kept = spool_.Push(std::move(record));
+            if (!kept && spool_.Dropped() % 1000 == 1)
+                std::cerr << "[" << tag_ << "] Spool full, dropped " << spool_.Dropped() << " messages" << std::endl;
+        }
+        cv_.notify_one();
+        return kept;
+    }
+
+    // Flushes the backlog (bounded by drain_timeout_ms) and closes the stream.
+    grpc::Status Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (closed_)
+                return final_status_;
+            closed_ = true;
+            drain_deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.drain_timeout_ms);
+        }
+        cv_.notify_one();
+        if (worker_.joinable())
+            worker_.join();
+
+        if (writer_)
+        {
+            writer_->WritesDone();
+            final_status_ = writer_->Finish();
+            writer_.reset();
+        }
+        else
+        {
+            final_status_ = grpc::Status(grpc::StatusCode::UNAVAILABLE, "not connected");
+        }
+        std::lock_guard<std::mutex> lock(mtx_);
+        // A stream that finishes OK was read to the end.
+        size_t unsent = spool_.Size() + (final_status_.ok() ? 0 : unconfirmed_.size());
+        unconfirmed_.clear();
+        if (unsent > 0)
+            std::cerr << "[" << tag_ << "] Closing with " << unsent << " unsent messages" << std::endl;
+        return final_status_;
+    }
+
+    const Ack& ack() const { return ack_; }
+
+    size_t Backlog() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return spool_.Size() + unconfirmed_.size();
+    }
+
+private:
+    bool DrainExpired() const
+    {
+        return closed_ && std::chrono::steady_clock::now() >= drain_deadline_;
+    }
+
+    void Run()
+    {
+        std::vector<std::string> batch;
+        Msg msg;
+        bool was_connected = false;
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (true)
+        {
+            cv_.wait(lock, [&] { return closed_ || spool_.Size() > 0; });
+            if (spool_.Size() == 0 || DrainExpired())
+                break;
+
+            if (!writer_)
+            {
+                if (!WaitForChannel(lock))
+                    continue;
+                context_ = std::make_unique<grpc::ClientContext>();
+                writer_ = opener_(context_.get(), &ack_);
+                if (!writer_)
+                    continue;
+            }
+
+            spool_.PopBatch(config_.catchup_batch, batch);
+            size_t backlog = spool_.Size() + batch.size();
+            lock.unlock();
+
+            // Buffer all but the last message of a burst so catch-up goes
+            // out in large frames instead of one flush per detection.
+            auto started = std::chrono::steady_clock::now();
+            size_t sent = 0;
+            for (; sent < batch.size(); ++sent)
+            {
+                msg.ParseFromString(batch[sent]);
+                grpc::WriteOptions opts;
+                if (sent + 1 < batch.size())
+                    opts.set_buffer_hint();
+                if (!writer_->Write(msg, opts))
+                    break;
+            }
+
+            if (sent == batch.size() && config_.max_rate_hz > 0.0)
+            {
+                auto budget = std::chrono::duration<double>(batch.size() / config_.max_rate_hz);
+                auto elapsed = std::chrono::steady_clock::now() - started;
+                if (elapsed < budget)
+                    std::this_thread::sleep_for(budget - elapsed);
+            }
+
+            lock.lock();
+            if (sent < batch.size())
+            {
+                // Written but unconfirmed messages go back too: the last
+                // burst, then this one from its start.
+                unconfirmed_.insert(unconfirmed_.end(), std::make_move_iterator(batch.begin()),
+                                    std::make_move_iterator(batch.end()));
+                spool_.Requeue(unconfirmed_, 0);
+                batch.clear();
+                grpc::Status status = writer_->Finish();
+                writer_.reset();
+                if (was_connected)
+                    std::cerr << "[" << tag_ << "] Fusion stream lost (" << status.error_message()
+                              << "), spooling until it is back" << std::endl;
+                was_connected = false;
+                // Ready channel but the stream is refused: do not spin.
+                if (sent == 0)
+                    cv_.wait_for(lock, backoff_.Next(), [&] { return DrainExpired(); });
+                continue;
+            }
+
+            if (!was_connected)
+            {
+                std::cout << "[" << tag_ << "] Connected to fusion service"
+                          << (backlog > 1 ? ", catching up " + std::to_string(backlog) + " spooled messages" : "")
+                          << std::endl;
+                was_connected = true;
+            }
+            backoff_.Reset();
+            // The stream took this burst after the previous one was flushed,
+            // so that one is through; this one waits for the next.
+            unconfirmed_.swap(batch);
+            batch.clear();
+        }
+    }
+
+    // Waits up to one backoff step for the channel to become ready, in short
+    // slices so Close() is not held up. Returns true when it is ready.
+    bool WaitForChannel(std::unique_lock<std::mutex>& lock)
+    {
+        if (channel_->GetState(true) == GRPC_CHANNEL_READY)
+            return true;
+
+        auto until = std::chrono::steady_clock::now() + backoff_.Next();
+        lock.unlock();
+        bool ready = false;
+        while (!ready && std::chrono::steady_clock::now() < until)
+        {
+            auto slice = std::min(until, std::chrono::steady_clock::now() + std::chrono::milliseconds(250));
+            ready = channel_->WaitForConnected(std::chrono::system_clock::now() +
+                                               (slice - std::chrono::steady_clock::now()));
+            std::lock_guard<std::mutex> check(mtx_);
+            if (DrainExpired())
+                break;
+        }
+        lock.lock();
+        return ready;
+    }
+
+    std::string tag_;
+    std::shared_ptr<grpc::Channel> channel_;
+    Opener opener_;
+    TransportConfig config_;
+    Backoff backoff_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    MessageSpool spool_;
+    std::vector<std::string> unconfirmed_; // Last burst written, replayed if the stream fails
+    bool closed_ = false;
+    std::chrono::steady_clock::time_point drain_deadline_;
+
+    // Owned by the worker thread until it exits
+    std::unique_ptr<grpc::ClientContext> context_;
+    std::unique_ptr<grpc::ClientWriter<Msg>> writer_;
+    Ack ack_;
+    grpc::Status final_status_;
+    std::thread worker_;
+};
+
+} // namespace transport
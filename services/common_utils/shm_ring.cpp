@@ -0,0 +1,222 @@
+#include "shm_ring.h"
+#include "config.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+namespace shm {
+
+namespace
+{
+    constexpr char MAGIC[8] = {'B', 'F', 'S', 'R', 'I', 'N', 'G', '\0'};
+    constexpr uint32_t VERSION = 3;
+
+    size_t RecordsOffset()
+    {
+        return (sizeof(SegmentHeader) + 63) & ~size_t(63);
+    }
+}
+
+void SetId(char (&field)[32], const std::string& s)
+{
+    size_t n = std::min(s.size(), sizeof(field) - 1);
+    std::memcpy(field, s.data(), n);
+    field[n] = '\0';
+}
+
+int64_t SteadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string SegmentDir()
+{
+    return utils::GetEnvString("SHM_DIR", "/dev/shm");
+}
+
+// ==================== Producer ====================
+
+std::unique_ptr<Producer> Producer::Create(const std::string& dir, const std::string& name, size_t capacity)
+{
+    size_t cap = 1;
+    while (cap < capacity)
+        cap <<= 1;
+
+    std::unique_ptr<Producer> p(new Producer());
+    p->path_ = dir + "/bfsim." + name + ".ring";
+    p->map_bytes_ = RecordsOffset() + cap * sizeof(MeasurementRecord);
+
+    // A new inode each time, so a consumer still mapping the previous
+    // segment sees its producer gone instead of a reset ring.
+    ::unlink(p->path_.c_str());
+    int fd = ::open(p->path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd < 0)
+    {
+        std::cerr << "[SHM] Cannot create " << p->path_ << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    if (::ftruncate(fd, (off_t)p->map_bytes_) != 0)
+    {
+        std::cerr << "[SHM] Cannot size " << p->path_ << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        ::unlink(p->path_.c_str());
+        return nullptr;
+    }
+    void* map = ::mmap(nullptr, p->map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        ::unlink(p->path_.c_str());
+        return nullptr;
+    }
+
+    char* base = static_cast<char*>(map);
+    p->header_ = new (base) SegmentHeader();
+    p->records_ = reinterpret_cast<MeasurementRecord*>(base + RecordsOffset());
+    p->mask_ = cap - 1;
+    p->header_->version = VERSION;
+    p->header_->record_size = sizeof(MeasurementRecord);
+    p->header_->capacity = cap;
+    p->header_->producer_pid = (int32_t)::getpid();
+    p->header_->head.store(0, std::memory_order_relaxed);
+    p->header_->tail.store(0, std::memory_order_relaxed);
+    p->header_->producer_heartbeat_ms.store(SteadyNowMs(), std::memory_order_relaxed);
+    p->header_->consumer_heartbeat_ms.store(0, std::memory_order_relaxed);
+    // Magic last: a consumer attaching early rejects the segment and retries.
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(p->header_->magic, MAGIC, sizeof(MAGIC));
+    return p;
+}
+
+Producer::~Producer()
+{
+    if (header_)
+    {
+        ::munmap(header_, map_bytes_);
+        // The consumer drains what is left through its own mapping.
+        ::unlink(path_.c_str());
+    }
+}
+
+bool Producer::ConsumerAlive(int64_t timeout_ms) const
+{
+    int64_t beat = header_->consumer_heartbeat_ms.load(std::memory_order_relaxed);
+    return beat != 0 && SteadyNowMs() - beat <= timeout_ms;
+}
+
+MeasurementRecord* Producer::Claim()
+{
+    if (head_ - cached_tail_ > mask_)
+    {
+        cached_tail_ = header_->tail.load(std::memory_order_acquire);
+        if (head_ - cached_tail_ > mask_)
+            return nullptr;
+    }
+    return &records_[head_ & mask_];
+}
+
+void Producer::Commit()
+{
+    ++head_;
+    header_->head.store(head_, std::memory_order_release);
+    header_->producer_heartbeat_ms.store(SteadyNowMs(), std::memory_order_relaxed);
+}
+
+bool Producer::TryPush(const MeasurementRecord& record)
+{
+    MeasurementRecord* slot = Claim();
+    if (!slot)
+        return false;
+    *slot = record;
+    Commit();
+    return true;
+}
+
+// ==================== Consumer ====================
+
+std::unique_ptr<Consumer> Consumer::Attach(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || (size_t)st.st_size < RecordsOffset())
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = (size_t)st.st_size;
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return nullptr;
+
+    char* base = static_cast<char*>(map);
+    auto* header = reinterpret_cast<SegmentHeader*>(base);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t cap = header->capacity;
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->record_size != sizeof(MeasurementRecord) || cap == 0 || (cap & (cap - 1)) != 0 ||
+        RecordsOffset() + cap * sizeof(MeasurementRecord) != size)
+    {
+        ::munmap(map, size);
+        return nullptr;
+    }
+
+    std::unique_ptr<Consumer> c(new Consumer());
+    c->path_ = path;
+    c->inode_ = st.st_ino;
+    c->header_ = header;
+    c->records_ = reinterpret_cast<MeasurementRecord*>(base + RecordsOffset());
+    c->map_bytes_ = size;
+    c->mask_ = cap - 1;
+    c->tail_ = header->tail.load(std::memory_order_acquire);
+    c->Heartbeat();
+    return c;
+}
+
+Consumer::~Consumer()
+{
+    if (header_)
+    {
+        header_->consumer_heartbeat_ms.store(0, std::memory_order_relaxed);
+        ::munmap(header_, map_bytes_);
+    }
+}
+
+bool Consumer::Finished(int64_t idle_ms) const
+{
+    if (header_->head.load(std::memory_order_acquire) != tail_)
+        return false;
+    struct stat st;
+    if (::stat(path_.c_str(), &st) != 0 || st.st_ino != inode_)
+        return true;
+    return SteadyNowMs() - header_->producer_heartbeat_ms.load(std::memory_order_relaxed) > idle_ms;
+}
+
+// ==================== IdleWait ====================
+
+void IdleWait::Wait()
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (idle_since_ == 0)
+        idle_since_ = now;
+    if (now - idle_since_ < spin_us_)
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us_));
+}
+
+} // namespace shm
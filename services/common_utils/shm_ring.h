@@ -0,0 +1,169 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Shared-memory measurement rings for sensors running on the fusion host.
+//
+// Each sensor process owns one segment (<dir>/bfsim.<name>.ring, normally on
+// /dev/shm): a header followed by a power-of-two array of fixed-layout
+// records. It is a single-producer/single-consumer ring: the sensor
+// publishes `head`, fusion publishes `tail`, and records are written and
+// read in place. Fusion also stamps a heartbeat so the sensor can tell
+// whether anyone is reading and fall back to gRPC when not.
+namespace shm {
+
+enum class RecordKind : uint32_t
+{
+    RADAR = 1,
+    UAV = 2,
+    SIGINT = 3,
+};
+
+// Fixed-layout measurement. Ids longer than the fields are truncated.
+struct MeasurementRecord
+{
+    int64_t timestamp_ms;
+    int64_t timestamp_ns;            // Sensor monotonic clock, 0 = not sent
+    RecordKind kind;
+    float velocity_sigma;            // Radar Doppler noise (m/s), 0 = no Doppler
+    float range_sigma;               // Radar range noise (m), 0 = unknown
+    float bearing_sigma;             // Radar bearing noise (degrees), 0 = unknown
+    double lat, lon, alt;            // Target position (radar: computed geo position)
+    double range, bearing, elevation, rcs, velocity; // Radar polar detection
+    double speed, heading;           // UAV kinematics
+    char sensor_id[32];
+    char target_id[32];              // Radar track id / UAV id
+};
+static_assert(sizeof(MeasurementRecord) == 176, "shm record layout changed");
+
+// Copies `s` into a fixed field, NUL-terminated.
+void SetId(char (&field)[32], const std::string& s);
+inline std::string GetId(const char (&field)[32])
+{
+    size_t n = 0;
+    while (n < sizeof(field) && field[n] != '\0')
+        ++n;
+    return std::string(field, n);
+}
+
+struct SegmentHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;               // Records, power of two
+    int32_t producer_pid;
+    uint32_t reserved;
+    alignas(64) std::atomic<uint64_t> head;      // Next slot the producer writes
+    std::atomic<int64_t> producer_heartbeat_ms;  // Last commit
+    alignas(64) std::atomic<uint64_t> tail;      // Next slot the consumer reads
+    alignas(64) std::atomic<int64_t> consumer_heartbeat_ms;
+};
+
+int64_t SteadyNowMs();
+
+// Directory holding the segments: SHM_DIR, default /dev/shm.
+std::string SegmentDir();
+
+// Sensor side. Creating a segment replaces any stale one with the same name.
+class Producer
+{
+public:
+    static std::unique_ptr<Producer> Create(const std::string& dir, const std::string& name, size_t capacity);
+    ~Producer();
+
+    // True while a consumer has stamped its heartbeat within `timeout_ms`.
+    bool ConsumerAlive(int64_t timeout_ms = 1000) const;
+
+    // Returns a slot to fill, or nullptr when the ring is full. The record
+    // becomes visible to the consumer on Commit().
+    MeasurementRecord* Claim();
+    void Commit();
+
+    bool TryPush(const MeasurementRecord& record);
+
+private:
+    Producer() = default;
+
+    std::string path_;
+    SegmentHeader* header_ = nullptr;
+    MeasurementRecord* records_ = nullptr;
+    size_t map_bytes_ = 0;
+    uint64_t mask_ = 0;
+    uint64_t head_ = 0;              // Producer-local copy of header_->head
+    uint64_t cached_tail_ = 0;
+};
+
+// Fusion side.
+class Consumer
+{
+public:
+    // Maps an existing segment; nullptr if it is not a valid ring.
+    static std::unique_ptr<Consumer> Attach(const std::string& path);
+    ~Consumer();
+
+    // Calls `fn(const MeasurementRecord&)` for up to `max` pending records,
+    // in place, and releases them. Returns the number consumed.
+    template <typename Fn>
+    size_t Drain(size_t max, Fn&& fn)
+    {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        size_t n = 0;
+        while (tail_ != head && n < max)
+        {
+            fn(records_[tail_ & mask_]);
+            ++tail_;
+            ++n;
+        }
+        if (n > 0)
+            header_->tail.store(tail_, std::memory_order_release);
+        return n;
+    }
+
+    void Heartbeat() { header_->consumer_heartbeat_ms.store(SteadyNowMs(), std::memory_order_relaxed); }
+
+    // Everything has been read and the producer is gone: its segment was
+    // removed or replaced, or it has not written for `idle_ms`. (Producer
+    // pids are not comparable across containers.) An idle ring that is
+    // dropped is simply attached again when it shows up in the next scan.
+    bool Finished(int64_t idle_ms = 10000) const;
+
+    const std::string& path() const { return path_; }
+    ino_t inode() const { return inode_; }
+
+private:
+    Consumer() = default;
+
+    std::string path_;
+    ino_t inode_ = 0;
+    SegmentHeader* header_ = nullptr;
+    MeasurementRecord* records_ = nullptr;
+    size_t map_bytes_ = 0;
+    uint64_t mask_ = 0;
+    uint64_t tail_ = 0;
+};
+
+// Consumer idle strategy: keep yielding for `spin_us` after the last
+// record so a busy ring is read with microsecond latency, then sleep in
+// `sleep_us` steps so an idle one costs no CPU.
+class IdleWait
+{
+public:
+    explicit IdleWait(int64_t spin_us = 2000, int64_t sleep_us = 200) : spin_us_(spin_us), sleep_us_(sleep_us) {}
+
+    void Reset() { idle_since_ = 0; }
+    void Wait();
+
+private:
+    int64_t spin_us_;
+    int64_t sleep_us_;
+    int64_t idle_since_ = 0;
+};
+
+} // namespace shm
@@ -0,0 +1,297 @@
+#include "terrain.h"
+#include "config.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace terrain {
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+    constexpr double EARTH_RADIUS_M = 6371000.0;
+    constexpr double REFRACTION_K = 4.0 / 3.0;      // Standard-atmosphere effective earth radius
+    constexpr double MAST_HEIGHT_M = 10.0;
+    constexpr size_t AZIMUTH_RAYS = 1440;           // 0.25 degree spacing
+    constexpr int16_t VOID_POST = -32768;
+
+    // Height lost to earth curvature (with refraction) at ground distance d.
+    inline double CurvatureDrop(double d)
+    {
+        return d * d / (2.0 * REFRACTION_K * EARTH_RADIUS_M);
+    }
+
+    std::string TileName(int lat, int lon)
+    {
+        char name[32]; // Room for any int, so the name is never truncated
+        std::snprintf(name, sizeof(name), "%c%02d%c%03d.hgt", lat >= 0 ? 'N' : 'S', std::abs(lat),
+                      lon >= 0 ? 'E' : 'W', std::abs(lon));
+        return name;
+    }
+}
+
+// ==================== Tile ====================
+
+std::shared_ptr<const Tile> Tile::Map(const std::string& path, int lat, int lon)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+    size_t n = static_cast<size_t>(std::lround(std::sqrt(bytes / 2.0)));
+    if (n < 2 || n * n * 2 != bytes)
+    {
+        std::cerr << "[TERRAIN] " << path << " is not a square int16 grid, ignoring it" << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+    void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        std::cerr << "[TERRAIN] Cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<Tile> t(new Tile());
+    t->lat_ = lat;
+    t->lon_ = lon;
+    t->n_ = n;
+    t->data_ = static_cast<const uint8_t*>(p);
+    t->bytes_ = bytes;
+    return t;
+}
+
+Tile::~Tile()
+{
+    if (data_)
+        ::munmap(const_cast<uint8_t*>(data_), bytes_);
+}
+
+double Tile::Post(size_t row, size_t col) const
+{
+    // Rows run north to south, big-endian
+    const uint8_t* p = data_ + 2 * (row * n_ + col);
+    int16_t h = static_cast<int16_t>((p[0] << 8) | p[1]);
+    return h == VOID_POST ? 0.0 : static_cast<double>(h);
+}
+
+double Tile::Nearest(double lat, double lon) const
+{
+    const double last = static_cast<double>(n_ - 1);
+    double fr = std::clamp((lat_ + 1.0 - lat) * last, 0.0, last);
+    double fc = std::clamp((lon - lon_) * last, 0.0, last);
+    return Post(static_cast<size_t>(fr + 0.5), static_cast<size_t>(fc + 0.5));
+}
+
+double Tile::Bilinear(double lat, double lon) const
+{
+    const double last = static_cast<double>(n_ - 1);
+    double fr = std::clamp((lat_ + 1.0 - lat) * last, 0.0, last);
+    double fc = std::clamp((lon - lon_) * last, 0.0, last);
+    size_t r = std::min(static_cast<size_t>(fr), n_ - 2);
+    size_t c = std::min(static_cast<size_t>(fc), n_ - 2);
+    double tr = fr - r, tc = fc - c;
+    double top = Post(r, c) + (Post(r, c + 1) - Post(r, c)) * tc;
+    double bottom = Post(r + 1, c) + (Post(r + 1, c + 1) - Post(r + 1, c)) * tc;
+    return top + (bottom - top) * tr;
+}
+
+// ==================== TileCache ====================
+
+TileCache::TileCache(std::string dir, size_t max_tiles) : dir_(std::move(dir)), max_tiles_(std::max<size_t>(max_tiles, 1))
+{}
+
+std::shared_ptr<const Tile> TileCache::Get(int lat, int lon)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Key key(lat, lon);
+    auto it = tiles_.find(key);
+    if (it != tiles_.end())
+    {
+        lru_.splice(lru_.begin(), lru_, it->second.second);
+        return it->second.first;
+    }
+
+    // Missing files are cached too, so sea cells are not probed again.
+    std::shared_ptr<const Tile> tile = Tile::Map(dir_ + "/" + TileName(lat, lon), lat, lon);
+    lru_.push_front(key);
+    tiles_.emplace(key, std::make_pair(tile, lru_.begin()));
+    while (tiles_.size() > max_tiles_)
+    {
+        // Profiles holding the tile keep it mapped until they go away.
+        tiles_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    return tile;
+}
+
+double TileCache::Elevation(double lat, double lon)
+{
+    std::shared_ptr<const Tile> tile = Get(static_cast<int>(std::floor(lat)), static_cast<int>(std::floor(lon)));
+    return tile ? tile->Bilinear(lat, lon) : 0.0;
+}
+
+// ==================== HorizonProfile ====================
+
+HorizonProfile::HorizonProfile(TileCache& cache, double lat, double lon, double antenna_alt_m, double max_range_m)
+    : lat_(lat), lon_(lon), max_range_(max_range_m)
+{
+    // Pin every tile the profile can reach; looks never go back to the cache.
+    double reach_lat = max_range_m / METERS_PER_DEG_LAT;
+    double reach_lon = reach_lat / std::max(std::cos(lat * M_PI / 180.0), 0.01);
+    tile_lat0_ = static_cast<int>(std::floor(lat - reach_lat));
+    tile_lon0_ = static_cast<int>(std::floor(lon - reach_lon));
+    tile_rows_ = static_cast<int>(std::floor(lat + reach_lat)) - tile_lat0_ + 1;
+    tile_cols_ = static_cast<int>(std::floor(lon + reach_lon)) - tile_lon0_ + 1;
+    size_t posts = 1201;
+    for (int r = 0; r < tile_rows_; ++r)
+    {
+        for (int c = 0; c < tile_cols_; ++c)
+        {
+            pinned_.push_back(cache.Get(tile_lat0_ + r, tile_lon0_ + c));
+            if (pinned_.back())
+                posts = std::max(posts, pinned_.back()->size());
+        }
+    }
+    step_m_ = METERS_PER_DEG_LAT / (posts - 1);
+
+    antenna_alt_ = std::max(antenna_alt_m, Height(lat, lon) + MAST_HEIGHT_M);
+
+    // Building the profile reads every pinned post it covers, which also
+    // faults the mapped pages in before the first look.
+    horizon_slope_.assign(AZIMUTH_RAYS, -1e9f);
+    horizon_range_.assign(AZIMUTH_RAYS, 0.0f);
+    const double m_to_dlat = 1.0 / METERS_PER_DEG_LAT;
+    const double m_to_dlon = 1.0 / (METERS_PER_DEG_LAT * std::cos(lat * M_PI / 180.0));
+    for (size_t a = 0; a < AZIMUTH_RAYS; ++a)
+    {
+        double b = (360.0 * a / AZIMUTH_RAYS) * M_PI / 180.0;
+        double dlat = std::cos(b) * m_to_dlat, dlon = std::sin(b) * m_to_dlon;
+        float best = -1e9f, best_range = 0.0f;
+        for (double d = step_m_; d <= max_range_; d += step_m_)
+        {
+            double slope = (Height(lat + d * dlat, lon + d * dlon) - antenna_alt_ - CurvatureDrop(d)) / d;
+            if (slope > best)
+            {
+                best = static_cast<float>(slope);
+                best_range = static_cast<float>(d);
+            }
+        }
+        horizon_slope_[a] = best;
+        horizon_range_[a] = best_range;
+    }
+}
+
+double HorizonProfile::Height(double lat, double lon) const
+{
+    int r = static_cast<int>(std::floor(lat)) - tile_lat0_;
+    int c = static_cast<int>(std::floor(lon)) - tile_lon0_;
+    if (r < 0 || c < 0 || r >= tile_rows_ || c >= tile_cols_)
+        return 0.0;
+    const Tile* tile = pinned_[static_cast<size_t>(r * tile_cols_ + c)].get();
+    return tile ? tile->Nearest(lat, lon) : 0.0;
+}
+
+bool HorizonProfile::Visible(double bearing_deg, double range_m, double alt_m) const
+{
+    if (range_m <= step_m_)
+        return true;
+    double target_slope = (alt_m - antenna_alt_ - CurvatureDrop(range_m)) / range_m;
+
+    // The bin between the two rays around the bearing.
+    double pos = std::fmod(std::fmod(bearing_deg, 360.0) + 360.0, 360.0) / 360.0 * AZIMUTH_RAYS;
+    size_t lo = static_cast<size_t>(pos) % AZIMUTH_RAYS;
+    size_t hi = (lo + 1) % AZIMUTH_RAYS;
+    double top = std::max(horizon_slope_[lo], horizon_slope_[hi]);
+    double bottom = std::min(horizon_slope_[lo], horizon_slope_[hi]);
+    double ridge = std::max(horizon_range_[lo], horizon_range_[hi]);
+
+    if (target_slope > top)
+        return true;    // Above everything out to max range
+    if (target_slope <= bottom && range_m >= ridge)
+        return false;   // Behind and below the ridge
+    return !March(bearing_deg, range_m, target_slope);
+}
+
+bool HorizonProfile::March(double bearing_deg, double range_m, double target_slope) const
+{
+    // Samples along the ray in structure-of-arrays form: heights are
+    // gathered first, then one branch-free pass tests them all.
+    thread_local std::vector<double> dist, height;
+    size_t n = static_cast<size_t>(range_m / step_m_);
+    if (n < 2)
+        return false;
+    n -= 1; // Stop short of the target itself
+    dist.resize(n);
+    height.resize(n);
+
+    double b = bearing_deg * M_PI / 180.0;
+    double dlat = std::cos(b) / METERS_PER_DEG_LAT;
+    double dlon = std::sin(b) / (METERS_PER_DEG_LAT * std::cos(lat_ * M_PI / 180.0));
+    for (size_t i = 0; i < n; ++i)
+    {
+        double d = step_m_ * (i + 1);
+        dist[i] = d;
+        height[i] = Height(lat_ + d * dlat, lon_ + d * dlon);
+    }
+
+    // Blocked when a sample rises above the antenna-target line:
+    // h - h0 - drop(d) > slope * d
+    const double inv_2kr = 1.0 / (2.0 * REFRACTION_K * EARTH_RADIUS_M);
+    const double h0 = antenna_alt_;
+    int blocked = 0;
+    for (size_t i = 0; i < n; ++i)
+        blocked |= (height[i] - h0 - dist[i] * dist[i] * inv_2kr > target_slope * dist[i]);
+    return blocked != 0;
+}
+
+// ==================== Process-wide state ====================
+
+TileCache* Terrain()
+{
+    static std::unique_ptr<TileCache> cache = []() -> std::unique_ptr<TileCache>
+    {
+        std::string dir = utils::GetEnvString("TERRAIN_DIR", "");
+        if (dir.empty())
+            return nullptr;
+        size_t tiles = static_cast<size_t>(utils::GetEnvDouble("TERRAIN_CACHE_TILES", 16));
+        std::cout << "[TERRAIN] Line-of-sight masking with DEM tiles from " << dir << std::endl;
+        return std::make_unique<TileCache>(dir, tiles);
+    }();
+    return cache.get();
+}
+
+std::shared_ptr<const HorizonProfile> ProfileFor(double lat, double lon, double alt_m, double max_range_m)
+{
+    TileCache* cache = Terrain();
+    if (!cache)
+        return nullptr;
+
+    static std::mutex mtx;
+    static std::map<std::vector<double>, std::shared_ptr<const HorizonProfile>> profiles;
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<double> key{lat, lon, alt_m, max_range_m};
+    auto it = profiles.find(key);
+    if (it != profiles.end())
+        return it->second;
+    auto profile = std::make_shared<const HorizonProfile>(*cache, lat, lon, alt_m, max_range_m);
+    profiles.emplace(std::move(key), profile);
+    return profile;
+}
+
+} // namespace terrain
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Terrain line-of-sight masking for the radar model.
+//
+// Elevation comes from SRTM-style .hgt tiles (one 1x1 degree file per
+// cell, e.g. N39E032.hgt, big-endian int16 metres on a 1201x1201 or
+// 3601x3601 grid) memory-mapped on first use and kept in an LRU cache.
+//
+// Each radar gets a HorizonProfile built once: per azimuth bin, the highest
+// terrain elevation angle out to its maximum range and the distance it
+// occurs at. A look then usually needs a single table read: targets above
+// the horizon are visible, targets beyond the horizon ridge and below it are
+// hidden. Only targets in front of the ridge and below its angle are ray
+// marched, against tiles the profile pinned in memory when it was built.
+namespace terrain {
+
+// One mapped .hgt file.
+class Tile
+{
+public:
+    static std::shared_ptr<const Tile> Map(const std::string& path, int lat, int lon);
+    ~Tile();
+
+    Tile(const Tile&) = delete;
+    Tile& operator=(const Tile&) = delete;
+
+    // Height (m) of the post nearest (lat, lon); the point must lie in this tile.
+    double Nearest(double lat, double lon) const;
+
+    // Bilinear height (m) at (lat, lon) in this tile.
+    double Bilinear(double lat, double lon) const;
+
+    int lat() const { return lat_; }
+    int lon() const { return lon_; }
+    size_t size() const { return n_; }
+
+private:
+    Tile() = default;
+    double Post(size_t row, size_t col) const;
+
+    int lat_ = 0;           // South-west corner
+    int lon_ = 0;
+    size_t n_ = 0;          // Posts per side
+    const uint8_t* data_ = nullptr;
+    size_t bytes_ = 0;
+};
+
+// Tiles mapped on demand from `dir`, at most `max_tiles` kept mapped (LRU).
+// Cells without a file read as sea level. Thread-safe.
+class TileCache
+{
+public:
+    TileCache(std::string dir, size_t max_tiles);
+
+    // Null when the cell has no tile.
+    std::shared_ptr<const Tile> Get(int lat, int lon);
+
+    double Elevation(double lat, double lon);
+
+private:
+    using Key = std::pair<int, int>;
+
+    std::string dir_;
+    size_t max_tiles_;
+    std::mutex mtx_;
+    std::list<Key> lru_;    // Most recent first
+    std::map<Key, std::pair<std::shared_ptr<const Tile>, std::list<Key>::iterator>> tiles_;
+};
+
+class HorizonProfile
+{
+public:
+    // Marches every azimuth bin out to max_range_m from the antenna at
+    // (lat, lon, antenna_alt_m MSL).
+    HorizonProfile(TileCache& cache, double lat, double lon, double antenna_alt_m, double max_range_m);
+
+    // True when nothing in the terrain blocks the ray from the antenna to a
+    // target at `alt_m` MSL, `range_m` away on `bearing_deg`.
+    bool Visible(double bearing_deg, double range_m, double alt_m) const;
+
+    // Antenna height MSL: the requested altitude, but at least a mast
+    // height above the ground at the site.
+    double antenna_alt() const { return antenna_alt_; }
+
+private:
+    // Terrain height at the march sample, from the pinned tiles.
+    double Height(double lat, double lon) const;
+    bool March(double bearing_deg, double range_m, double target_slope) const;
+
+    double lat_, lon_, antenna_alt_, max_range_;
+    double step_m_;                     // March step, about one DEM post
+    std::vector<float> horizon_slope_;  // Per azimuth ray: max (h - h0 - drop) / d
+    std::vector<float> horizon_range_;  // Distance of that maximum, m
+
+    // Tiles covering the profile's reach, indexed [lat - lat0][lon - lon0]
+    int tile_lat0_ = 0, tile_lon0_ = 0, tile_rows_ = 0, tile_cols_ = 0;
+    std::vector<std::shared_ptr<const Tile>> pinned_;
+};
+
+// Process-wide tile cache from TERRAIN_DIR (TERRAIN_CACHE_TILES tiles,
+// default 16); null when TERRAIN_DIR is unset.
+TileCache* Terrain();
+
+// Shared profile for a radar site, built on first request. Radars are
+// looked up by position, antenna height and range, so repeated models of
+// the same site (campaign trials) reuse one profile. Null without terrain.
+std::shared_ptr<const HorizonProfile> ProfileFor(double lat, double lon, double alt_m, double max_range_m);
+
+} // namespace terrain
@@ -0,0 +1,309 @@
+#include "track_multicast.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace mcast {
+
+namespace
+{
+    // Room for a full keyframe of a few thousand tracks in flight
+    constexpr int SOCKET_BUFFER_BYTES = 4 * 1024 * 1024;
+
+    bool ParseAddress(const std::string& s, in_addr& out)
+    {
+        return ::inet_pton(AF_INET, s.c_str(), &out) == 1;
+    }
+}
+
+void SetExternalId(TrackRecord& record, const std::string& s)
+{
+    size_t n = std::min(s.size(), sizeof(record.external_id) - 1);
+    std::memcpy(record.external_id, s.data(), n);
+    std::memset(record.external_id + n, 0, sizeof(record.external_id) - n);
+}
+
+std::string GetExternalId(const TrackRecord& record)
+{
+    size_t n = 0;
+    while (n < sizeof(record.external_id) && record.external_id[n] != '\0')
+        ++n;
+    return std::string(record.external_id, n);
+}
+
+int64_t WallNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// ==================== Sender ====================
+
+std::unique_ptr<Sender> Sender::Open(const std::string& group, int port, int ttl,
+                                     const std::string& iface, bool loopback)
+{
+    sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons((uint16_t)port);
+    if (!ParseAddress(group, dest.sin_addr) || !IN_MULTICAST(ntohl(dest.sin_addr.s_addr)))
+    {
+        std::cerr << "[MCAST] Not an IPv4 multicast group: " << group << std::endl;
+        return nullptr;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        std::cerr << "[MCAST] socket: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    unsigned char ttl_opt = (unsigned char)std::clamp(ttl, 0, 255);
+    unsigned char loop_opt = loopback ? 1 : 0;
+    int sndbuf = SOCKET_BUFFER_BYTES;
+    ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl_opt, sizeof(ttl_opt));
+    ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop_opt, sizeof(loop_opt));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    if (!iface.empty())
+    {
+        in_addr if_addr{};
+        if (!ParseAddress(iface, if_addr) ||
+            ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &if_addr, sizeof(if_addr)) != 0)
+        {
+            std::cerr << "[MCAST] Cannot send on interface " << iface << std::endl;
+            ::close(fd);
+            return nullptr;
+        }
+    }
+    // Connected, so each datagram is a plain send().
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&dest), sizeof(dest)) != 0)
+    {
+        std::cerr << "[MCAST] connect " << group << ":" << port << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<Sender> s(new Sender());
+    s->fd_ = fd;
+    s->buffer_.resize(MAX_DATAGRAM_BYTES);
+    return s;
+}
+
+Sender::~Sender()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+size_t Sender::SendCycle(uint64_t cycle, bool keyframe, const TrackRecord* records, size_t count)
+{
+    if (count == 0 && !keyframe)
+        return 0;
+
+    size_t fragments = std::max<size_t>((count + RECORDS_PER_DATAGRAM - 1) / RECORDS_PER_DATAGRAM, 1);
+    if (fragments > UINT16_MAX)
+    {
+        // Receivers would never assemble it; drop the cycle and let the
+        // sequence jump so they resynchronise.
+        sequence_ += fragments;
+        ++send_errors_;
+        return 0;
+    }
+
+    auto* header = reinterpret_cast<DatagramHeader*>(buffer_.data());
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->version = VERSION;
+    header->flags = keyframe ? KEYFRAME : 0;
+    header->cycle = cycle;
+    header->fragments = (uint16_t)fragments;
+    header->record_size = sizeof(TrackRecord);
+
+    for (size_t f = 0; f < fragments; ++f)
+    {
+        size_t first = f * RECORDS_PER_DATAGRAM;
+        size_t n = std::min(RECORDS_PER_DATAGRAM, count - first);
+        header->sequence = ++sequence_;
+        header->fragment = (uint16_t)f;
+        header->record_count = (uint16_t)n;
+        header->send_time_ns = WallNowNs();
+        std::memcpy(buffer_.data() + sizeof(DatagramHeader), records + first, n * sizeof(TrackRecord));
+
+        size_t bytes = sizeof(DatagramHeader) + n * sizeof(TrackRecord);
+        // Never block the fusion loop: a full socket buffer drops the
+        // datagram and receivers see the gap.
+        if (::send(fd_, buffer_.data(), bytes, MSG_DONTWAIT) == (ssize_t)bytes)
+            bytes_sent_ += bytes;
+        else
+            ++send_errors_;
+    }
+    return fragments;
+}
+
+// ==================== Receiver ====================
+
+std::unique_ptr<Receiver> Receiver::Open(const std::string& group, int port, const std::string& iface)
+{
+    ip_mreq mreq{};
+    if (!ParseAddress(group, mreq.imr_multiaddr) || !IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr)))
+    {
+        std::cerr << "[MCAST] Not an IPv4 multicast group: " << group << std::endl;
+        return nullptr;
+    }
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (!iface.empty() && !ParseAddress(iface, mreq.imr_interface))
+    {
+        std::cerr << "[MCAST] Bad interface address: " << iface << std::endl;
+        return nullptr;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        std::cerr << "[MCAST] socket: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    // Several consumers on one host share the port.
+    int one = 1;
+    int rcvbuf = SOCKET_BUFFER_BYTES;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    // Bound to the group address, so only this group's traffic arrives.
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons((uint16_t)port);
+    local.sin_addr = mreq.imr_multiaddr;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0)
+    {
+        std::cerr << "[MCAST] Cannot join " << group << ":" << port << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<Receiver> r(new Receiver());
+    r->fd_ = fd;
+    r->buffer_.resize(65536);
+    return r;
+}
+
+Receiver::~Receiver()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+size_t Receiver::Poll(int timeout_ms)
+{
+    if (timeout_ms != 0)
+    {
+        pollfd pfd{fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, timeout_ms) <= 0)
+            return 0;
+    }
+
+    size_t n = 0;
+    for (;;)
+    {
+        ssize_t len = ::recv(fd_, buffer_.data(), buffer_.size(), MSG_DONTWAIT);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        Apply(buffer_.data(), (size_t)len, WallNowNs());
+        ++n;
+    }
+    return n;
+}
+
+void Receiver::Apply(const char* data, size_t size, int64_t recv_time_ns)
+{
+    DatagramHeader header;
+    if (size < sizeof(header))
+    {
+        ++stats_.malformed;
+        return;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.record_size != sizeof(TrackRecord) ||
+        size != sizeof(header) + (size_t)header.record_count * sizeof(TrackRecord) ||
+        header.fragment >= header.fragments)
+    {
+        ++stats_.malformed;
+        return;
+    }
+    ++stats_.datagrams;
+
+    // A jump ahead is loss; a step back means the sender restarted. Either
+    // way the picture can no longer be trusted.
+    if (next_sequence_ != 0 && header.sequence != next_sequence_)
+    {
+        if (header.sequence > next_sequence_)
+            stats_.lost += header.sequence - next_sequence_;
+        ++stats_.gaps;
+        synced_ = false;
+        keyframe_next_ = 0;
+    }
+    next_sequence_ = header.sequence + 1;
+    last_cycle_ = header.cycle;
+
+    const char* payload = data + sizeof(header);
+    if (header.flags & KEYFRAME)
+    {
+        // Assembled aside and swapped in whole; a keyframe joined halfway
+        // is skipped.
+        if (header.fragment == 0)
+        {
+            keyframe_.clear();
+            keyframe_cycle_ = header.cycle;
+        }
+        else if (header.fragment != keyframe_next_ || header.cycle != keyframe_cycle_)
+        {
+            keyframe_next_ = 0;
+            return;
+        }
+        size_t old = keyframe_.size();
+        keyframe_.resize(old + header.record_count);
+        std::memcpy(keyframe_.data() + old, payload, header.record_count * sizeof(TrackRecord));
+        keyframe_next_ = header.fragment + 1;
+
+        if (keyframe_next_ == header.fragments)
+        {
+            tracks_.clear();
+            for (const TrackRecord& r : keyframe_)
+                tracks_[r.track_id] = r;
+            keyframe_next_ = 0;
+            synced_ = true;
+            ++stats_.keyframes;
+        }
+    }
+    else
+    {
+        for (uint16_t i = 0; i < header.record_count; ++i)
+        {
+            TrackRecord r;
+            std::memcpy(&r, payload + i * sizeof(TrackRecord), sizeof(r));
+            if (r.flags & REMOVED)
+                tracks_.erase(r.track_id);
+            else
+                tracks_[r.track_id] = r;
+        }
+    }
+
+    if (on_datagram_)
+        on_datagram_(header, recv_time_ns);
+}
+
+} // namespace mcast
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Fused-track output over UDP multicast.
+//
+// Fusion sends each cycle as fixed-layout binary datagrams to one multicast
+// group, so any number of consumers on the network (or on the host, through
+// multicast loopback) receive the picture for the cost of a single send. A
+// datagram is a DatagramHeader followed by `record_count` TrackRecords, in
+// host byte order (little-endian on every supported platform).
+//
+// A cycle normally carries only the tracks updated or removed in it (a
+// delta). Every few hundred milliseconds the cycle is sent as a keyframe
+// instead: the complete picture, split over as many datagrams as it needs.
+// Datagram sequence numbers are consecutive, so a receiver detects loss
+// from a jump and rebuilds its picture from the next complete keyframe.
+namespace mcast {
+
+constexpr char MAGIC[4] = {'B', 'F', 'T', 'M'};
+constexpr uint16_t VERSION = 1;
+
+// Fits one Ethernet frame: 1500-byte MTU less the IPv4 and UDP headers.
+constexpr size_t MAX_DATAGRAM_BYTES = 1472;
+
+enum DatagramFlags : uint16_t
+{
+    KEYFRAME = 1,       // Part of a complete picture
+};
+
+enum RecordFlags : uint32_t
+{
+    REMOVED = 1,        // Track dropped by fusion; only track_id is valid
+    HAS_ERROR = 2,      // uav_error_m holds the distance to the UAV report
+};
+
+struct DatagramHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;                 // DatagramFlags
+    uint64_t sequence;              // Per datagram, consecutive from 1
+    uint64_t cycle;                 // Fusion cycle the records belong to
+    int64_t send_time_ns;           // Sender wall clock (ns since epoch)
+    uint16_t fragment;              // Index of this datagram within the cycle
+    uint16_t fragments;             // Datagrams in the cycle
+    uint16_t record_count;
+    uint16_t record_size;           // sizeof(TrackRecord) on the sender
+};
+static_assert(sizeof(DatagramHeader) == 40, "multicast header layout changed");
+
+// One fused track. Ids longer than external_id are truncated.
+struct TrackRecord
+{
+    uint32_t track_id;
+    uint32_t flags;                 // RecordFlags
+    int64_t measurement_ts;         // ms since epoch of the newest fused measurement
+    double lat, lon;                // deg
+    float alt;                      // m
+    float confidence;
+    float var_north, cov_north_east, var_east; // Position covariance (m^2)
+    float uav_error_m;
+    char external_id[16];
+};
+static_assert(sizeof(TrackRecord) == 72, "multicast record layout changed");
+
+constexpr size_t RECORDS_PER_DATAGRAM = (MAX_DATAGRAM_BYTES - sizeof(DatagramHeader)) / sizeof(TrackRecord);
+
+// Copies `s` into the fixed field, NUL-terminated.
+void SetExternalId(TrackRecord& record, const std::string& s);
+std::string GetExternalId(const TrackRecord& record);
+
+int64_t WallNowNs();
+
+// Fusion side. Not thread-safe.
+class Sender
+{
+public:
+    // `iface` is the IPv4 address of the outgoing interface, empty for the
+    // routing default. `loopback` also delivers to receivers on this host.
+    static std::unique_ptr<Sender> Open(const std::string& group, int port, int ttl,
+                                        const std::string& iface, bool loopback);
+    ~Sender();
+
+    // Sends `count` records as cycle `cycle`, split into datagrams. An
+    // empty keyframe still sends one datagram so receivers learn the
+    // picture is empty. Returns the datagrams sent.
+    size_t SendCycle(uint64_t cycle, bool keyframe, const TrackRecord* records, size_t count);
+
+    uint64_t datagrams_sent() const { return sequence_; }
+    uint64_t bytes_sent() const { return bytes_sent_; }
+    uint64_t send_errors() const { return send_errors_; }
+
+private:
+    Sender() = default;
+
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    uint64_t sequence_ = 0;
+    uint64_t bytes_sent_ = 0;
+    uint64_t send_errors_ = 0;
+};
+
+// Consumer side: joins the group and keeps the latest picture. Not
+// thread-safe; one thread calls Poll.
+class Receiver
+{
+public:
+    struct Stats
+    {
+        uint64_t datagrams = 0;
+        uint64_t lost = 0;          // Datagrams missing from the sequence
+        uint64_t gaps = 0;          // Sequence jumps (each starts a resync)
+        uint64_t keyframes = 0;     // Complete keyframes applied
+        uint64_t malformed = 0;
+    };
+
+    // Called once per applied datagram with the sender's header and the
+    // receive time (wall clock, ns), e.g. to measure delivery latency.
+    using DatagramFn = std::function<void(const DatagramHeader&, int64_t recv_time_ns)>;
+
+    static std::unique_ptr<Receiver> Open(const std::string& group, int port, const std::string& iface = "");
+    ~Receiver();
+
+    // Waits up to `timeout_ms` (-1 = indefinitely, 0 = not at all) for
+    // data, then reads and applies every queued datagram. Returns the
+    // number of datagrams read.
+    size_t Poll(int timeout_ms);
+
+    void OnDatagram(DatagramFn fn) { on_datagram_ = std::move(fn); }
+
+    // False from start-up, and after a gap, until a complete keyframe has
+    // been received. Deltas are still applied meanwhile, but removals and
+    // updates lost in the gap are only repaired by the keyframe.
+    bool synced() const { return synced_; }
+
+    const std::unordered_map<uint32_t, TrackRecord>& tracks() const { return tracks_; }
+    uint64_t last_cycle() const { return last_cycle_; }
+    const Stats& stats() const { return stats_; }
+    int fd() const { return fd_; }
+
+private:
+    Receiver() = default;
+
+    void Apply(const char* data, size_t size, int64_t recv_time_ns);
+
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    std::unordered_map<uint32_t, TrackRecord> tracks_;
+    bool synced_ = false;
+    uint64_t next_sequence_ = 0;    // 0 = nothing received yet
+    uint64_t last_cycle_ = 0;
+
+    // Keyframe being assembled
+    std::vector<TrackRecord> keyframe_;
+    uint64_t keyframe_cycle_ = 0;
+    uint16_t keyframe_next_ = 0;    // Next fragment expected, 0 = none in progress
+
+    Stats stats_;
+    DatagramFn on_datagram_;
+};
+
+} // namespace mcast
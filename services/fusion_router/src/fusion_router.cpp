@@ -0,0 +1,302 @@
+#include "fusion_router.h"
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+
+namespace
+{
+    // Outbound streams of one inbound sensor stream, opened lazily per shard.
+    // A failed write drops that shard's stream; the next message reopens it.
+    template <typename Msg>
+    class ShardWriters
+    {
+    public:
+        using Open = std::function<std::unique_ptr<grpc::ClientWriter<Msg>>(
+            fusion::FusionService::Stub&, grpc::ClientContext*, fusion::FusionAck*)>;
+
+        ShardWriters(FusionRouterImpl& router, Open open) : router_(router), open_(std::move(open)) {}
+        ~ShardWriters() { Finish(); }
+
+        bool Write(const ShardInfo& shard, const Msg& msg)
+        {
+            Stream& s = streams_[shard.address];
+            if (!s.writer)
+            {
+                s.context = std::make_unique<grpc::ClientContext>();
+                s.writer = open_(*router_.Stubs(shard.address).fusion, s.context.get(), &s.ack);
+            }
+            if (s.writer && s.writer->Write(msg))
+                return true;
+
+            if (s.writer)
+            {
+                grpc::Status status = s.writer->Finish();
+                std::cerr << "[ROUTER] Lost stream to shard " << shard.id << " (" << shard.address
+                          << "): " << status.error_message() << std::endl;
+            }
+            streams_.erase(shard.address);
+            return false;
+        }
+
+        void Finish()
+        {
+            for (auto& kv : streams_)
+            {
+                if (!kv.second.writer)
+                    continue;
+                kv.second.writer->WritesDone();
+                kv.second.writer->Finish();
+            }
+            streams_.clear();
+        }
+
+    private:
+        struct Stream
+        {
+            std::unique_ptr<grpc::ClientContext> context;
+            fusion::FusionAck ack;
+            std::unique_ptr<grpc::ClientWriter<Msg>> writer;
+        };
+
+        FusionRouterImpl& router_;
+        Open open_;
+        std::unordered_map<std::string, Stream> streams_;
+    };
+
+    constexpr int HANDOFF_DEADLINE_MS = 2000;
+    constexpr int HANDOFF_RETRY_MS = 1000; // Wait after a failed handoff
+}
+
+FusionRouterImpl::FusionRouterImpl(PartitionMap initial, const std::string& partition_path, double handoff_margin_deg)
+    : map_(std::make_shared<const PartitionMap>(std::move(initial))),
+      partition_path_(partition_path),
+      handoff_margin_deg_(handoff_margin_deg)
+{
+    handoff_thread_ = std::thread(&FusionRouterImpl::HandoffLoop, this);
+    if (!partition_path_.empty())
+        watcher_ = std::thread(&FusionRouterImpl::WatchPartitionFile, this);
+}
+
+FusionRouterImpl::~FusionRouterImpl()
+{
+    {
+        std::lock_guard<std::mutex> lock(owners_mtx_);
+        running_ = false;
+    }
+    handoff_cv_.notify_all();
+    if (handoff_thread_.joinable())
+        handoff_thread_.join();
+    if (watcher_.joinable())
+        watcher_.join();
+}
+
+FusionRouterImpl::ShardStubs& FusionRouterImpl::Stubs(const std::string& address)
+{
+    std::lock_guard<std::mutex> lock(stubs_mtx_);
+    auto& entry = stubs_[address];
+    if (!entry)
+    {
+        entry = std::make_unique<ShardStubs>();
+        entry->channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+        entry->fusion = fusion::FusionService::NewStub(entry->channel);
+        entry->shard = fusion::FusionShard::NewStub(entry->channel);
+    }
+    return *entry;
+}
+
+std::shared_ptr<const PartitionMap> FusionRouterImpl::CurrentMap() const
+{
+    std::lock_guard<std::mutex> lock(map_mtx_);
+    return map_;
+}
+
+const ShardInfo& FusionRouterImpl::Route(const PartitionMap& map, const std::string& target_id, double lat, double lon)
+{
+    const ShardInfo& dest = map.Lookup(lat, lon);
+    if (target_id.empty())
+        return dest;
+
+    std::lock_guard<std::mutex> lock(owners_mtx_);
+    auto it = owners_.find(target_id);
+    if (it == owners_.end())
+    {
+        owners_[target_id].shard = dest.id;
+        return dest;
+    }
+
+    Ownership& o = it->second;
+    const ShardInfo* owner = map.Find(o.shard);
+    if (!owner)
+    {
+        std::cerr << "[ROUTER] Shard " << o.shard << " left the partition map; "
+                  << target_id << " restarts on " << dest.id << std::endl;
+        o = Ownership(); // A handoff still in flight is ignored when it ends
+        o.shard = dest.id;
+        return dest;
+    }
+    if (owner->id == dest.id || owner->Contains(lat, lon, handoff_margin_deg_) || !o.moving_to.empty() ||
+        std::chrono::steady_clock::now() < o.retry_after)
+        return *owner;
+
+    // The old shard keeps the target until the handoff is through.
+    o.moving_to = dest.id;
+    handoff_queue_.push_back(HandoffJob{target_id, *owner, dest});
+    handoff_cv_.notify_one();
+    return *owner;
+}
+
+void FusionRouterImpl::HandoffLoop()
+{
+    std::unique_lock<std::mutex> lock(owners_mtx_);
+    while (true)
+    {
+        handoff_cv_.wait(lock, [&] { return !running_ || !handoff_queue_.empty(); });
+        if (!running_)
+            break;
+        HandoffJob job = std::move(handoff_queue_.front());
+        handoff_queue_.pop_front();
+
+        lock.unlock();
+        bool moved = Handoff(job.target_id, job.from, job.to);
+        lock.lock();
+
+        auto it = owners_.find(job.target_id);
+        if (it == owners_.end() || it->second.moving_to != job.to.id)
+            continue;
+        if (moved)
+            it->second.shard = job.to.id;
+        else
+            it->second.retry_after = std::chrono::steady_clock::now() + std::chrono::milliseconds(HANDOFF_RETRY_MS);
+        it->second.moving_to.clear();
+    }
+}
+
+bool FusionRouterImpl::Handoff(const std::string& target_id, const ShardInfo& from, const ShardInfo& to)
+{
+    fusion::TrackExportRequest req;
+    req.set_external_id(target_id);
+    fusion::TrackHandoff handoff;
+    {
+        grpc::ClientContext ctx;
+        ctx.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(HANDOFF_DEADLINE_MS));
+        grpc::Status status = Stubs(from.address).shard->ExportTrack(&ctx, req, &handoff);
+        if (!status.ok())
+        {
+            std::cerr << "[ROUTER] Export of " << target_id << " from " << from.id
+                      << " failed: " << status.error_message() << std::endl;
+            return false;
+        }
+    }
+    if (!handoff.found())
+        return true; // Nothing fused yet on the old shard
+
+    if (!Import(handoff, to))
+    {
+        // The old shard has let go of the track: give it back, or let it
+        // restart on the new one if even that fails.
+        if (Import(handoff, from))
+            return false;
+        std::cerr << "[ROUTER] " << target_id << " lost its state, restarts on " << to.id << std::endl;
+        return true;
+    }
+    std::cout << "[ROUTER] Handoff " << target_id << ": " << from.id << " -> " << to.id
+              << " (" << handoff.history_size() << " history points)" << std::endl;
+    return true;
+}
+
+bool FusionRouterImpl::Import(const fusion::TrackHandoff& handoff, const ShardInfo& to)
+{
+    grpc::ClientContext ctx;
+    ctx.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(HANDOFF_DEADLINE_MS));
+    fusion::FusionAck ack;
+    grpc::Status status = Stubs(to.address).shard->ImportTrack(&ctx, handoff, &ack);
+    if (!status.ok())
+    {
+        std::cerr << "[ROUTER] Import of " << handoff.external_id() << " into " << to.id
+                  << " failed: " << status.error_message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void FusionRouterImpl::WatchPartitionFile()
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto last_write = fs::last_write_time(partition_path_, ec);
+    while (running_)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        auto t = fs::last_write_time(partition_path_, ec);
+        if (ec || t == last_write)
+            continue;
+        last_write = t;
+
+        PartitionMap map;
+        std::string error;
+        if (!PartitionMap::LoadFile(partition_path_, map, error))
+        {
+            std::cerr << "[ROUTER] Keeping previous partition map, reload failed: " << error << std::endl;
+            continue;
+        }
+        std::cout << "[ROUTER] Partition map reloaded (" << map.shards().size() << " shards)" << std::endl;
+        std::lock_guard<std::mutex> lock(map_mtx_);
+        map_ = std::make_shared<const PartitionMap>(std::move(map));
+    }
+}
+
+grpc::Status FusionRouterImpl::StreamUAV(grpc::ServerContext* /*context*/,
+                                         grpc::ServerReader<sensors::UAVTelemetry>* reader,
+                                         fusion::FusionAck* ack)
+{
+    ShardWriters<sensors::UAVTelemetry> writers(
+        *this, [](fusion::FusionService::Stub& stub, grpc::ClientContext* ctx, fusion::FusionAck* a)
+        { return stub.StreamUAV(ctx, a); });
+    sensors::UAVTelemetry msg;
+    while (reader->Read(&msg))
+    {
+        auto map = CurrentMap();
+        writers.Write(Route(*map, msg.uav_id(), msg.position().lat(), msg.position().lon()), msg);
+    }
+    ack->set_ok(true);
+    return grpc::Status::OK;
+}
+
+grpc::Status FusionRouterImpl::StreamRadar(grpc::ServerContext* /*context*/,
+                                           grpc::ServerReader<sensors::RadarDetection>* reader,
+                                           fusion::FusionAck* ack)
+{
+    ShardWriters<sensors::RadarDetection> writers(
+        *this, [](fusion::FusionService::Stub& stub, grpc::ClientContext* ctx, fusion::FusionAck* a)
+        { return stub.StreamRadar(ctx, a); });
+    sensors::RadarDetection msg;
+    while (reader->Read(&msg))
+    {
+        // radar_lat/radar_lon carry the detection's geo position
+        auto map = CurrentMap();
+        writers.Write(Route(*map, msg.track_id(), msg.radar_lat(), msg.radar_lon()), msg);
+    }
+    ack->set_ok(true);
+    return grpc::Status::OK;
+}
+
+grpc::Status FusionRouterImpl::StreamSigint(grpc::ServerContext* /*context*/,
+                                            grpc::ServerReader<sensors::SigintHit>* reader,
+                                            fusion::FusionAck* ack)
+{
+    // SIGINT hits carry no position: every shard gets them.
+    ShardWriters<sensors::SigintHit> writers(
+        *this, [](fusion::FusionService::Stub& stub, grpc::ClientContext* ctx, fusion::FusionAck* a)
+        { return stub.StreamSigint(ctx, a); });
+    sensors::SigintHit msg;
+    while (reader->Read(&msg))
+    {
+        auto map = CurrentMap();
+        for (const auto& shard : map->shards())
+            writers.Write(shard, msg);
+    }
+    ack->set_ok(true);
+    return grpc::Status::OK;
+}
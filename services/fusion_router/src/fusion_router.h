@@ -0,0 +1,89 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "fusion/fusion.grpc.pb.h"
+#include "partition_map.h"
+
+// Front end for a sharded fusion deployment.
+//
+// Accepts the sensor Stream* RPCs like a single fusion_service and forwards
+// each measurement to the shard owning its position. The router remembers
+// which shard owns each target; when a target leaves its owner's region
+// (plus a hysteresis margin) the track state is exported from the old shard
+// and imported into the new one in the background; the target's
+// measurements keep going to the old shard until the handoff is done.
+class FusionRouterImpl final : public fusion::FusionService::Service {
+public:
+    // partition_path may be empty (fixed map). Otherwise the file is polled
+    // and the map replaced when it changes.
+    FusionRouterImpl(PartitionMap initial, const std::string& partition_path, double handoff_margin_deg);
+    ~FusionRouterImpl();
+
+    grpc::Status StreamUAV(grpc::ServerContext* context, grpc::ServerReader<sensors::UAVTelemetry>* reader,
+                           fusion::FusionAck* ack) override;
+    grpc::Status StreamRadar(grpc::ServerContext* context, grpc::ServerReader<sensors::RadarDetection>* reader,
+                             fusion::FusionAck* ack) override;
+    grpc::Status StreamSigint(grpc::ServerContext* context, grpc::ServerReader<sensors::SigintHit>* reader,
+                              fusion::FusionAck* ack) override;
+
+    struct ShardStubs {
+        std::shared_ptr<grpc::Channel> channel;
+        std::unique_ptr<fusion::FusionService::Stub> fusion;
+        std::unique_ptr<fusion::FusionShard::Stub> shard;
+    };
+
+    // Stubs are created once per address and live as long as the router.
+    ShardStubs& Stubs(const std::string& address);
+
+    std::shared_ptr<const PartitionMap> CurrentMap() const;
+
+    // Shard that should receive a measurement of target_id at (lat, lon);
+    // starts a handoff when ownership changes. The result points into `map`.
+    const ShardInfo& Route(const PartitionMap& map, const std::string& target_id, double lat, double lon);
+
+private:
+    // Moves the track; returns true when the target now belongs to `to`.
+    bool Handoff(const std::string& target_id, const ShardInfo& from, const ShardInfo& to);
+    bool Import(const fusion::TrackHandoff& handoff, const ShardInfo& to);
+    void HandoffLoop();
+    void WatchPartitionFile();
+
+    mutable std::mutex map_mtx_;
+    std::shared_ptr<const PartitionMap> map_;
+    std::string partition_path_;
+    double handoff_margin_deg_;
+
+    std::mutex stubs_mtx_;
+    std::unordered_map<std::string, std::unique_ptr<ShardStubs>> stubs_;
+
+    // Ownership per external target id. Handoffs run on handoff_thread_, so
+    // the lock is only held for lookups and a slow shard stalls no stream.
+    struct Ownership {
+        std::string shard;
+        std::string moving_to; // Shard a handoff is in flight to, else empty
+        std::chrono::steady_clock::time_point retry_after; // After a failed handoff
+    };
+    struct HandoffJob {
+        std::string target_id;
+        ShardInfo from, to;
+    };
+    std::mutex owners_mtx_;
+    std::unordered_map<std::string, Ownership> owners_;
+    std::deque<HandoffJob> handoff_queue_; // Guarded by owners_mtx_
+    std::condition_variable handoff_cv_;
+
+    std::atomic<bool> running_{true};
+    std::thread handoff_thread_;
+    std::thread watcher_;
+};
@@ -0,0 +1,44 @@
+#include "fusion_router.h"
+#include "config.h"
+
+#include <grpcpp/grpcpp.h>
+#include <iostream>
+#include <string>
+
+int main()
+{
+    std::string router_address("0.0.0.0:" + std::to_string((int)utils::GetEnvDouble("ROUTER_PORT", 6000)));
+    std::string partition_path = utils::GetEnvString("FUSION_PARTITION_FILE", "");
+    double margin_deg = utils::GetEnvDouble("HANDOFF_MARGIN_DEG", 0.01);
+
+    PartitionMap map = PartitionMap::Single(utils::GetEnvString("FUSION_SHARD_ADDR", "localhost:6100"));
+    if (!partition_path.empty())
+    {
+        std::string error;
+        if (!PartitionMap::LoadFile(partition_path, map, error))
+        {
+            std::cerr << "[ROUTER] Cannot load partition map " << partition_path << ": " << error << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& s : map.shards())
+    {
+        std::cout << "[ROUTER] Shard " << s.id << " at " << s.address << " owns lat [" << s.min_lat << ", "
+                  << s.max_lat << "] lon [" << s.min_lon << ", " << s.max_lon << "]" << std::endl;
+    }
+
+    FusionRouterImpl router(std::move(map), partition_path, margin_deg);
+
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(router_address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&router);
+    std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+    if (!server)
+    {
+        std::cerr << "[ROUTER] Failed to listen on " << router_address << std::endl;
+        return 1;
+    }
+    std::cout << "[ROUTER] Running at " << router_address << std::endl;
+    server->Wait();
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "partition_map.h"
+
+#include <yaml-cpp/yaml.h>
+
+bool ShardInfo::Contains(double lat, double lon, double margin_deg) const
+{
+    if (lat < min_lat - margin_deg || lat > max_lat + margin_deg)
+        return false;
+    double lo = min_lon - margin_deg;
+    double hi = max_lon + margin_deg;
+    if (min_lon <= max_lon)
+        return lon >= lo && lon <= hi;
+    return lon >= lo || lon <= hi;
+}
+
+bool PartitionMap::LoadFile(const std::string& path, PartitionMap& out, std::string& error)
+{
+    try
+    {
+        YAML::Node root = YAML::LoadFile(path);
+        PartitionMap map;
+        for (const auto& node : root["shards"])
+        {
+            ShardInfo s;
+            s.id = node["id"].as<std::string>();
+            s.address = node["address"].as<std::string>();
+            if (const YAML::Node& r = node["region"])
+            {
+                s.min_lat = r["min_lat"].as<double>(s.min_lat);
+                s.min_lon = r["min_lon"].as<double>(s.min_lon);
+                s.max_lat = r["max_lat"].as<double>(s.max_lat);
+                s.max_lon = r["max_lon"].as<double>(s.max_lon);
+            }
+            map.shards_.push_back(s);
+        }
+        if (map.shards_.empty())
+        {
+            error = "no shards defined";
+            return false;
+        }
+        out = std::move(map);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+        return false;
+    }
+}
+
+PartitionMap PartitionMap::Single(const std::string& address)
+{
+    PartitionMap map;
+    ShardInfo s;
+    s.id = "default";
+    s.address = address;
+    map.shards_.push_back(s);
+    return map;
+}
+
+const ShardInfo& PartitionMap::Lookup(double lat, double lon) const
+{
+    for (const auto& s : shards_)
+    {
+        if (s.Contains(lat, lon))
+            return s;
+    }
+    return shards_.front();
+}
+
+const ShardInfo* PartitionMap::Find(const std::string& id) const
+{
+    for (const auto& s : shards_)
+    {
+        if (s.id == id)
+            return &s;
+    }
+    return nullptr;
+}
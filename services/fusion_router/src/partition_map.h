@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// One fusion shard and the lat/lon box it owns (min_lon > max_lon wraps
+// across the antimeridian, like fusion::GeoRegion).
+struct ShardInfo {
+    std::string id;
+    std::string address;
+    double min_lat = -90.0;
+    double min_lon = -180.0;
+    double max_lat = 90.0;
+    double max_lon = 180.0;
+
+    // True when the point lies in the region grown by margin_deg on every side.
+    bool Contains(double lat, double lon, double margin_deg = 0.0) const;
+};
+
+// Static spatial partition of the world across fusion shards.
+//
+// Loaded from YAML:
+//   shards:
+//     - id: west
+//       address: localhost:6100
+//       region: {min_lat: -90, min_lon: -180, max_lat: 90, max_lon: 32.85}
+//
+// Regions are checked in file order; points outside every region go to the
+// first shard.
+class PartitionMap {
+public:
+    static bool LoadFile(const std::string& path, PartitionMap& out, std::string& error);
+
+    // Whole world on a single shard.
+    static PartitionMap Single(const std::string& address);
+
+    const ShardInfo& Lookup(double lat, double lon) const;
+    const ShardInfo* Find(const std::string& id) const;
+    const std::vector<ShardInfo>& shards() const { return shards_; }
+
+private:
+    std::vector<ShardInfo> shards_;
+};
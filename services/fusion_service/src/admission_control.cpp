@@ -0,0 +1,161 @@
+#include "admission_control.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "config.h"
+#include "metrics/fusion_metrics.h"
+
+namespace
+{
+    const char *const REASON_NAMES[] = {"conflated", "converged", "over_budget", "priority", "queue_full"};
+}
+
+AdmissionControl::AdmissionControl()
+    : queue_limit_((size_t)std::max(utils::GetEnvDouble("ADMISSION_QUEUE_LIMIT", 100000), 1.0)),
+      converged_keep_((uint32_t)std::max(utils::GetEnvDouble("ADMISSION_CONVERGED_KEEP", 4), 1.0))
+{
+    // "TYPE=priority:rate", comma separated
+    std::stringstream ss(utils::GetEnvString("ADMISSION_CLASSES", "RADAR=2:20000,UAV=1:2000,SIGINT=0:1000"));
+    std::string entry;
+    while (std::getline(ss, entry, ','))
+    {
+        size_t eq = entry.find('=');
+        if (eq == std::string::npos)
+            continue;
+        ClassState &c = classes_[entry.substr(0, eq)];
+        std::stringstream spec(entry.substr(eq + 1));
+        char sep = 0;
+        spec >> c.config.priority >> sep >> c.config.rate_budget;
+        c.tokens = c.config.rate_budget;
+        c.refilled = std::chrono::steady_clock::now();
+    }
+    for (const auto &c : classes_)
+        top_priority_ = std::max(top_priority_, c.second.config.priority);
+}
+
+AdmissionControl::ClassState &AdmissionControl::Class(const std::string &sensor_type)
+{
+    // Unlisted sensor types: lowest priority, no budget.
+    auto it = classes_.find(sensor_type);
+    if (it != classes_.end())
+        return it->second;
+    ClassState &c = classes_[sensor_type];
+    c.config.priority = -1;
+    return c;
+}
+
+bool AdmissionControl::TakeToken(ClassState &c)
+{
+    if (c.config.rate_budget <= 0.0)
+        return true;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - c.refilled).count();
+    c.refilled = now;
+    // One second of budget as burst allowance
+    c.tokens = std::min(c.config.rate_budget, c.tokens + elapsed * c.config.rate_budget);
+    if (c.tokens < 1.0)
+        return false;
+    c.tokens -= 1.0;
+    return true;
+}
+
+void AdmissionControl::Shed(const SensorMeasurement &m, Reason reason)
+{
+    // Per sensor in the metrics, per class in the log.
+    metrics::Counter *&counter = shed_counters_[m.sensor_type + "/" + m.sensor_id + "/" + REASON_NAMES[reason]];
+    if (!counter)
+        counter = &metrics::FusionMetrics::Shed(m.sensor_type, m.sensor_id, REASON_NAMES[reason]);
+    counter->Inc();
+    ++shed_since_report_[m.sensor_type + " " + REASON_NAMES[reason]];
+}
+
+bool AdmissionControl::Offer(std::deque<SensorMeasurement> &queue, SensorMeasurement &&m)
+{
+    size_t depth = queue.size();
+    int stage = depth >= queue_limit_             ? 4
+                : depth * 10 >= queue_limit_ * 9 ? 3
+                : depth * 4 >= queue_limit_ * 3  ? 2
+                : depth * 2 >= queue_limit_      ? 1
+                                                 : 0;
+    if (stage != stage_)
+    {
+        stage_ = stage;
+        metrics::FusionMetrics::Get().admission_stage.Set(stage);
+    }
+    peak_stage_ = std::max(peak_stage_, stage);
+
+    // The bucket drains on every offer so the rate is known before overload.
+    ClassState &c = Class(m.sensor_type);
+    bool in_budget = TakeToken(c);
+    bool is_uav = m.sensor_type == "UAV";
+
+    if (stage >= 1)
+    {
+        // Newer telemetry supersedes the queued report; the queue does not grow.
+        if (is_uav)
+        {
+            auto slot = uav_slot_.find(m.target_id);
+            if (slot != uav_slot_.end())
+            {
+                Shed(queue[slot->second], CONFLATED);
+                queue[slot->second] = std::move(m);
+                return true;
+            }
+        }
+        else if (m.sensor_type == "RADAR" && converged_.count(m.target_id) &&
+                 converged_seen_[m.target_id]++ % converged_keep_ != 0)
+        {
+            Shed(m, CONVERGED);
+            return false;
+        }
+    }
+
+    Reason reason = REASON_COUNT;
+    if (stage >= 4)
+        reason = QUEUE_FULL;
+    else if (stage >= 3 && c.config.priority < top_priority_)
+        reason = PRIORITY;
+    else if (stage >= 2 && !in_budget)
+        reason = OVER_BUDGET;
+    if (reason != REASON_COUNT)
+    {
+        Shed(m, reason);
+        return false;
+    }
+
+    if (is_uav)
+        uav_slot_[m.target_id] = queue.size();
+    queue.push_back(std::move(m));
+    return true;
+}
+
+void AdmissionControl::Drained()
+{
+    uav_slot_.clear();
+}
+
+void AdmissionControl::SetConverged(const std::string &target_id, bool converged)
+{
+    if (converged)
+        converged_.insert(target_id);
+    else
+    {
+        converged_.erase(target_id);
+        converged_seen_.erase(target_id);
+    }
+}
+
+std::string AdmissionControl::TakeReport()
+{
+    std::stringstream ss;
+    for (const auto &s : shed_since_report_)
+        ss << (ss.tellp() > 0 ? ", " : "") << s.first << "=" << s.second;
+    shed_since_report_.clear();
+    std::string shed = ss.str();
+    int peak = peak_stage_;
+    peak_stage_ = stage_;
+    if (shed.empty())
+        return "";
+    return "Peak stage " + std::to_string(peak) + " (queue limit " + std::to_string(queue_limit_) + "), shed " + shed;
+}
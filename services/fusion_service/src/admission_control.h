@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "sensor_measurement.h"
+
+namespace metrics
+{
+    class Counter;
+}
+
+// Priority-aware admission to the fusion ingest queue.
+//
+// The queue holds at most `queue_limit` measurements. As it fills, admission
+// degrades in stages instead of letting memory and latency grow:
+//   stage 1 (>= 50%)  redundant inputs are decimated: UAV telemetry replaces
+//                     the queued report of the same UAV, and radar detections
+//                     of converged tracks are thinned to one in `converged_keep`
+//   stage 2 (>= 75%)  measurements over their sensor class's rate budget are shed
+//   stage 3 (>= 90%)  every class below the highest priority is shed
+//   stage 4 (full)    everything is shed
+// Each shed measurement is counted by sensor type, sensor id and reason
+// (fusion_shed_total) and summarised in the log.
+//
+// Not thread-safe: the fusion service calls it under its queue mutex.
+class AdmissionControl
+{
+public:
+    struct SensorClass
+    {
+        int priority = 0;         // Higher is shed later
+        double rate_budget = 0.0; // Measurements per second, 0 = unlimited
+    };
+
+    // ADMISSION_QUEUE_LIMIT (default 100000), ADMISSION_CONVERGED_KEEP
+    // (default 4) and ADMISSION_CLASSES, "TYPE=priority:rate,..." (default
+    // "RADAR=2:20000,UAV=1:2000,SIGINT=0:1000").
+    AdmissionControl();
+
+    // Appends `m` to `queue`, folds it into a queued measurement, or sheds
+    // it. Returns false when it was shed.
+    bool Offer(std::deque<SensorMeasurement> &queue, SensorMeasurement &&m);
+
+    // The fusion loop took the whole queue.
+    void Drained();
+
+    // Marks a target whose track has settled; its radar detections may be
+    // thinned in stage 1.
+    void SetConverged(const std::string &target_id, bool converged);
+
+    // What was shed since the last call, one line; empty when nothing was.
+    std::string TakeReport();
+
+    int stage() const { return stage_; }
+    size_t queue_limit() const { return queue_limit_; }
+
+private:
+    enum Reason
+    {
+        CONFLATED,
+        CONVERGED,
+        OVER_BUDGET,
+        PRIORITY,
+        QUEUE_FULL,
+        REASON_COUNT
+    };
+
+    struct ClassState
+    {
+        SensorClass config;
+        double tokens = 0.0;
+        std::chrono::steady_clock::time_point refilled;
+    };
+
+    ClassState &Class(const std::string &sensor_type);
+    bool TakeToken(ClassState &c);
+    void Shed(const SensorMeasurement &m, Reason reason);
+
+    size_t queue_limit_;
+    uint32_t converged_keep_;
+    int top_priority_ = 0;
+    int stage_ = 0;
+    int peak_stage_ = 0;                                // Since the last report
+
+    std::unordered_map<std::string, ClassState> classes_;
+    std::unordered_map<std::string, size_t> uav_slot_;  // UAV id -> its queued telemetry
+    std::unordered_set<std::string> converged_;
+    std::unordered_map<std::string, uint32_t> converged_seen_;
+    std::map<std::string, metrics::Counter *> shed_counters_; // "type/id/reason"
+    std::map<std::string, uint64_t> shed_since_report_;         // "type reason"
+};
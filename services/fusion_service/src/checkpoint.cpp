@@ -0,0 +1,534 @@
+#include "checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace checkpoint {
+
+namespace
+{
+    constexpr char MAGIC[8] = {'F', 'U', 'S', 'C', 'K', 'P', 'T', '\0'};
+    constexpr uint32_t VERSION = 2;
+
+    // Journal segments start with their own magic and version. Bump the
+    // version with every change to the batch layout (SensorMeasurement).
+    constexpr char JOURNAL_MAGIC[8] = {'F', 'U', 'S', 'J', 'R', 'N', 'L', '\0'};
+    constexpr uint32_t JOURNAL_VERSION = 1;
+
+    struct JournalHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(JournalHeader) == 16, "journal header layout changed");
+
+    constexpr uint32_t FLAG_FILTER = 1u << 0;
+    constexpr uint32_t FLAG_UAV_REPORT = 1u << 1;
+
+    // File layout: Header, `record_count` fixed-size Records, then a blob
+    // area holding external ids and serialized tracks. Everything is
+    // little-endian and 8-byte aligned so the records can be read in place.
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t record_count;
+        uint64_t blob_bytes;
+        uint64_t journal_seq;
+        uint32_t next_id;
+        uint32_t reserved;
+        int64_t created_ms;
+        uint64_t checksum; // FNV-1a over records and blob
+    };
+    static_assert(sizeof(Header) == 64, "checkpoint header layout changed");
+
+    struct Record
+    {
+        uint32_t track_id;
+        uint32_t flags;
+        uint64_t last_fusion_ts; // ns since version 2 (ms before)
+        double state[4];
+        double cov[16];
+        double uav[3];
+        uint64_t external_id_offset;
+        uint32_t external_id_len;
+        uint32_t fused_track_len;
+        uint64_t fused_track_offset;
+    };
+    static_assert(sizeof(Record) == 224, "checkpoint record layout changed");
+
+    uint64_t Fnv1a(const char* data, size_t len, uint64_t h = 1469598103934665603ull)
+    {
+        for (size_t i = 0; i < len; ++i)
+        {
+            h ^= (unsigned char)data[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    std::vector<uint64_t> ListSegments(const std::string& dir)
+    {
+        std::vector<uint64_t> segments;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("journal.", 0) != 0)
+                continue;
+            try
+            {
+                segments.push_back(std::stoull(name.substr(8)));
+            }
+            catch (...)
+            {
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    template <typename T>
+    void Put(std::string& buf, const T& v)
+    {
+        buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    void PutString(std::string& buf, const std::string& s)
+    {
+        Put(buf, (uint32_t)s.size());
+        buf.append(s);
+    }
+
+    template <typename T>
+    bool Get(const char*& p, const char* end, T& v)
+    {
+        if ((size_t)(end - p) < sizeof(v))
+            return false;
+        std::memcpy(&v, p, sizeof(v));
+        p += sizeof(v);
+        return true;
+    }
+
+    bool GetString(const char*& p, const char* end, std::string& s)
+    {
+        uint32_t len;
+        if (!Get(p, end, len) || (size_t)(end - p) < len)
+            return false;
+        s.assign(p, len);
+        p += len;
+        return true;
+    }
+}
+
+// ==================== Load ====================
+
+bool Load(const std::string& path, Snapshot& out, std::string& error)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "no checkpoint";
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(Header))
+    {
+        ::close(fd);
+        error = "truncated";
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        error = "mmap failed";
+        return false;
+    }
+
+    const char* base = static_cast<const char*>(map);
+    const Header* h = reinterpret_cast<const Header*>(base);
+    bool ok = false;
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0)
+        error = "not a checkpoint";
+    else if (h->version != VERSION || h->record_size != sizeof(Record))
+        error = "layout version " + std::to_string(h->version) + " not supported";
+    else if (sizeof(Header) + h->record_count * sizeof(Record) + h->blob_bytes != size)
+        error = "truncated";
+    else if (Fnv1a(base + sizeof(Header), size - sizeof(Header)) != h->checksum)
+        error = "checksum mismatch";
+    else
+        ok = true;
+
+    if (ok)
+    {
+        const Record* records = reinterpret_cast<const Record*>(base + sizeof(Header));
+        const char* blob = base + sizeof(Header) + h->record_count * sizeof(Record);
+        out.journal_seq = h->journal_seq;
+        out.next_id = h->next_id;
+        out.created_ms = h->created_ms;
+        out.tracks.resize(h->record_count);
+        for (size_t i = 0; i < h->record_count && ok; ++i)
+        {
+            const Record& r = records[i];
+            if (r.external_id_offset + r.external_id_len > h->blob_bytes ||
+                r.fused_track_offset + r.fused_track_len > h->blob_bytes)
+            {
+                error = "bad record";
+                ok = false;
+                break;
+            }
+            TrackState& t = out.tracks[i];
+            t.external_id.assign(blob + r.external_id_offset, r.external_id_len);
+            t.track_id = r.track_id;
+            t.has_filter = (r.flags & FLAG_FILTER) != 0;
+            std::memcpy(t.state, r.state, sizeof(t.state));
+            std::memcpy(t.cov, r.cov, sizeof(t.cov));
+            t.last_fusion_ts = r.last_fusion_ts;
+            t.has_uav_report = (r.flags & FLAG_UAV_REPORT) != 0;
+            t.uav_lat = r.uav[0];
+            t.uav_lon = r.uav[1];
+            t.uav_alt = r.uav[2];
+            t.fused_track.assign(blob + r.fused_track_offset, r.fused_track_len);
+        }
+    }
+    ::munmap(map, size);
+    return ok;
+}
+
+// ==================== CheckpointWriter ====================
+
+CheckpointWriter::CheckpointWriter(std::string dir) : dir_(std::move(dir))
+{
+    worker_ = std::thread(&CheckpointWriter::Run, this);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void CheckpointWriter::Submit(std::unique_ptr<Snapshot> snapshot, std::function<void(Snapshot&)> fill)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pending_ = std::move(snapshot); // An unwritten older snapshot is superseded
+        pending_fill_ = std::move(fill);
+    }
+    cv_.notify_one();
+}
+
+void CheckpointWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true)
+    {
+        cv_.wait(lock, [&] { return stop_ || pending_; });
+        if (!pending_)
+            break;
+        std::unique_ptr<Snapshot> snapshot = std::move(pending_);
+        std::function<void(Snapshot&)> fill = std::move(pending_fill_);
+        pending_fill_ = nullptr;
+        lock.unlock();
+
+        if (fill)
+            fill(*snapshot);
+        if (Write(*snapshot))
+        {
+            // Batches before the snapshot are no longer needed for recovery.
+            for (uint64_t seq : ListSegments(dir_))
+            {
+                if (seq < snapshot->journal_seq)
+                    std::remove((dir_ + "/journal." + std::to_string(seq)).c_str());
+            }
+        }
+        lock.lock();
+    }
+}
+
+bool CheckpointWriter::Write(const Snapshot& snapshot)
+{
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<Record> records(snapshot.tracks.size());
+    std::string blob;
+    for (size_t i = 0; i < snapshot.tracks.size(); ++i)
+    {
+        const TrackState& t = snapshot.tracks[i];
+        Record& r = records[i];
+        std::memset(&r, 0, sizeof(r));
+        r.track_id = t.track_id;
+        r.flags = (t.has_filter ? FLAG_FILTER : 0) | (t.has_uav_report ? FLAG_UAV_REPORT : 0);
+        r.last_fusion_ts = t.last_fusion_ts;
+        std::memcpy(r.state, t.state, sizeof(r.state));
+        std::memcpy(r.cov, t.cov, sizeof(r.cov));
+        r.uav[0] = t.uav_lat;
+        r.uav[1] = t.uav_lon;
+        r.uav[2] = t.uav_alt;
+        r.external_id_offset = blob.size();
+        r.external_id_len = (uint32_t)t.external_id.size();
+        blob.append(t.external_id);
+        r.fused_track_offset = blob.size();
+        r.fused_track_len = (uint32_t)t.fused_track.size();
+        blob.append(t.fused_track);
+    }
+    blob.resize((blob.size() + 7) & ~size_t(7), '\0');
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.record_size = sizeof(Record);
+    h.record_count = records.size();
+    h.blob_bytes = blob.size();
+    h.journal_seq = snapshot.journal_seq;
+    h.next_id = snapshot.next_id;
+    h.created_ms = snapshot.created_ms;
+    const char* rec_bytes = reinterpret_cast<const char*>(records.data());
+    size_t rec_len = records.size() * sizeof(Record);
+    h.checksum = Fnv1a(blob.data(), blob.size(), Fnv1a(rec_bytes, rec_len));
+
+    // Write beside the live file and rename over it, so a crash mid-write
+    // leaves the previous checkpoint intact.
+    std::string path = CheckpointWriter::CheckpointPath(dir_);
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "[CHECKPOINT] Cannot write " << tmp << std::endl;
+        return false;
+    }
+    auto write_all = [fd](const char* p, size_t len)
+    {
+        while (len > 0)
+        {
+            ssize_t n = ::write(fd, p, len);
+            if (n <= 0)
+                return false;
+            p += n;
+            len -= (size_t)n;
+        }
+        return true;
+    };
+    bool ok = write_all(reinterpret_cast<const char*>(&h), sizeof(h)) && write_all(rec_bytes, rec_len) &&
+              write_all(blob.data(), blob.size()) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::cerr << "[CHECKPOINT] Failed to write " << path << std::endl;
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    if (ms > 100.0)
+        std::cout << "[CHECKPOINT] Slow checkpoint: " << records.size() << " tracks in " << ms << " ms" << std::endl;
+    return true;
+}
+
+// ==================== Journal ====================
+
+Journal::Journal(std::string dir) : dir_(std::move(dir))
+{
+    worker_ = std::thread(&Journal::Run, this);
+}
+
+Journal::~Journal()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (worker_.joinable())
+        worker_.join();
+    if (file_)
+        std::fclose(file_);
+}
+
+std::string Journal::SegmentPath(uint64_t seq) const
+{
+    return dir_ + "/journal." + std::to_string(seq);
+}
+
+void Journal::Open(uint64_t seq)
+{
+    seq_ = seq;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pending_.push_back(Pending{seq, std::string()});
+    }
+    cv_.notify_one();
+}
+
+void Journal::Run()
+{
+    std::deque<Pending> work;
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true)
+    {
+        cv_.wait(lock, [&] { return stop_ || !pending_.empty(); });
+        if (pending_.empty())
+            break;
+        work.swap(pending_);
+        lock.unlock();
+
+        for (const Pending& p : work)
+        {
+            if (!file_ || file_seq_ != p.seq)
+                OpenFile(p.seq);
+            if (file_ && !p.bytes.empty())
+                std::fwrite(p.bytes.data(), 1, p.bytes.size(), file_);
+        }
+        if (file_)
+            std::fflush(file_);
+        work.clear();
+        lock.lock();
+    }
+}
+
+void Journal::OpenFile(uint64_t seq)
+{
+    if (file_)
+        std::fclose(file_);
+    file_seq_ = seq;
+    file_ = std::fopen(SegmentPath(seq).c_str(), "wb");
+    if (!file_)
+    {
+        std::cerr << "[CHECKPOINT] Cannot open journal " << SegmentPath(seq) << std::endl;
+        return;
+    }
+    JournalHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    h.version = JOURNAL_VERSION;
+    std::fwrite(&h, sizeof(h), 1, file_);
+}
+
+// Segment layout: JournalHeader, then batches. A batch is framed as u32
+// payload bytes and the u64 FNV-1a of the payload. The payload is u32
+// count, then per measurement u64 timestamp, lat/lon/alt doubles,
+// length-prefixed sensor type, sensor id, target id and extras, range rate,
+// range rate sigma, bearing, range, range sigma and bearing sigma doubles,
+// and the i64 clock-corrected time_ns.
+void Journal::Append(const std::deque<SensorMeasurement>& batch)
+{
+    buffer_.assign(sizeof(uint32_t) + sizeof(uint64_t), '\0'); // Frame, filled in below
+    Put(buffer_, (uint32_t)batch.size());
+    for (const SensorMeasurement& m : batch)
+    {
+        Put(buffer_, m.timestamp);
+        Put(buffer_, m.lat);
+        Put(buffer_, m.lon);
+        Put(buffer_, m.alt);
+        PutString(buffer_, m.sensor_type);
+        PutString(buffer_, m.sensor_id);
+        PutString(buffer_, m.target_id);
+        PutString(buffer_, m.extras);
+        Put(buffer_, m.range_rate);
+        Put(buffer_, m.range_rate_sigma);
+        Put(buffer_, m.bearing);
+        Put(buffer_, m.range);
+        Put(buffer_, m.range_sigma);
+        Put(buffer_, m.bearing_sigma);
+        Put(buffer_, m.time_ns);
+    }
+    const size_t frame = sizeof(uint32_t) + sizeof(uint64_t);
+    uint32_t payload_bytes = (uint32_t)(buffer_.size() - frame);
+    uint64_t checksum = Fnv1a(buffer_.data() + frame, payload_bytes);
+    std::memcpy(&buffer_[0], &payload_bytes, sizeof(payload_bytes));
+    std::memcpy(&buffer_[sizeof(payload_bytes)], &checksum, sizeof(checksum));
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (pending_.empty() || pending_.back().seq != seq_)
+            pending_.push_back(Pending{seq_, std::string()});
+        pending_.back().bytes.append(buffer_);
+    }
+    cv_.notify_one();
+}
+
+std::vector<uint64_t> Journal::Segments() const
+{
+    return ListSegments(dir_);
+}
+
+size_t Journal::Replay(uint64_t seq, const std::function<void(std::deque<SensorMeasurement>&)>& apply) const
+{
+    std::FILE* f = std::fopen(SegmentPath(seq).c_str(), "rb");
+    if (!f)
+        return 0;
+    std::string data;
+    char chunk[65536];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.append(chunk, n);
+    std::fclose(f);
+
+    // Segments from another layout would replay as garbage measurements.
+    JournalHeader h;
+    if (data.size() < sizeof(h))
+        return 0;
+    std::memcpy(&h, data.data(), sizeof(h));
+    if (std::memcmp(h.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || h.version != JOURNAL_VERSION)
+    {
+        std::cerr << "[CHECKPOINT] Skipping " << SegmentPath(seq) << ": not a journal of layout version "
+                  << JOURNAL_VERSION << std::endl;
+        return 0;
+    }
+
+    size_t batches = 0;
+    const char* p = data.data() + sizeof(h);
+    const char* end = data.data() + data.size();
+    std::deque<SensorMeasurement> batch;
+    uint32_t payload_bytes;
+    uint64_t checksum;
+    uint32_t count;
+    while (Get(p, end, payload_bytes) && Get(p, end, checksum))
+    {
+        // A torn or corrupt batch ends the segment.
+        if ((size_t)(end - p) < payload_bytes || Fnv1a(p, payload_bytes) != checksum)
+            break;
+        const char* batch_end = p + payload_bytes;
+        if (!Get(p, batch_end, count))
+            break;
+        batch.clear();
+        bool complete = true;
+        for (uint32_t i = 0; i < count && complete; ++i)
+        {
+            SensorMeasurement m;
+            complete = Get(p, batch_end, m.timestamp) && Get(p, batch_end, m.lat) && Get(p, batch_end, m.lon) &&
+                       Get(p, batch_end, m.alt) && GetString(p, batch_end, m.sensor_type) &&
+                       GetString(p, batch_end, m.sensor_id) && GetString(p, batch_end, m.target_id) &&
+                       GetString(p, batch_end, m.extras) && Get(p, batch_end, m.range_rate) &&
+                       Get(p, batch_end, m.range_rate_sigma) && Get(p, batch_end, m.bearing) &&
+                       Get(p, batch_end, m.range) && Get(p, batch_end, m.range_sigma) &&
+                       Get(p, batch_end, m.bearing_sigma) && Get(p, batch_end, m.time_ns);
+            if (complete)
+                batch.push_back(std::move(m));
+        }
+        if (!complete || p != batch_end)
+            break;
+        apply(batch);
+        ++batches;
+    }
+    return batches;
+}
+
+} // namespace checkpoint
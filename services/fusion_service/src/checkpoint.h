@@ -0,0 +1,137 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sensor_measurement.h"
+
+// Crash recovery for the fusion state.
+//
+// The fusion thread periodically takes raw copies of its state and hands
+// them to CheckpointWriter, whose thread turns them into a Snapshot (plain
+// values), lays it out as a flat, versioned file and swaps it in with
+// rename(). Every batch fused after a snapshot is appended to a journal
+// segment by the journal's own thread, so a restart loads the checkpoint
+// with mmap and replays the batches that followed it.
+namespace checkpoint {
+
+// One entry of the external id map, with whatever state its track has.
+struct TrackState
+{
+    std::string external_id;
+    uint32_t track_id = 0;
+
+    bool has_filter = false;
+    double state[4] = {};     // [lat, lon, v_lat, v_lon]
+    double cov[16] = {};      // Row-major 4x4
+    uint64_t last_fusion_ts = 0; // ns, fusion clock
+
+    bool has_uav_report = false;
+    double uav_lat = 0.0, uav_lon = 0.0, uav_alt = 0.0;
+
+    std::string fused_track;  // Serialized fusion::FusedTrack; empty until published
+};
+
+struct Snapshot
+{
+    uint64_t journal_seq = 0; // First journal segment not covered by this snapshot
+    uint32_t next_id = 1;
+    int64_t created_ms = 0;
+    std::vector<TrackState> tracks;
+};
+
+// Reads a checkpoint file. Returns false (with a reason) when it is
+// missing, truncated, from another layout version or fails its checksum.
+bool Load(const std::string& path, Snapshot& out, std::string& error);
+
+// Writes snapshots on a background thread. Only the newest pending snapshot
+// is written; after it is durable, journal segments it covers are deleted.
+class CheckpointWriter
+{
+public:
+    explicit CheckpointWriter(std::string dir);
+    ~CheckpointWriter();
+
+    // Queues a snapshot. `fill`, when set, runs on the writer thread before
+    // the snapshot is written, so the caller can hand over raw copies of its
+    // state and leave unpacking and serialization to that thread.
+    void Submit(std::unique_ptr<Snapshot> snapshot, std::function<void(Snapshot&)> fill = nullptr);
+
+    static std::string CheckpointPath(const std::string& dir) { return dir + "/fusion.ckpt"; }
+
+private:
+    void Run();
+    bool Write(const Snapshot& snapshot);
+
+    std::string dir_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::unique_ptr<Snapshot> pending_; // Guarded by mtx_
+    std::function<void(Snapshot&)> pending_fill_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+// Append-only log of fused batches, split into numbered segments
+// (<dir>/journal.<seq>), each with a versioned header and checksummed
+// batches. The caller (the fusion thread) only encodes batches; a
+// background thread writes them. Use from one thread at a time.
+class Journal
+{
+public:
+    explicit Journal(std::string dir);
+    ~Journal(); // Writes whatever is still queued
+
+    // Starts segment `seq`: batches appended from now on go there.
+    void Open(uint64_t seq);
+    uint64_t seq() const { return seq_; }
+
+    // Encodes one batch and queues it. The journal thread writes queued
+    // batches and hands them to the OS, so a process crash (not a power
+    // loss) loses at most the batches still in the queue.
+    void Append(const std::deque<SensorMeasurement>& batch);
+
+    // Segment numbers present in the directory, ascending.
+    std::vector<uint64_t> Segments() const;
+
+    // Calls `apply` for every complete batch of segment `seq`; replay stops
+    // at a torn or corrupt batch, and a segment of another layout version is
+    // skipped whole. Returns the number of batches.
+    size_t Replay(uint64_t seq, const std::function<void(std::deque<SensorMeasurement>&)>& apply) const;
+
+    std::string SegmentPath(uint64_t seq) const;
+
+private:
+    // Encoded batches for one segment. An empty one only starts the segment.
+    struct Pending
+    {
+        uint64_t seq;
+        std::string bytes;
+    };
+
+    void Run();
+    void OpenFile(uint64_t seq);
+
+    std::string dir_;
+    uint64_t seq_ = 0;
+    std::string buffer_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<Pending> pending_; // Guarded by mtx_
+    bool stop_ = false;
+
+    std::FILE* file_ = nullptr;   // Journal thread only
+    uint64_t file_seq_ = 0;
+    std::thread worker_;
+};
+
+} // namespace checkpoint
@@ -0,0 +1,127 @@
+#include "clock_sync.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "config.h"
+#include "metrics/fusion_metrics.h"
+
+namespace
+{
+    constexpr double MAX_SKEW = 1e-3;                 // 1000 ppm; crystal clocks are within ~100
+    constexpr int64_t JUMP_NS = 5'000'000'000;        // Delay change that means the clock was reset
+}
+
+ClockSync::ClockSync()
+    : window_ns_((int64_t)(std::max(utils::GetEnvDouble("CLOCK_SYNC_WINDOW_MS", 1000), 1.0) * 1e6)),
+      windows_((size_t)std::max(utils::GetEnvDouble("CLOCK_SYNC_WINDOWS", 16), 2.0))
+{
+}
+
+int64_t ClockSync::Now()
+{
+    using namespace std::chrono;
+    static const int64_t shift = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() -
+                                 duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() + shift;
+}
+
+void ClockSync::Correct(std::deque<SensorMeasurement> &batch)
+{
+    for (SensorMeasurement &m : batch)
+    {
+        if (m.sensor_ns == 0 || m.received_ns == 0)
+        {
+            m.time_ns = (int64_t)m.timestamp * 1'000'000;
+            continue;
+        }
+        std::string key = m.sensor_type + "/" + m.sensor_id;
+        auto it = streams_.find(key);
+        if (it == streams_.end())
+        {
+            it = streams_.emplace(key, Stream{}).first;
+            it->second.offset_us = &metrics::FusionMetrics::ClockOffset(m.sensor_type, m.sensor_id);
+            it->second.skew_ppb = &metrics::FusionMetrics::ClockSkew(m.sensor_type, m.sensor_id);
+        }
+        m.time_ns = ToFusionTime(key, it->second, m.sensor_ns, m.received_ns);
+    }
+}
+
+int64_t ClockSync::ToFusionTime(const std::string &key, Stream &s, int64_t sensor_ns, int64_t received_ns)
+{
+    int64_t delay = received_ns - sensor_ns;
+    if (s.open)
+    {
+        int64_t jump = delay - Delay(s, sensor_ns);
+        if (std::abs(jump) > JUMP_NS)
+        {
+            std::cout << "[FUSION] Clock sync: " << key << " clock jumped by " << (double)jump / 1e9
+                      << " s, re-estimating" << std::endl;
+            s.minima.clear();
+            s.open = false;
+        }
+    }
+
+    if (!s.open || sensor_ns - s.window_start >= window_ns_)
+    {
+        if (s.open)
+        {
+            s.minima.emplace_back(s.window_min_at, s.window_min);
+            if (s.minima.size() > windows_)
+                s.minima.pop_front();
+            Fit(s);
+        }
+        s.open = true;
+        s.window_start = sensor_ns;
+        s.window_min = delay;
+        s.window_min_at = sensor_ns;
+    }
+    else if (delay < s.window_min)
+    {
+        s.window_min = delay;
+        s.window_min_at = sensor_ns;
+    }
+
+    return std::min(sensor_ns + Delay(s, sensor_ns), received_ns);
+}
+
+int64_t ClockSync::Delay(const Stream &s, int64_t sensor_ns)
+{
+    // Until the first window closes, its running minimum is the offset.
+    if (s.minima.empty())
+        return s.window_min;
+    return s.offset + (int64_t)std::llround(s.skew * (double)(sensor_ns - s.ref));
+}
+
+void ClockSync::Fit(Stream &s)
+{
+    // Least squares through the window minima, centred on their mean.
+    // Relative to the first minimum so the sums keep ns precision.
+    const auto &first = s.minima.front();
+    double n = (double)s.minima.size();
+    double mean_t = 0.0, mean_d = 0.0;
+    for (const auto &p : s.minima)
+    {
+        mean_t += (double)(p.first - first.first);
+        mean_d += (double)(p.second - first.second);
+    }
+    mean_t /= n;
+    mean_d /= n;
+
+    double sxx = 0.0, sxy = 0.0;
+    for (const auto &p : s.minima)
+    {
+        double x = (double)(p.first - first.first) - mean_t;
+        sxx += x * x;
+        sxy += x * ((double)(p.second - first.second) - mean_d);
+    }
+    s.ref = first.first + (int64_t)std::llround(mean_t);
+    s.offset = first.second + (int64_t)std::llround(mean_d);
+    s.skew = sxx > 0.0 ? std::min(std::max(sxy / sxx, -MAX_SKEW), MAX_SKEW) : 0.0;
+
+    s.offset_us->Set(Delay(s, s.minima.back().first) / 1000);
+    s.skew_ppb->Set((int64_t)std::llround(s.skew * 1e9));
+}
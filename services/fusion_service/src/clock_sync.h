@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "sensor_measurement.h"
+
+namespace metrics
+{
+    class Gauge;
+}
+
+// Per-stream clock offset and skew estimation.
+//
+// Sensors stamp measurements with their own monotonic clock
+// (Header.timestamp_ns), which shares no epoch with fusion and drifts
+// against it. For every stream (sensor type + id) the observed delay
+// received - sent is the clock offset plus the transport latency. Its
+// minimum over each window is the sample least disturbed by queueing; a
+// least-squares line through the last `windows` minima gives the offset and
+// the skew, and the sensor time is mapped onto the fusion clock with it.
+// The estimate therefore includes the stream's minimum transport delay, and
+// a corrected time is never later than the measurement's arrival.
+//
+// Measurements without a sensor clock keep their millisecond timestamp.
+//
+// Not thread-safe: the fusion loop calls it once per batch.
+class ClockSync
+{
+public:
+    // CLOCK_SYNC_WINDOW_MS (default 1000) and CLOCK_SYNC_WINDOWS (default 16).
+    ClockSync();
+
+    // The fusion clock: steady_clock, shifted once onto the epoch so it is
+    // comparable to the millisecond wall-clock timestamps. ns.
+    static int64_t Now();
+
+    // Sets time_ns for every measurement in the batch.
+    void Correct(std::deque<SensorMeasurement> &batch);
+
+private:
+    struct Stream
+    {
+        std::deque<std::pair<int64_t, int64_t>> minima; // (sensor ns, delay ns) per closed window
+        int64_t window_start = 0;
+        int64_t window_min = 0;
+        int64_t window_min_at = 0;
+        bool open = false;
+
+        // delay(t) = offset + skew * (t - ref)
+        int64_t ref = 0;
+        int64_t offset = 0;
+        double skew = 0.0;
+
+        metrics::Gauge *offset_us = nullptr;
+        metrics::Gauge *skew_ppb = nullptr;
+    };
+
+    int64_t ToFusionTime(const std::string &key, Stream &s, int64_t sensor_ns, int64_t received_ns);
+    static int64_t Delay(const Stream &s, int64_t sensor_ns);
+    static void Fit(Stream &s);
+
+    int64_t window_ns_;
+    size_t windows_;
+    std::unordered_map<std::string, Stream> streams_; // "type/id"
+};
@@ -0,0 +1,199 @@
+#include "fixed_lag_smoother.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr int N = 4;
+
+    // out = a * b (4x4, row-major)
+    void MatMul(const double *a, const double *b, double *out)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j < N; ++j)
+            {
+                double s = 0.0;
+                for (int k = 0; k < N; ++k)
+                    s += a[i * N + k] * b[k * N + j];
+                out[i * N + j] = s;
+            }
+        }
+    }
+
+    // out = a * b' (4x4, row-major)
+    void MatMulT(const double *a, const double *b, double *out)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j < N; ++j)
+            {
+                double s = 0.0;
+                for (int k = 0; k < N; ++k)
+                    s += a[i * N + k] * b[j * N + k];
+                out[i * N + j] = s;
+            }
+        }
+    }
+
+    // Gauss-Jordan with partial pivoting. False when `a` is singular.
+    bool Invert(const double *a, double *out)
+    {
+        double m[N * N];
+        std::memcpy(m, a, sizeof(m));
+        for (int i = 0; i < N * N; ++i)
+            out[i] = (i % (N + 1) == 0) ? 1.0 : 0.0;
+
+        for (int c = 0; c < N; ++c)
+        {
+            int p = c;
+            for (int r = c + 1; r < N; ++r)
+            {
+                if (std::abs(m[r * N + c]) > std::abs(m[p * N + c]))
+                    p = r;
+            }
+            if (m[p * N + c] == 0.0)
+                return false;
+            for (int k = 0; k < N; ++k)
+            {
+                std::swap(m[c * N + k], m[p * N + k]);
+                std::swap(out[c * N + k], out[p * N + k]);
+            }
+            double inv = 1.0 / m[c * N + c];
+            for (int k = 0; k < N; ++k)
+            {
+                m[c * N + k] *= inv;
+                out[c * N + k] *= inv;
+            }
+            for (int r = 0; r < N; ++r)
+            {
+                if (r == c)
+                    continue;
+                double f = m[r * N + c];
+                for (int k = 0; k < N; ++k)
+                {
+                    m[r * N + k] -= f * m[c * N + k];
+                    out[r * N + k] -= f * out[c * N + k];
+                }
+            }
+        }
+        return true;
+    }
+}
+
+FixedLagSmoother::FixedLagSmoother(size_t lag, size_t budget_bytes)
+    : capacity_(std::max<size_t>(lag, 1) + 1)
+{
+    max_tracks_ = std::max<size_t>(budget_bytes / BytesPerTrack(), 1);
+}
+
+void FixedLagSmoother::EvictOldest()
+{
+    uint32_t victim = lru_.back();
+    lru_.pop_back();
+    rings_.erase(victim);
+}
+
+void FixedLagSmoother::Remove(uint32_t track_id)
+{
+    auto it = rings_.find(track_id);
+    if (it == rings_.end())
+        return;
+    lru_.erase(it->second.lru_pos);
+    rings_.erase(it);
+}
+
+bool FixedLagSmoother::Push(uint32_t track_id, int64_t timestamp_ms, double dt,
+                            const double prior_state[4], const double prior_cov[16],
+                            const double post_state[4], const double post_cov[16], Estimate &out)
+{
+    auto it = rings_.find(track_id);
+    if (it == rings_.end())
+    {
+        if (rings_.size() >= max_tracks_)
+            EvictOldest();
+        it = rings_.emplace(track_id, Ring{}).first;
+        it->second.slots.resize(capacity_);
+        lru_.push_front(track_id);
+        it->second.lru_pos = lru_.begin();
+    }
+    else
+    {
+        lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+    }
+    Ring &ring = it->second;
+
+    // Gain of the current newest cycle k towards this one:
+    // C_k = P_k|k F' inv(P_k+1|k), with F the constant-velocity transition.
+    if (ring.count > 0)
+    {
+        Cycle &prev = ring.slots[(ring.start + ring.count - 1) % capacity_];
+        double pft[16], pp_inv[16];
+        for (int i = 0; i < N; ++i)
+        {
+            const double *p = prev.P + i * N;
+            pft[i * N + 0] = p[0] + dt * p[2];
+            pft[i * N + 1] = p[1] + dt * p[3];
+            pft[i * N + 2] = p[2];
+            pft[i * N + 3] = p[3];
+        }
+        if (Invert(prior_cov, pp_inv))
+            MatMul(pft, pp_inv, prev.C);
+        else
+            std::fill(prev.C, prev.C + 16, 0.0);
+    }
+
+    uint32_t slot;
+    if (ring.count < capacity_)
+    {
+        slot = (ring.start + ring.count) % capacity_;
+        ++ring.count;
+    }
+    else
+    {
+        slot = ring.start;
+        ring.start = (ring.start + 1) % capacity_;
+    }
+    Cycle &c = ring.slots[slot];
+    c.timestamp_ms = timestamp_ms;
+    std::memcpy(c.x, post_state, sizeof(c.x));
+    std::memcpy(c.P, post_cov, sizeof(c.P));
+    std::memcpy(c.xp, prior_state, sizeof(c.xp));
+    std::memcpy(c.Pp, prior_cov, sizeof(c.Pp));
+
+    if (ring.count < capacity_)
+        return false;
+
+    // Backward pass from the newest cycle down to the oldest:
+    //   xs_k = x_k|k + C_k (xs_k+1 - x_k+1|k)
+    //   Ps_k = P_k|k + C_k (Ps_k+1 - P_k+1|k) C_k'
+    std::memcpy(xs_, c.x, sizeof(xs_));
+    std::memcpy(Ps_, c.P, sizeof(Ps_));
+    double d[4], D[16], cd[16];
+    for (size_t k = capacity_ - 1; k-- > 0;)
+    {
+        const Cycle &e = ring.slots[(ring.start + k) % capacity_];
+        const Cycle &next = ring.slots[(ring.start + k + 1) % capacity_];
+        for (int i = 0; i < N; ++i)
+            d[i] = xs_[i] - next.xp[i];
+        for (int i = 0; i < N * N; ++i)
+            D[i] = Ps_[i] - next.Pp[i];
+        for (int i = 0; i < N; ++i)
+        {
+            double s = 0.0;
+            for (int j = 0; j < N; ++j)
+                s += e.C[i * N + j] * d[j];
+            xs_[i] = e.x[i] + s;
+        }
+        MatMul(e.C, D, cd);
+        MatMulT(cd, e.C, Ps_);
+        for (int i = 0; i < N * N; ++i)
+            Ps_[i] += e.P[i];
+    }
+
+    out.timestamp_ms = ring.slots[ring.start].timestamp_ms;
+    std::memcpy(out.state, xs_, sizeof(out.state));
+    std::memcpy(out.cov, Ps_, sizeof(out.cov));
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Fixed-lag Rauch-Tung-Striebel smoother over the Kalman filter output.
+//
+// Each track keeps a ring of its last lag + 1 filter cycles: the predicted
+// and filtered state/covariance of the cycle and the smoother gain towards
+// the next one. The gain only depends on filter quantities, so it is
+// computed once when the next cycle arrives; each Push then runs the
+// backward pass over the ring (O(lag)) and returns the estimate `lag`
+// cycles back, conditioned on everything up to the newest cycle.
+//
+// States and covariances are the filter's raw [lat, lon, v_lat, v_lon]
+// layout (see KalmanFilter::ExportState). The store stays inside a fixed
+// memory budget; when it is exhausted the least recently updated track
+// loses its window and starts over.
+// Not thread-safe: fusion thread only.
+class FixedLagSmoother {
+public:
+    struct Estimate {
+        int64_t timestamp_ms;
+        double state[4];
+        double cov[16];
+    };
+
+    FixedLagSmoother(size_t lag, size_t budget_bytes);
+
+    // Records one filter cycle of a track: the predict interval, the state
+    // and covariance right after the predict (prior) and after the cycle's
+    // updates (posterior). Returns true and fills `out` once the track has
+    // lag + 1 cycles.
+    bool Push(uint32_t track_id, int64_t timestamp_ms, double dt,
+              const double prior_state[4], const double prior_cov[16],
+              const double post_state[4], const double post_cov[16], Estimate& out);
+
+    void Remove(uint32_t track_id);
+
+    size_t lag() const { return capacity_ - 1; }
+    size_t TrackCount() const { return rings_.size(); }
+    size_t MemoryBytes() const { return rings_.size() * BytesPerTrack(); }
+
+private:
+    struct Cycle {
+        int64_t timestamp_ms;
+        double x[4], P[16];     // Filtered
+        double xp[4], Pp[16];   // Predicted, before this cycle's updates
+        double C[16];           // Gain towards the next cycle, once it exists
+    };
+
+    struct Ring {
+        uint32_t start = 0;     // Slot of the oldest cycle
+        uint32_t count = 0;
+        std::vector<Cycle> slots;
+        std::list<uint32_t>::iterator lru_pos;
+    };
+
+    size_t BytesPerTrack() const { return capacity_ * sizeof(Cycle) + sizeof(Ring); }
+    void EvictOldest();
+
+    size_t capacity_;
+    size_t max_tracks_;
+    std::unordered_map<uint32_t, Ring> rings_;
+    std::list<uint32_t> lru_; // Front = most recently updated
+
+    // Backward pass scratch
+    double xs_[4], Ps_[16];
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "track_table.h"
+#include "fusion/fusion.pb.h"
+
+// Recycles a published track for the next one. Clear() alone would delete
+// the position and covariance sub-messages (no arena), which every
+// published track sets again right away; they are detached, cleared and
+// put back instead, so a reused track allocates nothing.
+struct FusedTrackRecycler {
+    void operator()(fusion::FusedTrack& t) const
+    {
+        common::GeoPoint* position = t.release_position();
+        fusion::Covariance2D* covariance = t.release_covariance();
+        t.Clear();
+        if (position)
+        {
+            position->Clear();
+            t.set_allocated_position(position);
+        }
+        if (covariance)
+        {
+            covariance->Clear();
+            t.set_allocated_covariance(covariance);
+        }
+    }
+};
+
+// Published fused (and smoothed) tracks by track id.
+using FusedTrackTable = TrackTable<fusion::FusedTrack, FusedTrackRecycler>;
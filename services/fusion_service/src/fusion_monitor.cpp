@@ -1,34 +1,346 @@
 #include "fusion_monitor.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
+#include "geo_utils.h"
+#include "metrics/fusion_metrics.h"
+#include "tracing/trace.h"
+
+namespace
+{
+    // Keeps the subscriber gauge in step with open SubscribeFusedTracks calls.
+    struct SubscriberGuard
+    {
+        SubscriberGuard() { metrics::FusionMetrics::Get().monitor_subscribers.Add(1); }
+        ~SubscriberGuard() { metrics::FusionMetrics::Get().monitor_subscribers.Add(-1); }
+    };
+
+    bool InRegion(const fusion::GeoRegion& b, double lat, double lon)
+    {
+        bool in_lon = (b.min_lon() <= b.max_lon()) ? (lon >= b.min_lon() && lon <= b.max_lon())
+                                                   : (lon >= b.min_lon() || lon <= b.max_lon());
+        return in_lon && lat >= b.min_lat() && lat <= b.max_lat();
+    }
+
+    bool InRadius(const fusion::GeoRadius& r, double lat, double lon)
+    {
+        return geo_utils::CalculateHaversine(r.center().lat(), r.center().lon(), lat, lon) <= r.radius_m();
+    }
+}
+
+// One SubscribeFusedTracks call. At most one write is in flight; frames
+// offered meanwhile replace each other, so only the newest is sent next.
+// Deletes itself when gRPC is done with the call.
+class FusionMonitorServiceImpl::Subscriber final : public grpc::ServerWriteReactor<grpc::ByteBuffer> {
+public:
+    Subscriber(FusionMonitorServiceImpl* service, std::string key) : service_(service), key_(std::move(key)) {}
+
+    // Queues a picture published at `seq`; older pictures than the last one
+    // offered are ignored.
+    void Offer(Frame frame, uint64_t seq)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (finished_ || (has_seq_ && seq <= last_seq_))
+            return;
+        has_seq_ = true;
+        last_seq_ = seq;
+        if (writing_) {
+            if (pending_)
+                metrics::FusionMetrics::Get().monitor_frames_conflated.Inc();
+            pending_ = std::move(frame);
+            return;
+        }
+        writing_ = std::move(frame);
+        StartWrite(writing_.get());
+    }
+
+    // Single snapshot: write it and end the call.
+    void WriteOnce(Frame frame)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        finished_ = true;
+        writing_ = std::move(frame);
+        StartWriteAndFinish(writing_.get(), grpc::WriteOptions(), grpc::Status::OK);
+    }
+
+    void Fail(const grpc::Status& status)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        finished_ = true;
+        Finish(status);
+    }
+
+    void OnWriteDone(bool ok) override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        writing_.reset();
+        if (!ok || cancelled_) {
+            FinishLocked();
+            return;
+        }
+        if (pending_ && !finished_) {
+            writing_ = std::move(pending_);
+            StartWrite(writing_.get());
+        }
+    }
+
+    void OnCancel() override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        cancelled_ = true;
+        if (!writing_)
+            FinishLocked();
+    }
+
+    void OnDone() override
+    {
+        if (!key_.empty())
+            service_->Unregister(key_, this);
+        delete this;
+    }
+
+private:
+    void FinishLocked()
+    {
+        if (finished_)
+            return;
+        finished_ = true;
+        pending_.reset();
+        Finish(grpc::Status::OK);
+    }
+
+    FusionMonitorServiceImpl* service_;
+    std::string key_;           // Group key; empty for single snapshots
+    SubscriberGuard guard_;
+
+    std::mutex mtx_;
+    Frame writing_;             // Kept alive until OnWriteDone
+    Frame pending_;
+    uint64_t last_seq_ = 0;
+    bool has_seq_ = false;
+    bool cancelled_ = false;
+    bool finished_ = false;
+};
+
 // Constructor: stores references to the shared mutex and track map.
 FusionMonitorServiceImpl::FusionMonitorServiceImpl(
     std::mutex& track_mtx,
-    std::unordered_map<uint32_t, fusion::FusedTrack>& tracks)
-    : mtx_(track_mtx), fused_tracks_(tracks)
-{}
-// GetFusedTracks RPC implementation
-// Returns the current list of fused tracks to the client.
-grpc::Status FusionMonitorServiceImpl::SubscribeFusedTracks(
-    grpc::ServerContext* context,
-    const fusion::MonitorRequest* request,
-    grpc::ServerWriter<fusion::MonitorResponse>* writer)
-{
-    // For simplicity we send a single MonitorResponse containing the current
-    // fused tracks and then return; a real streaming implementation could
-    // push updates periodically or on-change.
-    fusion::MonitorResponse resp;
+    FusedTrackTable& tracks,
+    FusedTrackTable& smoothed_tracks,
+    std::condition_variable& publish_cv,
+    uint64_t& publish_seq,
+    const SpatialIndex& spatial_index,
+    const TrackHistoryStore& track_history)
+    : mtx_(track_mtx), fused_tracks_(tracks), smoothed_tracks_(smoothed_tracks), publish_cv_(publish_cv), publish_seq_(publish_seq),
+      spatial_index_(spatial_index), track_history_(track_history)
+{
+    broadcast_thread_ = std::thread(&FusionMonitorServiceImpl::BroadcastLoop, this);
+}
+
+FusionMonitorServiceImpl::~FusionMonitorServiceImpl()
+{
+    running_ = false;
+    publish_cv_.notify_all();
+    if (broadcast_thread_.joinable())
+        broadcast_thread_.join();
+}
+
+void FusionMonitorServiceImpl::AddTrack(const fusion::MonitorRequest& request,
+                                        const fusion::FusedTrack& track,
+                                        fusion::MonitorResponse& resp)
+{
+    fusion::FusedTrack* out = resp.add_tracks();
+    *out = track;
+    if (!request.include_history())
+        return;
+
+    int64_t since = 0;
+    if (request.history_seconds() > 0)
+        since = track.measurement_ts() - (int64_t)(request.history_seconds() * 1000.0);
+
+    history_.clear();
+    track_history_.Read(track.track_id(), since, history_);
+    out->mutable_history()->Reserve((int)history_.size());
+    for (const auto& s : history_) {
+        fusion::TrackPoint* p = out->add_history();
+        p->set_timestamp(s.timestamp_ms);
+        p->mutable_position()->set_lat(s.lat);
+        p->mutable_position()->set_lon(s.lon);
+        p->mutable_position()->set_alt(s.alt);
+    }
+}
+
+void FusionMonitorServiceImpl::FillResponse(const fusion::MonitorRequest& request,
+                                            fusion::MonitorResponse& resp)
+{
+    const auto& tracks = request.smoothed() ? smoothed_tracks_ : fused_tracks_;
+    if (!request.has_region() && !request.has_radius()) {
+        tracks.ForEach([&](uint32_t, const fusion::FusedTrack& t) { AddTrack(request, t, resp); });
+        return;
+    }
+
+    // Candidates come from the index; with both filters the radius query
+    // narrows the set and the box is checked on each candidate. The index
+    // holds filtered positions, so a smoothed track, which lags its filtered
+    // one, is checked again at its own position.
+    query_ids_.clear();
+    if (request.has_radius()) {
+        const auto& r = request.radius();
+        spatial_index_.QueryRadius(r.center().lat(), r.center().lon(), r.radius_m(), query_ids_);
+    } else {
+        const auto& b = request.region();
+        spatial_index_.QueryBox(b.min_lat(), b.min_lon(), b.max_lat(), b.max_lon(), query_ids_);
+    }
 
+    for (uint32_t id : query_ids_) {
+        const fusion::FusedTrack* t = tracks.Find(id);
+        if (!t)
+            continue;
+        const double lat = t->position().lat(), lon = t->position().lon();
+        if (request.smoothed() && request.has_radius() && !InRadius(request.radius(), lat, lon))
+            continue;
+        if ((request.smoothed() || request.has_radius()) && request.has_region() &&
+            !InRegion(request.region(), lat, lon))
+            continue;
+        AddTrack(request, *t, resp);
+    }
+}
+FusionMonitorServiceImpl::Frame FusionMonitorServiceImpl::Snapshot(const fusion::MonitorRequest& request,
+                                                                   uint64_t& seq)
+{
+    fusion::MonitorResponse resp;
     {
-        std::lock_guard<std::mutex> lock(mtx_);
-        for (const auto& kv : fused_tracks_) {
-            fusion::FusedTrack* track = resp.add_tracks();
-            *track = kv.second;
+        TRACE_SCOPE("SubscribeFusedTracks.snapshot");
+        std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+        {
+            TRACE_SCOPE("SubscribeFusedTracks.wait_mtx");
+            lock.lock();
         }
+        FillResponse(request, resp);
+        seq = publish_seq_;
     }
 
-    // Send one response over the stream.
-    writer->Write(resp);
+    TRACE_SCOPE("SubscribeFusedTracks.serialize");
+    auto buffer = std::make_shared<grpc::ByteBuffer>();
+    bool own_buffer;
+    grpc::SerializationTraits<fusion::MonitorResponse>::Serialize(resp, buffer.get(), &own_buffer);
+    metrics::FusionMetrics::Get().monitor_frames.Inc();
+    return buffer;
+}
 
-    return grpc::Status::OK;
-}
\ No newline at end of file
+void FusionMonitorServiceImpl::Register(const std::string& key, const fusion::MonitorRequest& request,
+                                        Subscriber* s)
+{
+    std::lock_guard<std::mutex> lock(groups_mtx_);
+    Group& g = groups_[key];
+    if (g.members.empty())
+        g.request = request;
+    g.members.push_back(s);
+}
+
+void FusionMonitorServiceImpl::Unregister(const std::string& key, Subscriber* s)
+{
+    std::lock_guard<std::mutex> lock(groups_mtx_);
+    auto it = groups_.find(key);
+    if (it == groups_.end())
+        return;
+    auto& members = it->second.members;
+    members.erase(std::remove(members.begin(), members.end(), s), members.end());
+    if (members.empty())
+        groups_.erase(it);
+}
+
+// SubscribeFusedTracks RPC implementation
+grpc::ServerWriteReactor<grpc::ByteBuffer>* FusionMonitorServiceImpl::SubscribeFusedTracks(
+    grpc::CallbackServerContext* context,
+    const grpc::ByteBuffer* request_buffer)
+{
+    // By default we send a single MonitorResponse containing the current
+    // fused tracks and then return. Continuous subscribers get the picture
+    // pushed again after every fusion cycle until they cancel.
+    fusion::MonitorRequest request;
+    grpc::ByteBuffer copy(*request_buffer);
+    if (!grpc::SerializationTraits<fusion::MonitorRequest>::Deserialize(&copy, &request).ok()) {
+        auto* s = new Subscriber(this, "");
+        s->Fail(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed MonitorRequest"));
+        return s;
+    }
+
+    uint64_t seq = 0;
+    if (!request.continuous()) {
+        auto* s = new Subscriber(this, "");
+        s->WriteOnce(Snapshot(request, seq));
+        return s;
+    }
+
+    // Registered before the first snapshot, so no cycle published in
+    // between is missed; Offer drops whichever of the two is older.
+    std::string key = request.SerializeAsString();
+    auto* s = new Subscriber(this, key);
+    Register(key, request, s);
+    Frame first = Snapshot(request, seq);
+    s->Offer(std::move(first), seq);
+    return s;
+}
+
+void FusionMonitorServiceImpl::BroadcastLoop()
+{
+    TRACE_THREAD_NAME("monitor_broadcast");
+    uint64_t seen_seq = 0;
+    std::vector<std::pair<std::string, fusion::MonitorRequest>> requests;
+    std::vector<fusion::MonitorResponse> responses;
+    std::vector<Frame> frames;
+
+    while (running_)
+    {
+        // One fill per distinct request, all from the same published cycle.
+        uint64_t seq;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            // Wake up periodically to notice shutdown.
+            if (!publish_cv_.wait_for(lock, std::chrono::milliseconds(500),
+                                      [&] { return publish_seq_ != seen_seq || !running_; }))
+                continue;
+            seen_seq = seq = publish_seq_;
+
+            // Groups are read under mtx_: a subscriber registering later
+            // takes its first snapshot after this cycle.
+            requests.clear();
+            {
+                std::lock_guard<std::mutex> groups_lock(groups_mtx_);
+                for (const auto& kv : groups_)
+                    requests.emplace_back(kv.first, kv.second.request);
+            }
+            if (requests.empty())
+                continue;
+            TRACE_SCOPE("MonitorBroadcast.snapshot");
+            responses.assign(requests.size(), fusion::MonitorResponse());
+            for (size_t i = 0; i < requests.size(); ++i)
+                FillResponse(requests[i].second, responses[i]);
+        }
+
+        // Serialized once per request, outside the track lock.
+        frames.clear();
+        {
+            TRACE_SCOPE("MonitorBroadcast.serialize");
+            for (const auto& resp : responses) {
+                auto buffer = std::make_shared<grpc::ByteBuffer>();
+                bool own_buffer;
+                grpc::SerializationTraits<fusion::MonitorResponse>::Serialize(resp, buffer.get(), &own_buffer);
+                frames.push_back(std::move(buffer));
+            }
+            metrics::FusionMetrics::Get().monitor_frames.Inc(frames.size());
+        }
+
+        TRACE_SCOPE("MonitorBroadcast.fanout");
+        std::lock_guard<std::mutex> lock(groups_mtx_);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            auto it = groups_.find(requests[i].first);
+            if (it == groups_.end())
+                continue;
+            for (Subscriber* s : it->second.members)
+                s->Offer(frames[i], seq);
+        }
+    }
+}
@@ -1,30 +1,101 @@
 #pragma once
 
 #include <grpcpp/grpcpp.h>
+#include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "fusion/fusion.grpc.pb.h"
+#include "spatial_index.h"
+#include "track_history.h"
+#include "fused_track_table.h"
 
 // Uses the FusedTrack map and mutex defined in the Fusion Service.
-class FusionMonitorServiceImpl final : public fusion::FusionMonitor::Service {
+//
+// Subscriptions are served on raw byte buffers through the callback API.
+// After every fusion cycle a broadcast thread fills the picture once per
+// distinct MonitorRequest, serializes it once into a shared ByteBuffer and
+// hands that same buffer to every subscriber that asked for it. Writes are
+// asynchronous; a subscriber still writing the previous frame keeps only
+// the newest one (older ones are conflated away), so a slow display never
+// holds up the others.
+class FusionMonitorServiceImpl final
+    : public fusion::FusionMonitor::WithRawCallbackMethod_SubscribeFusedTracks<fusion::FusionMonitor::Service> {
 public:
     // Constructor: takes references to shared data.
     FusionMonitorServiceImpl(std::mutex& track_mtx,
-                             std::unordered_map<uint32_t, fusion::FusedTrack>& tracks);
+                             FusedTrackTable& tracks,
+                             FusedTrackTable& smoothed_tracks,
+                             std::condition_variable& publish_cv,
+                             uint64_t& publish_seq,
+                             const SpatialIndex& spatial_index,
+                             const TrackHistoryStore& track_history);
+    ~FusionMonitorServiceImpl();
 
-    // Server-streaming RPC: sends MonitorResponse streams to subscribed clients.
-    grpc::Status SubscribeFusedTracks(grpc::ServerContext* context,
-                                      const fusion::MonitorRequest* request,
-                                      grpc::ServerWriter<fusion::MonitorResponse>* writer) override;
-                                
-    // Note: Additional methods for server-streaming can be added here.
+    // Server-streaming RPC: the request and the MonitorResponse stream are
+    // raw serialized messages.
+    grpc::ServerWriteReactor<grpc::ByteBuffer>* SubscribeFusedTracks(grpc::CallbackServerContext* context,
+                                                                     const grpc::ByteBuffer* request) override;
 
 private:
+    class Subscriber;
+    using Frame = std::shared_ptr<const grpc::ByteBuffer>;
+
+    // Continuous subscribers with byte-identical requests share frames.
+    struct Group {
+        fusion::MonitorRequest request;
+        std::vector<Subscriber*> members;
+    };
+
+    // Waits for published cycles and fans each picture out to the groups.
+    void BroadcastLoop();
+
+    // Fills and serializes the picture for one request. Takes mtx_.
+    Frame Snapshot(const fusion::MonitorRequest& request, uint64_t& seq);
+
+    void Register(const std::string& key, const fusion::MonitorRequest& request, Subscriber* s);
+    void Unregister(const std::string& key, Subscriber* s);
+
+    // Copies the tracks selected by the request's filters. Caller holds mtx_.
+    void FillResponse(const fusion::MonitorRequest& request, fusion::MonitorResponse& resp);
+
+    // Adds one track to the response, with its trail if requested. Caller holds mtx_.
+    void AddTrack(const fusion::MonitorRequest& request, const fusion::FusedTrack& track,
+                  fusion::MonitorResponse& resp);
+
     // Reference to the shared mutex provided by the Fusion Service
-    std::mutex& mtx_; 
+    std::mutex& mtx_;
 
     // Reference to the shared track list provided by the Fusion Service
-    std::unordered_map<uint32_t, fusion::FusedTrack>& fused_tracks_;
-};
\ No newline at end of file
+    FusedTrackTable& fused_tracks_;
+
+    // Fixed-lag smoothed tracks, for requests with `smoothed` set
+    FusedTrackTable& smoothed_tracks_;
+
+    // Publish notification from the fusion loop (guarded by mtx_)
+    std::condition_variable& publish_cv_;
+    uint64_t& publish_seq_;
+
+    // Spatial index over fused_tracks_ (guarded by mtx_)
+    const SpatialIndex& spatial_index_;
+
+    // Position history per track (guarded by mtx_)
+    const TrackHistoryStore& track_history_;
+
+    std::vector<uint32_t> query_ids_; // Scratch buffer, used under mtx_
+    std::vector<TrackHistoryStore::Sample> history_; // Scratch buffer, used under mtx_
+
+    // Continuous subscribers keyed by serialized request (guarded by groups_mtx_).
+    // Lock order: mtx_, then groups_mtx_, then a subscriber's own mutex.
+    std::mutex groups_mtx_;
+    std::map<std::string, Group> groups_;
+
+    std::atomic<bool> running_{true};
+    std::thread broadcast_thread_;
+};
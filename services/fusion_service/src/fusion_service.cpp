@@ -1,4 +1,5 @@
 #include "fusion_service.h"
+#include "track_update.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
@@ -9,12 +10,97 @@
 #include <map>
 #include <numeric>
 
+#include "config.h"
 #include "geo_utils.h"
 #include "utils/logging.h"
+#include "metrics/fusion_metrics.h"
+#include "tracing/trace.h"
 
 namespace
 {
     constexpr double EARTH_RADIUS = 6371000.0;
+
+    // Resolves the per-sensor ingest counter once per stream and again only
+    // when the sensor id changes, keeping the registry lock off the hot path.
+    class StreamIngestCounter
+    {
+    public:
+        explicit StreamIngestCounter(const char *sensor_type) : sensor_type_(sensor_type) {}
+
+        void Count(const std::string &sensor_id)
+        {
+            if (!counter_ || sensor_id != sensor_id_)
+            {
+                sensor_id_ = sensor_id;
+                counter_ = &metrics::FusionMetrics::Ingest(sensor_type_, sensor_id_);
+            }
+            counter_->Inc();
+        }
+
+    private:
+        const char *sensor_type_;
+        std::string sensor_id_;
+        metrics::Counter *counter_ = nullptr;
+    };
+
+    // Tracks publish the position covariance in local m^2, as the filter
+    // hands it out (KalmanFilter::GetPositionCovariance).
+    void SetCovariance(fusion::Covariance2D *cov, double p_nn, double p_ne, double p_ee)
+    {
+        cov->set_north_north(p_nn);
+        cov->set_north_east(p_ne);
+        cov->set_east_east(p_ee);
+    }
+
+    // Fusion state as the fusion thread copies it for a checkpoint: the
+    // track store's arrays as they are, plus the small per-track maps and
+    // the published messages. Fill turns it into checkpoint records on the
+    // checkpoint writer's thread.
+    struct CheckpointCapture
+    {
+        TrackStore::Image store;
+        std::vector<std::pair<std::string, uint32_t>> ids;
+        std::unordered_map<uint32_t, uint64_t> last_fusion_time;
+        std::unordered_map<uint32_t, common::GeoPoint> uav_reports;
+        std::unordered_map<uint32_t, fusion::FusedTrack> fused_tracks;
+
+        void Fill(checkpoint::Snapshot &snap) const
+        {
+            std::unordered_map<uint32_t, size_t> slots;
+            slots.reserve(store.size());
+            for (size_t i = 0; i < store.size(); ++i)
+                slots.emplace(store.id(i), i);
+
+            snap.tracks.resize(ids.size());
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                checkpoint::TrackState &t = snap.tracks[i];
+                t.external_id = ids[i].first;
+                t.track_id = ids[i].second;
+
+                auto slot_it = slots.find(t.track_id);
+                if (slot_it != slots.end())
+                {
+                    store.Export(slot_it->second, t.state, t.cov);
+                    t.has_filter = true;
+                }
+                auto ts_it = last_fusion_time.find(t.track_id);
+                if (ts_it != last_fusion_time.end())
+                    t.last_fusion_ts = ts_it->second;
+                auto rep_it = uav_reports.find(t.track_id);
+                if (rep_it != uav_reports.end())
+                {
+                    t.has_uav_report = true;
+                    t.uav_lat = rep_it->second.lat();
+                    t.uav_lon = rep_it->second.lon();
+                    t.uav_alt = rep_it->second.alt();
+                }
+                auto ft_it = fused_tracks.find(t.track_id);
+                if (ft_it != fused_tracks.end())
+                    ft_it->second.SerializeToString(&t.fused_track);
+            }
+        }
+    };
 }
 
 // Kalman filter implementation moved to separate module: kalman_filter.{h,cpp}
@@ -22,14 +108,78 @@ namespace
 // ==================== Fusion Service Implementation ====================
 
 FusionServiceImpl::FusionServiceImpl()
+    : spatial_index_(utils::GetEnvDouble("SPATIAL_CELL_DEG", 0.1)),
+      track_history_((size_t)(utils::GetEnvDouble("TRACK_HISTORY_BUDGET_MB", 64.0) * 1024 * 1024),
+                     (size_t)utils::GetEnvDouble("TRACK_HISTORY_SAMPLES", 600)),
+      track_store_((size_t)(utils::GetEnvDouble("TRACK_STORE_BUDGET_MB", 64.0) * 1024 * 1024)),
+      truth_((int64_t)utils::GetEnvDouble("TRUTH_BUCKET_MS", 100),
+             (size_t)utils::GetEnvDouble("TRUTH_BUCKETS", 1200),
+             (int64_t)utils::GetEnvDouble("TRUTH_MAX_EXTRAPOLATION_MS", 1500)),
+      evaluator_(utils::GetEnvDouble("EVAL_CONVERGE_M", 20.0),
+                 (uint32_t)utils::GetEnvDouble("EVAL_CONVERGE_SAMPLES", 10)),
+      converged_cycles_((uint32_t)utils::GetEnvDouble("ADMISSION_CONVERGED_CYCLES", 20))
 {
+    checkpoint_dir_ = utils::GetEnvString("CHECKPOINT_DIR", "");
+    checkpoint_interval_ = std::chrono::milliseconds((int64_t)utils::GetEnvDouble("CHECKPOINT_INTERVAL_MS", 1000));
+    handoff_tombstone_ = std::chrono::milliseconds((int64_t)utils::GetEnvDouble("HANDOFF_TOMBSTONE_MS", 5000));
+    if (!checkpoint_dir_.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(checkpoint_dir_, ec);
+        checkpoint_writer_ = std::make_unique<checkpoint::CheckpointWriter>(checkpoint_dir_);
+        journal_ = std::make_unique<checkpoint::Journal>(checkpoint_dir_);
+        std::cout << "[FUSION] Checkpointing to " << checkpoint_dir_ << " every "
+                  << checkpoint_interval_.count() << " ms" << std::endl;
+    }
+
+    if (utils::GetEnvString("FUSION_ASSOCIATION", "id") == "jpda")
+    {
+        jpda_ = std::make_unique<jpda::Associator>(jpda::Config::FromEnv());
+        const jpda::Config &jc = jpda_->config();
+        std::cout << "[FUSION] JPDA association (Pd " << jc.detection_probability << ", gate " << jc.gate
+                  << ", clutter " << jc.clutter_density << "/km^2, "
+                  << jc.max_hypotheses << " hypotheses per cluster)" << std::endl;
+    }
+
+    size_t smoother_lag = (size_t)std::max(utils::GetEnvDouble("SMOOTHER_LAG", 10), 0.0);
+    if (smoother_lag > 0)
+    {
+        smoother_ = std::make_unique<FixedLagSmoother>(
+            smoother_lag, (size_t)(utils::GetEnvDouble("SMOOTHER_BUDGET_MB", 64.0) * 1024 * 1024));
+        std::cout << "[FUSION] Fixed-lag smoother, lag " << smoother_lag << " cycles" << std::endl;
+    }
+
+    MulticastSink::Config mc = MulticastSink::Config::FromEnv();
+    multicast_ = MulticastSink::Create(mc);
+    if (multicast_)
+    {
+        std::cout << "[FUSION] Multicasting tracks to " << mc.group << ":" << mc.port << " (ttl " << mc.ttl
+                  << ", keyframe every " << mc.keyframe_ms << " ms)" << std::endl;
+    }
+
+    std::cout << "[FUSION] Ingest queue limit " << admission_.queue_limit() << " measurements, track store "
+              << track_store_.capacity() << " tracks" << std::endl;
+
     running_ = true;
     std::cout << "[FUSION] Starting Background Fusion Thread (Dynamic origin)..." << std::endl;
     fusion_thread_ = std::thread(&FusionServiceImpl::FusionLoop, this);
+
+    if (utils::GetEnvString("SHM_INGEST", "1") == "1")
+    {
+        shm_ingest_ = std::make_unique<ShmIngest>(shm::SegmentDir(), [this](std::vector<SensorMeasurement> &round)
+                                                  {
+                                                      metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
+                                                      std::lock_guard<std::mutex> lock(queue_mtx_);
+                                                      for (auto &m : round)
+                                                          admission_.Offer(queue_, std::move(m));
+                                                      fm.queue_depth.Set((int64_t)queue_.size());
+                                                  });
+    }
 }
 
 FusionServiceImpl::~FusionServiceImpl()
 {
+    shm_ingest_.reset();
     running_ = false;
     if (fusion_thread_.joinable())
         fusion_thread_.join();
@@ -39,14 +189,23 @@ grpc::Status FusionServiceImpl::StreamUAV(
     grpc::ServerContext *context, grpc::ServerReader<sensors::UAVTelemetry> *reader, fusion::FusionAck *ack)
 {
     sensors::UAVTelemetry msg;
+    StreamIngestCounter ingest("UAV");
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
     while (reader->Read(&msg))
     {
+        ingest.Count(msg.header().sensor_id().empty() ? msg.uav_id() : msg.header().sensor_id());
+        TRACE_SCOPE("StreamUAV.enqueue");
+        SensorMeasurement m{(uint64_t)msg.header().timestamp(),
+                            "UAV",
+                            msg.uav_id(),
+                            msg.uav_id(),
+                            msg.position().lat(), msg.position().lon(), msg.position().alt(),
+                            msg.uav_id()};
+        m.sensor_ns = msg.header().timestamp_ns();
+        m.received_ns = ClockSync::Now();
         std::lock_guard<std::mutex> lock(queue_mtx_);
-        queue_.push_back({(uint64_t)msg.header().timestamp(),
-                          "UAV",
-                          msg.uav_id(),
-                          msg.position().lat(), msg.position().lon(), msg.position().alt(),
-                          msg.uav_id()});
+        admission_.Offer(queue_, std::move(m));
+        fm.queue_depth.Set((int64_t)queue_.size());
     }
     return grpc::Status::OK;
 }
@@ -55,19 +214,34 @@ grpc::Status FusionServiceImpl::StreamRadar(
     grpc::ServerContext *context, grpc::ServerReader<sensors::RadarDetection> *reader, fusion::FusionAck *ack)
 {
     sensors::RadarDetection msg;
+    StreamIngestCounter ingest("RADAR");
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
     while (reader->Read(&msg))
     {
-        std::lock_guard<std::mutex> lock(queue_mtx_);
+        ingest.Count(msg.header().sensor_id());
+        TRACE_SCOPE("StreamRadar.enqueue");
         // The radar client already calculates the target GPS coordinates;
         // use them directly. If the client provided per-message origin
         // instead, that should be stored per-sensor (not done here).
-        queue_.push_back({(uint64_t)msg.header().timestamp(),
-                          "RADAR",
-                          msg.header().sensor_id(),
-                          msg.radar_lat(),
-                          msg.radar_lon(),
-                          msg.radar_alt(),
-                          ""});
+        SensorMeasurement m{(uint64_t)msg.header().timestamp(),
+                            "RADAR",
+                            msg.header().sensor_id(),
+                            msg.track_id(),
+                            msg.radar_lat(),
+                            msg.radar_lon(),
+                            msg.radar_alt(),
+                            ""};
+        m.range_rate = msg.velocity();
+        m.range_rate_sigma = msg.velocity_sigma();
+        m.bearing = msg.bearing();
+        m.range = msg.range();
+        m.range_sigma = msg.range_sigma();
+        m.bearing_sigma = msg.bearing_sigma();
+        m.sensor_ns = msg.header().timestamp_ns();
+        m.received_ns = ClockSync::Now();
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        admission_.Offer(queue_, std::move(m));
+        fm.queue_depth.Set((int64_t)queue_.size());
     }
     return grpc::Status::OK;
 }
@@ -76,21 +250,25 @@ grpc::Status FusionServiceImpl::StreamSigint(
     grpc::ServerContext *context, grpc::ServerReader<sensors::SigintHit> *reader, fusion::FusionAck *ack)
 {
     sensors::SigintHit msg;
+    StreamIngestCounter ingest("SIGINT");
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
     while (reader->Read(&msg))
     {
+        ingest.Count(msg.header().sensor_id());
+        TRACE_SCOPE("StreamSigint.enqueue");
+        SensorMeasurement m{(uint64_t)msg.header().timestamp(), "SIGINT", msg.header().sensor_id(), "", 0.0, 0.0, 0.0, ""};
+        m.sensor_ns = msg.header().timestamp_ns();
+        m.received_ns = ClockSync::Now();
         std::lock_guard<std::mutex> lock(queue_mtx_);
-        queue_.push_back({(uint64_t)msg.header().timestamp(), "SIGINT", msg.header().sensor_id(), 0.0, 0.0, 0.0, ""});
+        admission_.Offer(queue_, std::move(m));
+        fm.queue_depth.Set((int64_t)queue_.size());
     }
     return grpc::Status::OK;
 }
 
-
 void FusionServiceImpl::FusionLoop()
 {
-    uint64_t last_fusion_time = 0;
-    double raw_uav_lat = 0.0, raw_uav_lon = 0.0, raw_uav_alt = 0.0;
-
-    const std::string report_path = "/workspace/shared/logs/results.csv";
+    const std::string report_path = utils::GetEnvString("FUSION_REPORT_PATH", "/workspace/shared/logs/results.csv");
     const std::string header = "ts,f_lat,f_lon,uav_lat,uav_lon,error_m,sources";
 
     {
@@ -111,77 +289,256 @@ void FusionServiceImpl::FusionLoop()
     // In real systems this data comes from a "Sensor Registry" service.
     std::map<std::string, double> sensor_sigma_map;
 
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
+    TRACE_THREAD_NAME("FusionLoop");
+
+    if (journal_)
+        RestoreCheckpoint(report_path);
+
+    auto last_shed_report = std::chrono::steady_clock::now();
+
     while (running_)
     {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (journal_ && checkpoint_due_)
+            TakeCheckpoint();
 
         std::deque<SensorMeasurement> batch;
+        std::deque<std::shared_ptr<HandoffRequest>> handoffs;
+        std::string shed_report;
+        bool idle;
         {
+            TRACE_SCOPE("FusionLoop.ingest");
             std::lock_guard<std::mutex> lock(queue_mtx_);
-            if (queue_.empty())
-                continue;
-            batch.swap(queue_);
+            if (std::chrono::steady_clock::now() - last_shed_report >= std::chrono::seconds(5))
+            {
+                shed_report = admission_.TakeReport();
+                last_shed_report = std::chrono::steady_clock::now();
+            }
+            idle = queue_.empty() && handoffs_.empty();
+            if (!idle)
+            {
+                batch.swap(queue_);
+                handoffs.swap(handoffs_);
+                admission_.Drained();
+                fm.queue_depth.Set(0);
+            }
+        }
+        if (!shed_report.empty())
+            std::cout << "[FUSION] Overload: " << shed_report << std::endl;
+        if (idle)
+        {
+            if (multicast_)
+                multicast_->Flush(); // Keyframes keep going while idle
+            continue;
         }
 
-        uint32_t track_id = 1;
-        uint64_t current_batch_ts = batch.back().timestamp;
-        std::vector<std::string> active_sources;
+        // Imports go first so an imported track is in place before the
+        // measurements routed here after it. Exports go after the batch, so
+        // what was routed here before the handoff is fused into the state
+        // that leaves; later measurements of the target are dropped.
+        for (auto &req : handoffs)
+        {
+            if (!req->is_export)
+            {
+                ApplyImport(req->handoff);
+                req->done.set_value(true);
+            }
+        }
+
+        if (!batch.empty())
+        {
+            // Sensor clocks onto the fusion clock; the journal keeps the result.
+            clock_sync_.Correct(batch);
+            if (journal_)
+            {
+                TRACE_SCOPE("FusionLoop.journal");
+                journal_->Append(batch);
+            }
+            ProcessBatch(batch, report_path);
+        }
 
-        KalmanFilter &kf = kf_map_[track_id];
-        double dt = (last_fusion_time == 0) ? 0.1 : (current_batch_ts - last_fusion_time) / 1000.0;
-        if (dt <= 0 || dt > 1.0)
-            dt = 0.1;
+        for (auto &req : handoffs)
+        {
+            if (req->is_export)
+            {
+                ApplyExport(req->handoff);
+                req->done.set_value(true);
+            }
+        }
+        // Handoffs are not journaled; checkpoint right after them instead.
+        if (!handoffs.empty())
+            checkpoint_due_ = true;
+        if (multicast_)
+        {
+            TRACE_SCOPE("FusionLoop.multicast");
+            multicast_->Flush();
+        }
+
+        if (journal_ && std::chrono::steady_clock::now() - last_checkpoint_ >= checkpoint_interval_)
+            checkpoint_due_ = true;
+    }
 
-        kf.Predict(dt);
-        last_fusion_time = current_batch_ts;
+    // The evaluator belongs to this thread, so its summary is written here.
+    evaluator_.WriteSummary(utils::GetEnvString("FUSION_SUMMARY_PATH", "/workspace/shared/logs/summary.csv"));
+}
+
+void FusionServiceImpl::ProcessBatch(const std::deque<SensorMeasurement> &batch, const std::string &report_path)
+{
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
+    metrics::ScopedTimer cycle_timer(fm.cycle_time);
+    TRACE_SCOPE("FusionLoop.cycle");
+    fm.batch_size.Record(batch.size());
 
+    // Associate measurements to tracks by their external target id, or by
+    // position under JPDA. UAV telemetry is kept as the reported (reference)
+    // position of its track.
+    TrackBatches track_batches;
+    std::map<uint32_t, std::vector<PdaScan>> pda_scans;
+    {
+        TRACE_SCOPE("FusionLoop.association");
+        std::vector<const SensorMeasurement *> radar;
         for (const auto &m : batch)
         {
-            if (m.sensor_type == "UAV")
+            if (m.sensor_type == "SIGINT")
+                continue;
+            if (!m.target_id.empty() && !handed_off_.empty() && HandedOff(m.target_id))
             {
-                raw_uav_lat = m.lat;
-                raw_uav_lon = m.lon;
-                raw_uav_alt = m.alt;
+                fm.handoff_dropped.Inc();
                 continue;
             }
 
-            if (std::abs(m.lat) < 1.0)
-                continue;
-
-            // --- DYNAMIC R MATRIX CALCULATION ---
-            // We use RADAR_RANGE_SIGMA from docker-compose per sensor.
-            // If the radar client does not send sigma info inside the message,
-            // we can assign a default based on sensor_id here.
-
-            double sigma = 30.0; // Default
-            if (m.sensor_id == "TPS-77-LONG-RANGE")
+            if (m.sensor_type == "UAV")
             {
-                sigma = 50.0;
+                uint32_t track_id = ResolveId(m.target_id);
+                common::GeoPoint &rep = uav_reports_[track_id];
+                rep.set_lat(m.lat);
+                rep.set_lon(m.lon);
+                rep.set_alt(m.alt);
+                truth_.Add(track_id, (int64_t)m.timestamp, m.lat, m.lon, m.alt);
+                continue;
             }
-            else if (m.sensor_id == "AN-MPQ-53-PATRIOT")
+            if (jpda_)
             {
-                sigma = 5.0;
+                radar.push_back(&m);
+                continue;
             }
+            // Unlabelled detections (clutter) can only be associated by JPDA.
+            if (m.target_id.empty())
+                continue;
+            uint32_t track_id = ResolveId(m.target_id);
+            track_batches[track_id].push_back(&m);
+            evaluator_.RecordAssociation(track_id, m.target_id);
+        }
+        if (jpda_ && !radar.empty())
+            AssociateJpda(radar, track_batches, pda_scans);
+    }
+
+    bool published = false;
+    std::vector<std::pair<std::string, bool>> converged_changes;
+    for (const auto &tb : track_batches)
+    {
+        uint32_t track_id = tb.first;
+        const auto &measurements = tb.second;
+        uint64_t current_batch_ts = measurements.back()->timestamp;
+        uint64_t current_batch_ns = (uint64_t)measurements.back()->time_ns;
+        std::vector<std::string> active_sources;
 
-            // Kalman's R matrix is the variance: R = sigma^2
-            double base_R = std::pow(sigma, 2);
+        KalmanFilter &kf = filter_;
+        if (!track_store_.Load(track_id, kf))
+            kf.Reset();
+        uint64_t &last_fusion_time = last_fusion_time_[track_id];
+        double dt = PredictInterval(last_fusion_time, current_batch_ns);
 
-            double pred_lat, pred_lon, v_lat, v_lon;
-            kf.GetState(pred_lat, pred_lon, v_lat, v_lon);
-            double innovation = geo_utils::CalculateHaversine(m.lat, m.lon, pred_lat, pred_lon);
+        {
+            TRACE_SCOPE("FusionLoop.predict");
+            kf.Predict(dt);
+        }
+        double prior_state[4], prior_cov[16];
+        if (smoother_)
+            kf.ExportState(prior_state, prior_cov);
+        last_fusion_time = std::max(last_fusion_time, current_batch_ns);
 
-            // Gating: Filter very large deviations (outliers)
-            double adaptive_R = base_R;
-            if (innovation > 1000.0)
+        bool gated = false;
+        auto pda_it = pda_scans.find(track_id);
+        if (pda_it != pda_scans.end())
+        {
+            TRACE_SCOPE("FusionLoop.update");
+            std::vector<double> lat, lon;
+            for (const PdaScan &scan : pda_it->second)
             {
-                // If the measurement is very distant, increase R to desensitize the filter (Outlier Rejection)
-                adaptive_R = base_R * std::pow(innovation / 500.0, 2);
+                lat.clear();
+                lon.clear();
+                size_t best = 0;
+                for (size_t i = 0; i < scan.measurements.size(); ++i)
+                {
+                    lat.push_back(scan.measurements[i]->lat);
+                    lon.push_back(scan.measurements[i]->lon);
+                    if (scan.beta[i] > scan.beta[best])
+                        best = i;
+                }
+                kf.UpdatePda(lat.data(), lon.data(), scan.beta.data(), lat.size(), scan.r_nn, scan.r_ne, scan.r_ee);
+                fm.filter_updates.Inc();
+                if (kf.GetLastNis() >= 0.0)
+                    evaluator_.RecordNis(track_id, kf.GetLastNis());
+
+                // Doppler only from a candidate that is probably the target.
+                const SensorMeasurement &m = *scan.measurements[best];
+                if (scan.beta[best] >= 0.5 && RangeRateUpdate(kf, m.range_rate, m.bearing, m.range_rate_sigma))
+                    fm.doppler_updates.Inc();
+
+                if (std::find(active_sources.begin(), active_sources.end(), m.sensor_id) == active_sources.end())
+                    active_sources.push_back(m.sensor_id);
             }
+        }
+        else
+        {
+            TRACE_SCOPE("FusionLoop.update");
+            for (const SensorMeasurement *mp : measurements)
+            {
+                const SensorMeasurement &m = *mp;
+                if (std::abs(m.lat) < 1.0)
+                    continue;
+
+                // R comes from the per-sensor sigma; outliers get R inflated.
+                if (GatedUpdate(kf, m.sensor_id, m.lat, m.lon))
+                {
+                    fm.gate_rejections.Inc();
+                    gated = true;
+                }
+                fm.filter_updates.Inc();
+                if (kf.GetLastNis() >= 0.0)
+                    evaluator_.RecordNis(track_id, kf.GetLastNis());
+                if (RangeRateUpdate(kf, m.range_rate, m.bearing, m.range_rate_sigma))
+                    fm.doppler_updates.Inc();
+
+                if (std::find(active_sources.begin(), active_sources.end(), m.sensor_id) == active_sources.end())
+                    active_sources.push_back(m.sensor_id);
+            }
+        }
+
+        if (!active_sources.empty())
+        {
+            uint32_t &settled = settled_cycles_[track_id];
+            bool was_converged = settled >= converged_cycles_;
+            settled = gated ? 0 : settled + 1;
+            if ((settled >= converged_cycles_) != was_converged)
+                converged_changes.emplace_back(int_to_ext_id_[track_id], !was_converged);
+        }
 
-            kf.Update(m.lat, m.lon, adaptive_R);
+        track_store_.Store(track_id, kf, last_fusion_time, evicted_);
 
-            if (std::find(active_sources.begin(), active_sources.end(), m.sensor_id) == active_sources.end())
-                active_sources.push_back(m.sensor_id);
+        // Every filter cycle goes into the smoother, which hands back the
+        // estimate of the cycle `lag` steps earlier once it has that many.
+        FixedLagSmoother::Estimate smoothed;
+        bool has_smoothed = false;
+        if (smoother_ && kf.IsInitialized())
+        {
+            TRACE_SCOPE("FusionLoop.smooth");
+            double post_state[4], post_cov[16];
+            kf.ExportState(post_state, post_cov);
+            has_smoothed = smoother_->Push(track_id, (int64_t)current_batch_ts, dt, prior_state, prior_cov,
+                                           post_state, post_cov, smoothed);
         }
 
         double f_lat, f_lon, f_v_lat, f_v_lon;
@@ -193,23 +550,98 @@ void FusionServiceImpl::FusionLoop()
             continue;
         }
 
-        double error_m = (raw_uav_lat != 0.0) ? geo_utils::CalculateHaversine(f_lat, f_lon, raw_uav_lat, raw_uav_lon) : 0.0;
+        auto rep_it = uav_reports_.find(track_id);
+        double raw_uav_lat = (rep_it != uav_reports_.end()) ? rep_it->second.lat() : 0.0;
+        double raw_uav_lon = (rep_it != uav_reports_.end()) ? rep_it->second.lon() : 0.0;
+        double raw_uav_alt = (rep_it != uav_reports_.end()) ? rep_it->second.alt() : 0.0;
+
+        // Score against truth at the fused timestamp; fall back to the
+        // last UAV report when no truth covers that time.
+        double error_m = 0.0;
+        TruthStore::Point truth;
+        if (truth_.Lookup(track_id, (int64_t)current_batch_ts, truth))
+        {
+            double p_nn, p_ne, p_ee;
+            kf.GetPositionCovariance(p_nn, p_ne, p_ee);
+            error_m = evaluator_.Evaluate(track_id, (int64_t)current_batch_ts, f_lat, f_lon,
+                                          p_nn, p_ne, p_ee, truth.lat, truth.lon);
+            raw_uav_lat = truth.lat;
+            raw_uav_lon = truth.lon;
+            raw_uav_alt = truth.alt;
+        }
+        else if (raw_uav_lat != 0.0)
+        {
+            error_m = geo_utils::CalculateHaversine(f_lat, f_lon, raw_uav_lat, raw_uav_lon);
+        }
+
+        // The smoothed estimate is only scored against truth at its own time.
+        TruthStore::Point smoothed_truth;
+        bool smoothed_scored = has_smoothed && truth_.Lookup(track_id, smoothed.timestamp_ms, smoothed_truth);
 
         // Send to Monitor service
         {
-            std::lock_guard<std::mutex> lock(mtx_);
-            fusion::FusedTrack &ft = fused_tracks_[track_id];
+            TRACE_SCOPE("FusionLoop.publish");
+            std::unique_lock<std::mutex> lock(mtx_, std::defer_lock);
+            {
+                TRACE_SCOPE("FusionLoop.publish.wait_mtx");
+                lock.lock();
+            }
+            fusion::FusedTrack &ft = fused_tracks_.Emplace(track_id);
             ft.set_track_id(track_id);
+            ft.set_external_id(int_to_ext_id_[track_id]);
             ft.mutable_position()->set_lat(f_lat);
             ft.mutable_position()->set_lon(f_lon);
             ft.mutable_position()->set_alt(raw_uav_alt != 0 ? raw_uav_alt : 1250.0);
             ft.set_confidence(0.95);
+            ft.set_measurement_ts((int64_t)current_batch_ts);
+            {
+                double p_nn, p_ne, p_ee;
+                kf.GetPositionCovariance(p_nn, p_ne, p_ee);
+                SetCovariance(ft.mutable_covariance(), p_nn, p_ne, p_ee);
+            }
             ft.clear_source_sensors();
             for (const auto &s : active_sources)
                 ft.add_source_sensors(s);
+            spatial_index_.Update(track_id, f_lat, f_lon);
+            track_history_.Append(track_id, (int64_t)current_batch_ts, f_lat, f_lon, ft.position().alt());
+            if (rep_it != uav_reports_.end())
+            {
+                ft.set_uav_error_m(error_m);
+                *ft.mutable_uav_reported() = rep_it->second;
+            }
+            evaluator_.Fill(track_id, ft.mutable_quality());
+            if (multicast_)
+                multicast_->Update(ft);
+
+            if (has_smoothed)
+            {
+                double s_lat = smoothed.state[0], s_lon = smoothed.state[1];
+                fusion::FusedTrack &st = smoothed_tracks_.Emplace(track_id);
+                st.set_track_id(track_id);
+                st.set_external_id(ft.external_id());
+                st.mutable_position()->set_lat(s_lat);
+                st.mutable_position()->set_lon(s_lon);
+                st.mutable_position()->set_alt(smoothed_scored && smoothed_truth.alt != 0 ? smoothed_truth.alt
+                                                                                          : ft.position().alt());
+                st.set_confidence(ft.confidence());
+                st.set_measurement_ts(smoothed.timestamp_ms);
+                double p_nn, p_ne, p_ee;
+                KalmanFilter::PositionCovariance(smoothed.cov, p_nn, p_ne, p_ee);
+                SetCovariance(st.mutable_covariance(), p_nn, p_ne, p_ee);
+                *st.mutable_source_sensors() = ft.source_sensors();
+                if (smoothed_scored)
+                {
+                    st.set_uav_error_m(geo_utils::CalculateHaversine(s_lat, s_lon, smoothed_truth.lat, smoothed_truth.lon));
+                    st.mutable_uav_reported()->set_lat(smoothed_truth.lat);
+                    st.mutable_uav_reported()->set_lon(smoothed_truth.lon);
+                    st.mutable_uav_reported()->set_alt(smoothed_truth.alt);
+                }
+            }
         }
+        published = true;
 
         // CSV Logging
+        TRACE_SCOPE("FusionLoop.logging");
         std::stringstream ss;
         ss << current_batch_ts << "," << std::fixed << std::setprecision(6) << f_lat << "," << f_lon << ","
            << raw_uav_lat << "," << raw_uav_lon << "," << std::fixed << std::setprecision(2) << error_m << ",";
@@ -217,10 +649,442 @@ void FusionServiceImpl::FusionLoop()
             ss << active_sources[i] << (i < active_sources.size() - 1 ? ";" : "");
 
         utils::LogToCSV(report_path, ss.str(), mtx_);
+
+        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch()).count();
+        if (now_ms > (int64_t)current_batch_ts)
+            fm.log_writer_lag.Record((uint64_t)(now_ms - (int64_t)current_batch_ts) * 1000000ull);
     }
+
+    if (!converged_changes.empty())
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        for (const auto &c : converged_changes)
+            admission_.SetConverged(c.first, c.second);
+    }
+    DropEvicted();
+
+    if (published)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            ++publish_seq_;
+            fm.tracks.Set((int64_t)fused_tracks_.size());
+            fm.smoothed_tracks.Set((int64_t)smoothed_tracks_.size());
+        }
+        fm.track_store_bytes.Set((int64_t)track_store_.MemoryBytes());
+        if (smoother_)
+            fm.smoother_bytes.Set((int64_t)smoother_->MemoryBytes());
+        publish_cv_.notify_all();
+    }
+}
+
+bool FusionServiceImpl::SubmitHandoff(const std::shared_ptr<HandoffRequest> &req)
+{
+    std::future<bool> done = req->done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        handoffs_.push_back(req);
+    }
+    return done.wait_for(std::chrono::seconds(1)) == std::future_status::ready && done.get();
+}
+
+bool FusionServiceImpl::ExportTrack(const std::string &external_id, fusion::TrackHandoff &out)
+{
+    auto req = std::make_shared<HandoffRequest>();
+    req->is_export = true;
+    req->handoff.set_external_id(external_id);
+    if (!SubmitHandoff(req))
+        return false;
+    out = std::move(req->handoff);
+    return true;
+}
+
+bool FusionServiceImpl::ImportTrack(const fusion::TrackHandoff &in)
+{
+    auto req = std::make_shared<HandoffRequest>();
+    req->is_export = false;
+    req->handoff = in;
+    return SubmitHandoff(req);
+}
+
+void FusionServiceImpl::ApplyExport(fusion::TrackHandoff &handoff)
+{
+    // The router owns the target elsewhere from now on, found here or not.
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = handed_off_.begin(); it != handed_off_.end();)
+        it = now - it->second >= handoff_tombstone_ ? handed_off_.erase(it) : std::next(it);
+    handed_off_[handoff.external_id()] = now;
+
+    auto id_it = ext_to_int_id_.find(handoff.external_id());
+    if (id_it == ext_to_int_id_.end())
+        return;
+    uint32_t track_id = id_it->second;
+    if (!track_store_.Load(track_id, filter_))
+        return;
+
+    double state[4], cov[16];
+    filter_.ExportState(state, cov);
+    handoff.set_found(true);
+    for (double v : state)
+        handoff.add_state(v);
+    for (double v : cov)
+        handoff.add_covariance(v);
+    handoff.set_last_update_ts((int64_t)(last_fusion_time_[track_id] / 1000000));
+    auto rep_it = uav_reports_.find(track_id);
+    if (rep_it != uav_reports_.end())
+        *handoff.mutable_uav_reported() = rep_it->second;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::vector<TrackHistoryStore::Sample> history;
+        track_history_.Read(track_id, 0, history);
+        for (const auto &s : history)
+        {
+            fusion::TrackPoint *p = handoff.add_history();
+            p->set_timestamp(s.timestamp_ms);
+            p->mutable_position()->set_lat(s.lat);
+            p->mutable_position()->set_lon(s.lon);
+            p->mutable_position()->set_alt(s.alt);
+        }
+        track_history_.Remove(track_id);
+        spatial_index_.Remove(track_id);
+        fused_tracks_.Erase(track_id);
+        smoothed_tracks_.Erase(track_id);
+        ++publish_seq_;
+        metrics::FusionMetrics::Get().tracks.Set((int64_t)fused_tracks_.size());
+        metrics::FusionMetrics::Get().smoothed_tracks.Set((int64_t)smoothed_tracks_.size());
+    }
+    publish_cv_.notify_all();
+
+    track_store_.Remove(track_id);
+    if (smoother_)
+        smoother_->Remove(track_id);
+    if (multicast_)
+        multicast_->Remove(track_id);
+    last_fusion_time_.erase(track_id);
+    uav_reports_.erase(track_id);
+    settled_cycles_.erase(track_id);
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        admission_.SetConverged(handoff.external_id(), false);
+    }
+    std::cout << "[FUSION] Track " << handoff.external_id() << " handed off ("
+              << handoff.history_size() << " history points)" << std::endl;
+}
+
+void FusionServiceImpl::ApplyImport(const fusion::TrackHandoff &handoff)
+{
+    handed_off_.erase(handoff.external_id());
+    if (!handoff.found() || handoff.state_size() != 4 || handoff.covariance_size() != 16)
+        return;
+
+    uint32_t track_id = ResolveId(handoff.external_id());
+    filter_.ImportState(handoff.state().data(), handoff.covariance().data());
+    if (smoother_)
+        smoother_->Remove(track_id); // The window restarts from the imported state
+    uint64_t &last = last_fusion_time_[track_id];
+    last = std::max(last, (uint64_t)handoff.last_update_ts() * 1000000);
+    track_store_.Store(track_id, filter_, last, evicted_);
+    DropEvicted();
+    if (handoff.has_uav_reported() && !uav_reports_.count(track_id))
+        uav_reports_[track_id] = handoff.uav_reported();
+
+    // Handed-over trail first, then anything this shard already fused for
+    // the target after it (measurements can arrive before the handoff).
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::vector<TrackHistoryStore::Sample> local;
+    track_history_.Read(track_id, handoff.last_update_ts() + 1, local);
+    track_history_.Remove(track_id);
+    for (const auto &p : handoff.history())
+        track_history_.Append(track_id, p.timestamp(), p.position().lat(), p.position().lon(), p.position().alt());
+    for (const auto &s : local)
+        track_history_.Append(track_id, s.timestamp_ms, s.lat, s.lon, s.alt);
+    std::cout << "[FUSION] Track " << handoff.external_id() << " taken over ("
+              << handoff.history_size() << " history points)" << std::endl;
+}
+
+void FusionServiceImpl::DropEvicted()
+{
+    // A track that came back later in the same cycle is in the store again.
+    evicted_.erase(std::remove_if(evicted_.begin(), evicted_.end(),
+                                  [this](uint32_t id) { return track_store_.Contains(id); }),
+                   evicted_.end());
+    if (evicted_.empty())
+        return;
+
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (uint32_t track_id : evicted_)
+        {
+            track_history_.Remove(track_id);
+            spatial_index_.Remove(track_id);
+            fused_tracks_.Erase(track_id);
+            smoothed_tracks_.Erase(track_id);
+        }
+        ++publish_seq_;
+        fm.tracks.Set((int64_t)fused_tracks_.size());
+        fm.smoothed_tracks.Set((int64_t)smoothed_tracks_.size());
+    }
+    publish_cv_.notify_all();
+
+    for (uint32_t track_id : evicted_)
+    {
+        if (smoother_)
+            smoother_->Remove(track_id);
+        if (multicast_)
+            multicast_->Remove(track_id);
+        last_fusion_time_.erase(track_id);
+        settled_cycles_.erase(track_id);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        for (uint32_t track_id : evicted_)
+            admission_.SetConverged(int_to_ext_id_[track_id], false);
+    }
+    fm.track_evictions.Inc(evicted_.size());
+    std::cout << "[FUSION] Track store full (" << track_store_.capacity() << " tracks): dropped "
+              << evicted_.size() << " coasting tracks" << std::endl;
+    evicted_.clear();
+}
+
+void FusionServiceImpl::TakeCheckpoint()
+{
+    TRACE_SCOPE("FusionLoop.checkpoint");
+    // Runs on the fusion thread, the only writer of this state, so the copy
+    // is consistent without locks. Only copies are taken here: unpacking
+    // the filters, serializing the tracks and file I/O happen on the
+    // writer thread.
+    auto snap = std::make_unique<checkpoint::Snapshot>();
+    snap->next_id = next_id_;
+    snap->created_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+    auto capture = std::make_shared<CheckpointCapture>();
+    track_store_.CopyTo(capture->store);
+    capture->ids.assign(ext_to_int_id_.begin(), ext_to_int_id_.end());
+    capture->last_fusion_time = last_fusion_time_;
+    capture->uav_reports = uav_reports_;
+    capture->fused_tracks.reserve(fused_tracks_.size());
+    fused_tracks_.ForEach([&](uint32_t track_id, const fusion::FusedTrack &ft)
+                          { capture->fused_tracks.emplace(track_id, ft); });
+
+    // Batches from here on go to a new segment; the snapshot covers the rest.
+    journal_->Open(journal_->seq() + 1);
+    snap->journal_seq = journal_->seq();
+    checkpoint_writer_->Submit(std::move(snap), [capture](checkpoint::Snapshot &s) { capture->Fill(s); });
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    checkpoint_due_ = false;
 }
 
+void FusionServiceImpl::RestoreCheckpoint(const std::string &report_path)
+{
+    auto started = std::chrono::steady_clock::now();
+    checkpoint::Snapshot snap;
+    std::string error;
+    bool loaded = checkpoint::Load(checkpoint::CheckpointWriter::CheckpointPath(checkpoint_dir_), snap, error);
+    if (loaded)
+    {
+        next_id_ = snap.next_id;
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (const checkpoint::TrackState &t : snap.tracks)
+        {
+            ext_to_int_id_[t.external_id] = t.track_id;
+            int_to_ext_id_[t.track_id] = t.external_id;
+            if (t.has_filter)
+            {
+                filter_.ImportState(t.state, t.cov);
+                track_store_.Store(t.track_id, filter_, t.last_fusion_ts, evicted_);
+            }
+            if (t.last_fusion_ts != 0)
+                last_fusion_time_[t.track_id] = t.last_fusion_ts;
+            if (t.has_uav_report)
+            {
+                common::GeoPoint &rep = uav_reports_[t.track_id];
+                rep.set_lat(t.uav_lat);
+                rep.set_lon(t.uav_lon);
+                rep.set_alt(t.uav_alt);
+            }
+            if (!t.fused_track.empty())
+            {
+                fusion::FusedTrack &ft = fused_tracks_.Emplace(t.track_id);
+                if (ft.ParseFromString(t.fused_track))
+                {
+                    spatial_index_.Update(t.track_id, ft.position().lat(), ft.position().lon());
+                    if (multicast_)
+                        multicast_->Update(ft);
+                }
+                else
+                    fused_tracks_.Erase(t.track_id);
+            }
+        }
+    }
+    else if (error != "no checkpoint")
+    {
+        std::cerr << "[FUSION] Ignoring checkpoint and its journal: " << error << std::endl;
+    }
+    DropEvicted();
+
+    // Replay what was fused after the checkpoint (everything, without one).
+    // The segments after a rejected checkpoint miss their base state, so
+    // they are not replayed; the next checkpoint deletes them.
+    bool rejected = !loaded && error != "no checkpoint";
+    size_t batches = 0;
+    uint64_t next_seq = loaded ? snap.journal_seq : 0;
+    for (uint64_t seq : journal_->Segments())
+    {
+        next_seq = std::max(next_seq, seq + 1);
+        if (rejected || (loaded && seq < snap.journal_seq))
+            continue;
+        batches += journal_->Replay(seq, [&](std::deque<SensorMeasurement> &batch)
+                                    { ProcessBatch(batch, report_path); });
+    }
+    journal_->Open(next_seq);
+
+    if (loaded || batches > 0)
+    {
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        std::cout << "[FUSION] Restored " << (loaded ? snap.tracks.size() : 0) << " tracks from checkpoint and replayed "
+                  << batches << " batches in " << (int)std::ceil(ms) << " ms" << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            ++publish_seq_;
+            metrics::FusionMetrics::Get().tracks.Set((int64_t)fused_tracks_.size());
+        }
+        publish_cv_.notify_all();
+    }
+    // Start the new segment chain from a fresh checkpoint.
+    checkpoint_due_ = true;
+}
+
+bool FusionServiceImpl::HandedOff(const std::string &ext_id)
+{
+    auto it = handed_off_.find(ext_id);
+    if (it == handed_off_.end())
+        return false;
+    if (std::chrono::steady_clock::now() - it->second < handoff_tombstone_)
+        return true;
+    handed_off_.erase(it);
+    return false;
+}
+
+uint32_t FusionServiceImpl::ResolveId(const std::string &ext_id)
+{
+    auto it = ext_to_int_id_.find(ext_id);
+    if (it != ext_to_int_id_.end())
+        return it->second;
+
+    uint32_t id = next_id_++;
+    ext_to_int_id_.emplace(ext_id, id);
+    int_to_ext_id_.emplace(id, ext_id);
+    return id;
+}
 
+void FusionServiceImpl::AssociateJpda(const std::vector<const SensorMeasurement *> &radar,
+                                      TrackBatches &track_batches,
+                                      std::map<uint32_t, std::vector<PdaScan>> &pda_scans)
+{
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
+
+    // Each radar's detections in the cycle form one scan. Scans are
+    // associated against the tracks as they stood at the start of the cycle.
+    std::map<std::string, std::vector<const SensorMeasurement *>> scans;
+    for (const SensorMeasurement *m : radar)
+    {
+        if (std::abs(m->lat) >= 1.0)
+            scans[m->sensor_id].push_back(m);
+    }
+
+    std::vector<uint32_t> track_ids;
+    std::vector<jpda::Track> tracks;
+    std::vector<jpda::Measurement> meas;
+    for (const auto &scan : scans)
+    {
+        const std::vector<const SensorMeasurement *> &ms = scan.second;
+        uint64_t scan_ts = 0;
+        meas.clear();
+        for (const SensorMeasurement *m : ms)
+        {
+            scan_ts = std::max(scan_ts, (uint64_t)m->time_ns);
+            jpda::Measurement jm{m->lat, m->lon, 0.0, 0.0, 0.0};
+            if (m->range_sigma > 0.0 && m->bearing_sigma > 0.0)
+            {
+                jpda::PolarCovariance(m->range, m->bearing, m->range_sigma, m->bearing_sigma, jm.r_nn, jm.r_ne, jm.r_ee);
+            }
+            else
+            {
+                double sigma = MeasurementSigma(m->sensor_id);
+                jm.r_nn = jm.r_ee = sigma * sigma;
+            }
+            meas.push_back(jm);
+        }
+
+        track_ids.clear();
+        tracks.clear();
+        track_store_.ForEach([&](uint32_t track_id, const KalmanFilter &kf)
+                             {
+                                 auto last_it = last_fusion_time_.find(track_id);
+                                 double dt = PredictInterval(last_it != last_fusion_time_.end() ? last_it->second : 0, scan_ts);
+                                 jpda::Track t;
+                                 kf.PredictPosition(dt, t.lat, t.lon, t.p_nn, t.p_ne, t.p_ee);
+                                 track_ids.push_back(track_id);
+                                 tracks.push_back(t);
+                             });
+
+        {
+            TRACE_SCOPE("FusionLoop.jpda");
+            jpda_->Associate(tracks, meas, jpda_result_);
+        }
+        fm.jpda_clusters.Inc(jpda_result_.clusters);
+        fm.jpda_approximated.Inc(jpda_result_.approximated);
+
+        for (size_t t = 0; t < track_ids.size(); ++t)
+        {
+            const std::vector<jpda::Association> &assoc = jpda_result_.tracks[t];
+            if (assoc.empty())
+                continue;
+            uint32_t track_id = track_ids[t];
+            PdaScan pda;
+            const jpda::Association *best = &assoc.front();
+            std::vector<const SensorMeasurement *> &batch = track_batches[track_id];
+            for (const jpda::Association &a : assoc)
+            {
+                pda.measurements.push_back(ms[a.measurement]);
+                pda.beta.push_back(a.beta);
+                batch.push_back(ms[a.measurement]);
+                if (a.beta > best->beta)
+                    best = &a;
+            }
+            const jpda::Measurement &r = meas[best->measurement];
+            pda.r_nn = r.r_nn;
+            pda.r_ne = r.r_ne;
+            pda.r_ee = r.r_ee;
+            const std::string &source = ms[best->measurement]->target_id;
+            evaluator_.RecordAssociation(track_id, source.empty() ? "clutter" : source);
+            pda_scans[track_id].push_back(std::move(pda));
+        }
+
+        // Outside every gate: a labelled detection of a target without a
+        // track starts one (track initiation stays label-driven); anything
+        // else is dropped.
+        for (size_t j = 0; j < ms.size(); ++j)
+        {
+            if (jpda_result_.gated[j])
+                continue;
+            const SensorMeasurement *m = ms[j];
+            auto id_it = m->target_id.empty() ? ext_to_int_id_.end() : ext_to_int_id_.find(m->target_id);
+            bool has_track = id_it != ext_to_int_id_.end() && track_store_.Contains(id_it->second);
+            if (m->target_id.empty() || has_track)
+            {
+                fm.jpda_unassociated.Inc();
+                continue;
+            }
+            uint32_t track_id = ResolveId(m->target_id);
+            track_batches[track_id].push_back(m);
+            evaluator_.RecordAssociation(track_id, m->target_id);
+        }
+    }
+}
 
 void FusionServiceImpl::StartTimeoutThread(int duration_sec)
 {
@@ -231,8 +1095,12 @@ void FusionServiceImpl::StartTimeoutThread(int duration_sec)
                 {
                     std::this_thread::sleep_for(std::chrono::seconds(duration_sec));
                     std::cout << "[FUSION] Simulation duration reached. Shutting down..." << std::endl;
-                    this->running_ = false;                               // Stop the fusion loop
-                    std::this_thread::sleep_for(std::chrono::seconds(1)); // Wait a moment for writing final logs
+                    this->running_ = false; // Stop the fusion loop
+                    if (fusion_thread_.joinable())
+                        fusion_thread_.join(); // Final logs and the evaluator summary are written
+                    std::string trace_path = utils::GetEnvString("TRACE_OUTPUT", "");
+                    if (!trace_path.empty() && tracing::WriteChromeJson(trace_path))
+                        std::cout << "[FUSION] Trace written to " << trace_path << std::endl;
                     std::exit(0);                                         // For stopping the container
                 })
         .detach();
@@ -1,15 +1,34 @@
 #pragma once
 
 #include <grpcpp/grpcpp.h>
+#include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
 #include <vector>
 #include <deque>
+#include <map>
 #include <unordered_map>
 #include <string>
 #include <chrono>
+#include <future>
+#include <memory>
 #include <opencv2/core.hpp>
+#include "admission_control.h"
+#include "clock_sync.h"
+#include "fixed_lag_smoother.h"
+#include "jpda.h"
 #include "kalman_filter.h"
+#include "multicast_sink.h"
+#include "sensor_measurement.h"
+#include "checkpoint.h"
+#include "shm_ingest.h"
+#include "spatial_index.h"
+#include "track_history.h"
+#include "track_store.h"
+#include "fused_track_table.h"
+#include "truth_store.h"
+#include "track_evaluator.h"
 
 #include "fusion/fusion.grpc.pb.h"
 #include "sensors/uav.pb.h"
@@ -17,18 +36,6 @@
 #include "sensors/sigint.pb.h"
 #include "common/geo.pb.h"
 
-// Raw sensor measurement structure
-struct SensorMeasurement
-{
-    uint64_t timestamp;
-    std::string sensor_type;
-    std::string sensor_id;
-    double lat;
-    double lon;
-    double alt;
-    std::string extras;
-};
-
 // Fusion service class
 class FusionServiceImpl final : public fusion::FusionService::Service
 {
@@ -40,8 +47,25 @@ public:
     //  IMPORTANT: These members are public so main.cpp's MonitorService
     //  can access the fused tracks and mutex.
     // ============================================================
-    std::unordered_map<uint32_t, fusion::FusedTrack> fused_tracks_;
+    // Published track messages are recycled through the slab, so track
+    // churn does not allocate.
+    FusedTrackTable fused_tracks_;
     std::mutex mtx_;
+
+    // Signalled (under mtx_) after every fusion cycle that published tracks,
+    // so continuous monitor subscribers can push the new picture.
+    std::condition_variable publish_cv_;
+    uint64_t publish_seq_ = 0;
+
+    // Grid index over fused_tracks_ positions for region/radius queries (guarded by mtx_).
+    SpatialIndex spatial_index_;
+
+    // Bounded per-track trail of fused positions (guarded by mtx_).
+    TrackHistoryStore track_history_;
+
+    // Fixed-lag smoothed tracks, published with the same cycle as
+    // fused_tracks_ for monitor requests that ask for them (guarded by mtx_).
+    FusedTrackTable smoothed_tracks_;
     // ============================================================
 
     grpc::Status StreamUAV(grpc::ServerContext *context, grpc::ServerReader<sensors::UAVTelemetry> *reader, fusion::FusionAck *ack) override;
@@ -50,22 +74,99 @@ public:
 
     void StartTimeoutThread(int duration_sec);
 
+    // Track migration between shards. Both run on the fusion thread between
+    // cycles; the caller waits up to one second for it.
+    bool ExportTrack(const std::string &external_id, fusion::TrackHandoff &out);
+    bool ImportTrack(const fusion::TrackHandoff &in);
+
 private:
     // Background thread and queue management
     std::thread fusion_thread_;
-    bool running_ = true;
+    std::atomic<bool> running_{true};
     std::deque<SensorMeasurement> queue_;
     std::mutex queue_mtx_;
+    AdmissionControl admission_; // Bounds queue_; guarded by queue_mtx_
+    ClockSync clock_sync_;       // Fusion thread only
+
+    struct HandoffRequest
+    {
+        bool is_export;
+        fusion::TrackHandoff handoff; // Export: filled by the loop. Import: input.
+        std::promise<bool> done;
+    };
+    std::deque<std::shared_ptr<HandoffRequest>> handoffs_; // Guarded by queue_mtx_
+
+    // One sensor scan's candidates for a track under JPDA, with their
+    // association probabilities and the covariance they share in the update.
+    struct PdaScan
+    {
+        std::vector<const SensorMeasurement *> measurements;
+        std::vector<double> beta;
+        double r_nn, r_ne, r_ee;
+    };
+    using TrackBatches = std::map<uint32_t, std::vector<const SensorMeasurement *>>;
 
     void FusionLoop();
+    void ProcessBatch(const std::deque<SensorMeasurement> &batch, const std::string &report_path);
+    bool SubmitHandoff(const std::shared_ptr<HandoffRequest> &req);
+    void ApplyExport(fusion::TrackHandoff &handoff);
+    void ApplyImport(const fusion::TrackHandoff &handoff);
+
+    // Targets exported to another shard, with the export time. Measurements
+    // of them still in flight from the router are dropped instead of
+    // starting a new track, until handoff_tombstone_ has passed or the
+    // track is imported back. Fusion thread only.
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> handed_off_;
+    std::chrono::milliseconds handoff_tombstone_{5000};
+    bool HandedOff(const std::string &ext_id);
 
-    // Kalman and auxiliary data
-    std::unordered_map<uint32_t, KalmanFilter> kf_map_;
-    std::map<uint64_t, common::GeoPoint> ground_truth_buffer_;
+    // Kalman and auxiliary data. Filters live compactly in track_store_ and
+    // are worked on one at a time in filter_. Fusion thread only.
+    TrackStore track_store_;
+    KalmanFilter filter_;
+    std::vector<uint32_t> evicted_; // Evicted by track_store_, not yet dropped
+    void DropEvicted();
+    TruthStore truth_;          // UAV self-reported positions, time-indexed per track
+    TrackEvaluator evaluator_;  // Running accuracy/consistency per track
     std::unordered_map<std::string, uint32_t> ext_to_int_id_;
+    std::unordered_map<uint32_t, std::string> int_to_ext_id_;
+    std::unordered_map<uint32_t, common::GeoPoint> uav_reports_;
+    std::unordered_map<uint32_t, uint64_t> last_fusion_time_; // ns, fusion clock (time_ns)
+    // Consecutive cycles without a gated measurement; a track past
+    // converged_cycles_ is reported converged to admission control.
+    std::unordered_map<uint32_t, uint32_t> settled_cycles_;
+    uint32_t converged_cycles_;
     uint32_t next_id_ = 1;
     common::GeoPoint radar_position_;
 
+    // Measurements from co-located sensors' shared-memory rings (SHM_INGEST).
+    std::unique_ptr<ShmIngest> shm_ingest_;
+
+    // Crash recovery (CHECKPOINT_DIR; disabled when empty). Fusion thread only.
+    std::string checkpoint_dir_;
+    std::chrono::milliseconds checkpoint_interval_{1000};
+    std::unique_ptr<checkpoint::CheckpointWriter> checkpoint_writer_;
+    std::unique_ptr<checkpoint::Journal> journal_;
+    std::chrono::steady_clock::time_point last_checkpoint_;
+    bool checkpoint_due_ = false;
+    void TakeCheckpoint();
+    void RestoreCheckpoint(const std::string &report_path);
+
+    // Association by measurement position (FUSION_ASSOCIATION=jpda) instead
+    // of by target id; null in id mode. Fusion thread only.
+    std::unique_ptr<jpda::Associator> jpda_;
+    jpda::Result jpda_result_;
+    void AssociateJpda(const std::vector<const SensorMeasurement *> &radar, TrackBatches &track_batches,
+                       std::map<uint32_t, std::vector<PdaScan>> &pda_scans);
+
+    // Fixed-lag RTS smoother over the filter cycles (SMOOTHER_LAG; null when
+    // 0). Fusion thread only.
+    std::unique_ptr<FixedLagSmoother> smoother_;
+
+    // Fused picture over UDP multicast (MULTICAST_GROUP; null when unset).
+    // Fusion thread only.
+    std::unique_ptr<MulticastSink> multicast_;
+
     // Helper metodlar
     uint32_t ResolveId(const std::string &ext_id);
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "fusion_shard.h"
+
+FusionShardServiceImpl::FusionShardServiceImpl(FusionServiceImpl& fusion)
+    : fusion_(fusion)
+{}
+
+grpc::Status FusionShardServiceImpl::ExportTrack(grpc::ServerContext* /*context*/,
+                                                 const fusion::TrackExportRequest* request,
+                                                 fusion::TrackHandoff* response)
+{
+    if (!fusion_.ExportTrack(request->external_id(), *response))
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "fusion loop did not answer");
+    return grpc::Status::OK;
+}
+
+grpc::Status FusionShardServiceImpl::ImportTrack(grpc::ServerContext* /*context*/,
+                                                 const fusion::TrackHandoff* request,
+                                                 fusion::FusionAck* response)
+{
+    if (!fusion_.ImportTrack(*request))
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "fusion loop did not answer");
+    response->set_ok(true);
+    response->set_message("imported " + request->external_id());
+    return grpc::Status::OK;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include "fusion/fusion.grpc.pb.h"
+#include "fusion_service.h"
+
+// Handoff endpoint of a fusion shard. Served next to FusionService so the
+// router reaches both on the same address.
+class FusionShardServiceImpl final : public fusion::FusionShard::Service {
+public:
+    explicit FusionShardServiceImpl(FusionServiceImpl& fusion);
+
+    grpc::Status ExportTrack(grpc::ServerContext* context,
+                             const fusion::TrackExportRequest* request,
+                             fusion::TrackHandoff* response) override;
+
+    grpc::Status ImportTrack(grpc::ServerContext* context,
+                             const fusion::TrackHandoff* request,
+                             fusion::FusionAck* response) override;
+
+private:
+    FusionServiceImpl& fusion_;
+};
@@ -0,0 +1,407 @@
+#include "jpda.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "config.h"
+
+namespace jpda {
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+    constexpr size_t PARALLEL_MIN_EDGES = 256; // Below this, waking the solvers costs more than it saves
+    constexpr int64_t CELL_OFFSET = 1 << 30;   // Keeps cell coordinates positive in the key
+
+    double MaxEigen(double a, double b, double c)
+    {
+        double h = 0.5 * (a - c);
+        return 0.5 * (a + c) + std::sqrt(h * h + b * b);
+    }
+
+    uint64_t CellKey(int64_t row, int64_t col)
+    {
+        return ((uint64_t)(row + CELL_OFFSET) << 32) | (uint64_t)(col + CELL_OFFSET);
+    }
+
+    uint32_t Find(std::vector<uint32_t> &parent, uint32_t x)
+    {
+        while (parent[x] != x)
+        {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+}
+
+Config Config::FromEnv()
+{
+    Config c;
+    c.detection_probability = std::min(std::max(utils::GetEnvDouble("JPDA_PD", c.detection_probability), 0.01), 0.999);
+    c.gate = utils::GetEnvDouble("JPDA_GATE", c.gate);
+    c.clutter_density = std::max(utils::GetEnvDouble("JPDA_CLUTTER_DENSITY", c.clutter_density), 1e-12);
+    c.max_hypotheses = (size_t)utils::GetEnvDouble("JPDA_MAX_HYPOTHESES", (double)c.max_hypotheses);
+    c.threads = (unsigned)utils::GetEnvDouble("JPDA_THREADS", c.threads);
+    return c;
+}
+
+void PolarCovariance(double range_m, double bearing_deg, double range_sigma_m, double bearing_sigma_deg,
+                     double &r_nn, double &r_ne, double &r_ee)
+{
+    // Range error along the line of sight, bearing error across it.
+    double b = bearing_deg * M_PI / 180.0;
+    double along = range_sigma_m * range_sigma_m;
+    double cross = range_m * bearing_sigma_deg * M_PI / 180.0;
+    cross *= cross;
+    double c = std::cos(b), s = std::sin(b);
+    r_nn = along * c * c + cross * s * s;
+    r_ne = (along - cross) * c * s;
+    r_ee = along * s * s + cross * c * c;
+}
+
+Associator::Associator(const Config &config) : config_(config), clutter_per_m2_(config.clutter_density / 1e6)
+{
+    if (config_.threads == 0)
+        config_.threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned w = 1; w < config_.threads; ++w)
+        workers_.emplace_back(&Associator::WorkerLoop, this);
+}
+
+Associator::~Associator()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mtx_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &t : workers_)
+        t.join();
+}
+
+void Associator::ParallelFor(size_t n, const std::function<void(size_t)> &fn)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mtx_);
+        job_ = &fn;
+        job_size_ = n;
+        next_index_ = 0;
+        running_ = workers_.size();
+        ++generation_;
+    }
+    work_cv_.notify_all();
+    for (size_t i; (i = next_index_.fetch_add(1)) < n;)
+        fn(i);
+
+    std::unique_lock<std::mutex> lock(pool_mtx_);
+    done_cv_.wait(lock, [&] { return running_ == 0; });
+    job_ = nullptr;
+}
+
+void Associator::WorkerLoop()
+{
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(pool_mtx_);
+    while (true)
+    {
+        work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_)
+            break;
+        seen = generation_;
+        const std::function<void(size_t)> &fn = *job_;
+        const size_t n = job_size_;
+        lock.unlock();
+        for (size_t i; (i = next_index_.fetch_add(1)) < n;)
+            fn(i);
+        lock.lock();
+        if (--running_ == 0)
+            done_cv_.notify_one();
+    }
+}
+
+void Associator::Associate(const std::vector<Track> &tracks, const std::vector<Measurement> &measurements,
+                           Result &out)
+{
+    out.tracks.assign(tracks.size(), {});
+    out.gated.assign(measurements.size(), 0);
+    out.clusters = out.approximated = out.largest = 0;
+    if (tracks.empty() || measurements.empty())
+        return;
+
+    Gate(tracks, measurements);
+    if (edges_.empty())
+        return;
+    Cluster(tracks.size(), measurements.size());
+
+    std::vector<char> approximated(clusters_.size(), 0);
+    std::function<void(size_t)> solve = [&](size_t c)
+    {
+        bool approx = false;
+        Solve(clusters_[c], approx);
+        approximated[c] = approx;
+    };
+    // Clusters share no tracks or measurements, so they write disjoint edges.
+    if (!workers_.empty() && clusters_.size() > 1 && edges_.size() >= PARALLEL_MIN_EDGES)
+    {
+        ParallelFor(clusters_.size(), solve);
+    }
+    else
+    {
+        for (size_t c = 0; c < clusters_.size(); ++c)
+            solve(c);
+    }
+
+    for (const Edge &e : edges_)
+    {
+        out.tracks[e.track].push_back({e.measurement, e.beta});
+        out.gated[e.measurement] = 1;
+    }
+    out.clusters = clusters_.size();
+    for (size_t c = 0; c < clusters_.size(); ++c)
+    {
+        out.approximated += approximated[c];
+        out.largest = std::max(out.largest, clusters_[c].size());
+    }
+}
+
+void Associator::Gate(const std::vector<Track> &tracks, const std::vector<Measurement> &measurements)
+{
+    // Gate radius bound per track: gate * largest eigenvalue of P + R.
+    double r_max = 0.0;
+    for (const Measurement &m : measurements)
+        r_max = std::max(r_max, MaxEigen(m.r_nn, m.r_ne, m.r_ee));
+    std::vector<double> radius(tracks.size());
+    for (size_t t = 0; t < tracks.size(); ++t)
+        radius[t] = std::sqrt(config_.gate * (MaxEigen(tracks[t].p_nn, tracks[t].p_ne, tracks[t].p_ee) + r_max));
+
+    // Cell size: the median gate, so a typical track reads about 3x3 cells.
+    std::vector<double> sorted(radius);
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    const double cell = std::max(sorted[sorted.size() / 2], 1.0);
+    const double lat0 = measurements.front().lat;
+    const double kn = METERS_PER_DEG_LAT / cell;
+    const double ke = METERS_PER_DEG_LAT * std::cos(lat0 * M_PI / 180.0) / cell;
+
+    cells_.clear();
+    for (uint32_t j = 0; j < measurements.size(); ++j)
+    {
+        int64_t row = (int64_t)std::floor(measurements[j].lat * kn);
+        int64_t col = (int64_t)std::floor(measurements[j].lon * ke);
+        cells_.emplace_back(CellKey(row, col), j);
+    }
+    std::sort(cells_.begin(), cells_.end());
+
+    edges_.clear();
+    edge_begin_.assign(tracks.size() + 1, 0);
+    const double pd = config_.detection_probability;
+    for (uint32_t t = 0; t < tracks.size(); ++t)
+    {
+        const Track &tr = tracks[t];
+        edge_begin_[t] = (uint32_t)edges_.size();
+        const double m_lon = METERS_PER_DEG_LAT * std::cos(tr.lat * M_PI / 180.0);
+
+        auto test = [&](uint32_t j)
+        {
+            const Measurement &m = measurements[j];
+            double dn = (m.lat - tr.lat) * METERS_PER_DEG_LAT;
+            double de = (m.lon - tr.lon) * m_lon;
+            double s_nn = tr.p_nn + m.r_nn, s_ne = tr.p_ne + m.r_ne, s_ee = tr.p_ee + m.r_ee;
+            double det = s_nn * s_ee - s_ne * s_ne;
+            if (det <= 0.0)
+                return;
+            double nis = (s_ee * dn * dn - 2.0 * s_ne * dn * de + s_nn * de * de) / det;
+            if (nis > config_.gate)
+                return;
+            double likelihood = std::exp(-0.5 * nis) / (2.0 * M_PI * std::sqrt(det));
+            edges_.push_back({t, j, pd * likelihood / clutter_per_m2_, 0.0});
+        };
+
+        int64_t row0 = (int64_t)std::floor(tr.lat * kn - radius[t] / cell);
+        int64_t row1 = (int64_t)std::floor(tr.lat * kn + radius[t] / cell);
+        int64_t col0 = (int64_t)std::floor(tr.lon * ke - radius[t] / cell);
+        int64_t col1 = (int64_t)std::floor(tr.lon * ke + radius[t] / cell);
+        if ((uint64_t)(row1 - row0 + 1) > measurements.size())
+        {
+            // A gate wider than the scan's cell count: test everything.
+            for (uint32_t j = 0; j < measurements.size(); ++j)
+                test(j);
+            continue;
+        }
+        for (int64_t row = row0; row <= row1; ++row)
+        {
+            auto it = std::lower_bound(cells_.begin(), cells_.end(), std::make_pair(CellKey(row, col0), 0u));
+            const uint64_t end = CellKey(row, col1);
+            for (; it != cells_.end() && it->first <= end; ++it)
+                test(it->second);
+        }
+    }
+    edge_begin_[tracks.size()] = (uint32_t)edges_.size();
+}
+
+void Associator::Cluster(size_t n_tracks, size_t n_measurements)
+{
+    parent_.resize(n_tracks + n_measurements);
+    for (uint32_t i = 0; i < parent_.size(); ++i)
+        parent_[i] = i;
+    for (const Edge &e : edges_)
+    {
+        uint32_t a = Find(parent_, e.track), b = Find(parent_, (uint32_t)n_tracks + e.measurement);
+        if (a != b)
+            parent_[a] = b;
+    }
+
+    clusters_.clear();
+    std::vector<int32_t> cluster_of(parent_.size(), -1);
+    for (uint32_t t = 0; t < n_tracks; ++t)
+    {
+        if (edge_begin_[t] == edge_begin_[t + 1])
+            continue;
+        uint32_t root = Find(parent_, t);
+        if (cluster_of[root] < 0)
+        {
+            cluster_of[root] = (int32_t)clusters_.size();
+            clusters_.emplace_back();
+        }
+        clusters_[cluster_of[root]].push_back(t);
+    }
+    measurement_ratio_.assign(n_measurements, 0.0);
+    local_.assign(n_measurements, 0);
+}
+
+void Associator::Solve(const std::vector<uint32_t> &cluster, bool &approximated)
+{
+    approximated = !SolveExact(cluster);
+    if (approximated)
+        SolveApproximate(cluster);
+}
+
+bool Associator::SolveExact(const std::vector<uint32_t> &cluster)
+{
+    // Number the cluster's measurements.
+    uint32_t n_local = 0;
+    for (uint32_t t : cluster)
+    {
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+            local_[edges_[e].measurement] = UINT32_MAX;
+    }
+    for (uint32_t t : cluster)
+    {
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+        {
+            uint32_t &l = local_[edges_[e].measurement];
+            if (l == UINT32_MAX)
+                l = n_local++;
+        }
+    }
+
+    // Depth-first over the feasible joint events: each track takes one free
+    // measurement in its gate or none. An event weighs the product of its
+    // assignments' likelihood ratios and (1 - P_D) per undetected track.
+    const double miss = 1.0 - config_.detection_probability;
+    const size_t depth = cluster.size();
+    std::vector<char> used(n_local, 0);
+    std::vector<uint32_t> path(depth, UINT32_MAX);    // Chosen edge per track, or none
+    std::vector<double> weight(depth + 1, 1.0);       // Product down to each level
+    std::vector<uint32_t> next(depth, 0);             // Next option per level: 0 = none, then edges
+    double total = 0.0;
+    size_t events = 0;
+
+    // Event weights accumulate in the edges' beta, normalized at the end.
+    for (uint32_t t : cluster)
+    {
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+            edges_[e].beta = 0.0;
+    }
+    size_t level = 0;
+    while (true)
+    {
+        if (level == depth)
+        {
+            if (++events > config_.max_hypotheses)
+                return false;
+            double w = weight[depth];
+            total += w;
+            for (uint32_t e : path)
+            {
+                if (e != UINT32_MAX)
+                    edges_[e].beta += w;
+            }
+            --level;
+            continue;
+        }
+
+        uint32_t t = cluster[level];
+        uint32_t option = next[level];
+        // Release the previous choice at this level.
+        if (path[level] != UINT32_MAX)
+        {
+            used[local_[edges_[path[level]].measurement]] = 0;
+            path[level] = UINT32_MAX;
+        }
+        uint32_t n_edges = edge_begin_[t + 1] - edge_begin_[t];
+        if (option > n_edges)
+        {
+            next[level] = 0;
+            if (level == 0)
+                break;
+            --level;
+            continue;
+        }
+        next[level] = option + 1;
+        if (option == 0)
+        {
+            weight[level + 1] = weight[level] * miss;
+        }
+        else
+        {
+            uint32_t e = edge_begin_[t] + option - 1;
+            uint32_t l = local_[edges_[e].measurement];
+            if (used[l])
+                continue;
+            used[l] = 1;
+            path[level] = e;
+            weight[level + 1] = weight[level] * edges_[e].ratio;
+        }
+        ++level;
+    }
+
+    if (!(total > 0.0) || !std::isfinite(total))
+        return false;
+    for (uint32_t t : cluster)
+    {
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+            edges_[e].beta /= total;
+    }
+    return true;
+}
+
+void Associator::SolveApproximate(const std::vector<uint32_t> &cluster)
+{
+    // Cheap JPDA: beta_tj = G_tj / (T_t + M_j - G_tj + B), where T_t and M_j
+    // sum the likelihood ratios over the track's and the measurement's pairs
+    // and B = 1 - P_D. Exact for a single track and measurement.
+    const double bias = 1.0 - config_.detection_probability;
+    for (uint32_t t : cluster)
+    {
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+            measurement_ratio_[edges_[e].measurement] = 0.0;
+    }
+    for (uint32_t t : cluster)
+    {
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+            measurement_ratio_[edges_[e].measurement] += edges_[e].ratio;
+    }
+    for (uint32_t t : cluster)
+    {
+        double track_ratio = 0.0;
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+            track_ratio += edges_[e].ratio;
+        for (uint32_t e = edge_begin_[t]; e < edge_begin_[t + 1]; ++e)
+        {
+            Edge &edge = edges_[e];
+            edge.beta = edge.ratio / (track_ratio + measurement_ratio_[edge.measurement] - edge.ratio + bias);
+        }
+    }
+}
+
+} // namespace jpda
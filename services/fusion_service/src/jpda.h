@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Joint probabilistic data association for one scan of one sensor.
+//
+// Measurements are sorted into a coarse grid so each track only tests the
+// ones near it; a pair is gated when the innovation's chi-square in local
+// meters is under the gate. Gated pairs link tracks and measurements into
+// independent clusters (union-find), which are solved in parallel on the
+// associator's own solver threads. A
+// cluster is enumerated exactly while its feasible joint events stay under
+// max_hypotheses; past that it falls back to the cheap JPDA approximation
+// (Fitzgerald), linear in the cluster's gated pairs. Cost therefore grows
+// with the number of gated pairs, not with the joint events of the scene.
+namespace jpda {
+
+struct Config
+{
+    double detection_probability = 0.9; // JPDA_PD
+    double gate = 9.21;                 // JPDA_GATE, chi-square with 2 dof (99%)
+    double clutter_density = 1e-3;      // JPDA_CLUTTER_DENSITY, false alarms per km^2 per scan
+    size_t max_hypotheses = 10000;      // JPDA_MAX_HYPOTHESES, joint events per exact cluster
+    unsigned threads = 0;               // JPDA_THREADS, 0 = hardware concurrency
+
+    static Config FromEnv();
+};
+
+// A track predicted to the scan time.
+struct Track
+{
+    double lat, lon;            // degrees
+    double p_nn, p_ne, p_ee;    // Position covariance, m^2 north/east
+};
+
+struct Measurement
+{
+    double lat, lon;            // degrees
+    double r_nn, r_ne, r_ee;    // Covariance, m^2 north/east
+};
+
+// North/east covariance (m^2) of a position measured as range and bearing.
+void PolarCovariance(double range_m, double bearing_deg, double range_sigma_m, double bearing_sigma_deg,
+                     double &r_nn, double &r_ne, double &r_ee);
+
+struct Association
+{
+    uint32_t measurement;
+    double beta;                // Probability that the measurement is the track's
+};
+
+struct Result
+{
+    // Per track; the probability that none of its measurements is the
+    // track's is 1 - sum(beta). Empty when nothing fell in its gate.
+    std::vector<std::vector<Association>> tracks;
+    std::vector<char> gated;    // Per measurement: inside at least one gate
+    size_t clusters = 0;
+    size_t approximated = 0;    // Clusters solved with the approximation
+    size_t largest = 0;         // Tracks in the largest cluster
+};
+
+class Associator
+{
+public:
+    // Starts config.threads - 1 solver threads; the caller of Associate is
+    // the last one. Not copyable; use from one thread at a time.
+    explicit Associator(const Config &config);
+    ~Associator();
+    Associator(const Associator &) = delete;
+    Associator &operator=(const Associator &) = delete;
+
+    void Associate(const std::vector<Track> &tracks, const std::vector<Measurement> &measurements, Result &out);
+
+    const Config &config() const { return config_; }
+
+private:
+    struct Edge
+    {
+        uint32_t track;
+        uint32_t measurement;
+        double ratio;           // P_D * likelihood / clutter density
+        double beta;
+    };
+
+    void Gate(const std::vector<Track> &tracks, const std::vector<Measurement> &measurements);
+    void Cluster(size_t n_tracks, size_t n_measurements);
+    void Solve(const std::vector<uint32_t> &cluster, bool &approximated);
+    bool SolveExact(const std::vector<uint32_t> &cluster);
+    void SolveApproximate(const std::vector<uint32_t> &cluster);
+
+    // Runs fn(0 .. n-1) on the solver threads and the calling thread.
+    void ParallelFor(size_t n, const std::function<void(size_t)> &fn);
+    void WorkerLoop();
+
+    Config config_;
+    double clutter_per_m2_;
+
+    // Scratch, reused across scans. Edges are grouped by track:
+    // edges_[edge_begin_[t] .. edge_begin_[t + 1]).
+    std::vector<Edge> edges_;
+    std::vector<uint32_t> edge_begin_;
+    std::vector<std::pair<uint64_t, uint32_t>> cells_;  // (grid cell, measurement), sorted
+    std::vector<uint32_t> parent_;                       // Union-find over tracks, then measurements
+    std::vector<std::vector<uint32_t>> clusters_;        // Track indices per cluster
+    std::vector<double> measurement_ratio_;              // Per measurement, for the approximation
+    std::vector<uint32_t> local_;                        // Measurement index within its cluster
+
+    // Solver threads. A job is published under pool_mtx_ by bumping
+    // generation_; indices are claimed through next_index_.
+    std::vector<std::thread> workers_;
+    std::mutex pool_mtx_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t)> *job_ = nullptr;
+    size_t job_size_ = 0;
+    std::atomic<size_t> next_index_{0};
+    uint64_t generation_ = 0;
+    size_t running_ = 0;                                 // Workers still on the current job
+    bool stop_ = false;
+};
+
+} // namespace jpda
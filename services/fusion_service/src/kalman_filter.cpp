@@ -1,8 +1,28 @@
 #include "kalman_filter.h"
 #include <opencv2/core.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace {
     constexpr double DEFAULT_Q = 0.01; // Increased slightly to allow maneuverability
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+    constexpr double R_SCALE = 0.1; // R_ per unit of noise_scale
+
+    // Normalized innovation squared, with the innovation (deg) taken to
+    // local meters and S to m^2, the scale GetPositionCovariance reports.
+    double Nis(double y_lat, double y_lon, double lat, const cv::Mat &S)
+    {
+        double dn = y_lat * METERS_PER_DEG_LAT;
+        double de = y_lon * METERS_PER_DEG_LAT * std::cos(lat * M_PI / 180.0);
+        double s_nn = S.at<double>(0, 0) / R_SCALE;
+        double s_ne = S.at<double>(0, 1) / R_SCALE;
+        double s_ee = S.at<double>(1, 1) / R_SCALE;
+        double det = s_nn * s_ee - s_ne * s_ne;
+        if (det <= 0.0)
+            return -1.0;
+        return (s_ee * dn * dn - 2.0 * s_ne * dn * de + s_nn * de * de) / det;
+    }
 }
 
 KalmanFilter::KalmanFilter()
@@ -10,7 +30,20 @@ KalmanFilter::KalmanFilter()
     state_ = cv::Mat::zeros(4, 1, CV_64F);
     P_ = cv::Mat::eye(4, 4, CV_64F) * 100.0;
     Q_ = cv::Mat::eye(4, 4, CV_64F) * DEFAULT_Q;
-    R_ = cv::Mat::eye(2, 2, CV_64F) * 0.1;
+    R_ = cv::Mat::eye(2, 2, CV_64F) * R_SCALE;
+}
+
+void KalmanFilter::Reset()
+{
+    // In place, so a reused filter keeps its buffers
+    for (int i = 0; i < 4; ++i)
+    {
+        state_.at<double>(i) = 0.0;
+        for (int j = 0; j < 4; ++j)
+            P_.at<double>(i, j) = (i == j) ? 100.0 : 0.0;
+    }
+    initialized_ = false;
+    last_nis_ = -1.0;
 }
 
 void KalmanFilter::Initialize(double lat, double lon)
@@ -42,6 +75,7 @@ void KalmanFilter::Update(double meas_lat, double meas_lon, double noise_scale)
     if (!initialized_)
     {
         Initialize(meas_lat, meas_lon);
+        last_nis_ = -1.0;
         return;
     }
 
@@ -53,12 +87,93 @@ void KalmanFilter::Update(double meas_lat, double meas_lon, double noise_scale)
     cv::Mat z = (cv::Mat_<double>(2, 1) << meas_lat, meas_lon);
     cv::Mat y = z - H * state_;
     cv::Mat S = H * P_ * H.t() + R_curr;
-    cv::Mat K = P_ * H.t() * S.inv();
+    cv::Mat S_inv = S.inv();
+    cv::Mat K = P_ * H.t() * S_inv;
+    last_nis_ = Nis(y.at<double>(0), y.at<double>(1), state_.at<double>(0), S);
+
+    state_ = state_ + K * y;
+    P_ = (cv::Mat::eye(4, 4, CV_64F) - K * H) * P_;
+}
+
+void KalmanFilter::UpdateRangeRate(double range_rate, double bearing_deg, double sigma_mps)
+{
+    if (!initialized_ || sigma_mps <= 0.0)
+        return;
+
+    // Measured in deg/s along the bearing, with the noise scaled the way
+    // Update scales position noise (R_ * sigma^2), so Doppler and position
+    // updates are weighted consistently against Q_.
+    double b = bearing_deg * M_PI / 180.0;
+    double cos_lat = std::cos(state_.at<double>(0) * M_PI / 180.0);
+    cv::Mat H = cv::Mat::zeros(1, 4, CV_64F);
+    H.at<double>(0, 2) = std::cos(b);
+    H.at<double>(0, 3) = cos_lat * std::sin(b);
+
+    double z = range_rate / METERS_PER_DEG_LAT;
+    double y = z - cv::Mat(H * state_).at<double>(0);
+    double S = cv::Mat(H * P_ * H.t()).at<double>(0) + R_.at<double>(0, 0) * sigma_mps * sigma_mps;
+    cv::Mat K = P_ * H.t() / S;
 
     state_ = state_ + K * y;
     P_ = (cv::Mat::eye(4, 4, CV_64F) - K * H) * P_;
 }
 
+void KalmanFilter::PredictPosition(double dt, double &lat, double &lon,
+                                   double &p_nn, double &p_ne, double &p_ee) const
+{
+    // Position block of F P F' + Q
+    const cv::Mat &P = P_;
+    lat = state_.at<double>(0) + dt * state_.at<double>(2);
+    lon = state_.at<double>(1) + dt * state_.at<double>(3);
+    double p00 = P.at<double>(0, 0) + 2.0 * dt * P.at<double>(0, 2) + dt * dt * P.at<double>(2, 2) + Q_.at<double>(0, 0);
+    double p01 = P.at<double>(0, 1) + dt * (P.at<double>(0, 3) + P.at<double>(2, 1)) + dt * dt * P.at<double>(2, 3) +
+                 Q_.at<double>(0, 1);
+    double p11 = P.at<double>(1, 1) + 2.0 * dt * P.at<double>(1, 3) + dt * dt * P.at<double>(3, 3) + Q_.at<double>(1, 1);
+    p_nn = p00 / R_SCALE;
+    p_ne = p01 / R_SCALE;
+    p_ee = p11 / R_SCALE;
+}
+
+void KalmanFilter::UpdatePda(const double *lat, const double *lon, const double *beta, size_t n,
+                             double r_nn, double r_ne, double r_ee)
+{
+    if (!initialized_ || n == 0)
+        return;
+
+    cv::Mat H = cv::Mat::zeros(2, 4, CV_64F);
+    H.at<double>(0, 0) = 1.0;
+    H.at<double>(1, 1) = 1.0;
+    cv::Mat R = (cv::Mat_<double>(2, 2) << r_nn, r_ne, r_ne, r_ee);
+
+    cv::Mat S = H * P_ * H.t() + R * R_SCALE;
+    cv::Mat S_inv = S.inv();
+    cv::Mat K = P_ * H.t() * S_inv;
+
+    // Combined innovation and the spread of the candidates around it. The
+    // spread goes into P, so it is taken in meters on P's scale.
+    const double m_lat = METERS_PER_DEG_LAT;
+    const double m_lon = METERS_PER_DEG_LAT * std::cos(state_.at<double>(0) * M_PI / 180.0);
+    cv::Mat nu = cv::Mat::zeros(2, 1, CV_64F);
+    cv::Mat spread = cv::Mat::zeros(2, 2, CV_64F);
+    double beta_sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        cv::Mat y = (cv::Mat_<double>(2, 1) << lat[i] - state_.at<double>(0), lon[i] - state_.at<double>(1));
+        cv::Mat y_m = (cv::Mat_<double>(2, 1) << y.at<double>(0) * m_lat, y.at<double>(1) * m_lon);
+        nu = nu + y * beta[i];
+        spread = spread + y_m * y_m.t() * beta[i];
+        beta_sum += beta[i];
+    }
+    cv::Mat nu_m = (cv::Mat_<double>(2, 1) << nu.at<double>(0) * m_lat, nu.at<double>(1) * m_lon);
+    spread = (spread - nu_m * nu_m.t()) * R_SCALE;
+    double beta0 = std::min(std::max(1.0 - beta_sum, 0.0), 1.0);
+    last_nis_ = Nis(nu.at<double>(0), nu.at<double>(1), state_.at<double>(0), S);
+
+    state_ = state_ + K * nu;
+    cv::Mat P_updated = P_ - K * S * K.t();
+    P_ = P_ * beta0 + P_updated * (1.0 - beta0) + K * spread * K.t();
+}
+
 void KalmanFilter::GetState(double &lat, double &lon, double &v_lat, double &v_lon) const
 {
     lat = state_.at<double>(0);
@@ -71,3 +186,39 @@ double KalmanFilter::GetCovarianceTrace() const
 {
     return cv::trace(P_)[0];
 }
+
+void KalmanFilter::GetPositionCovariance(double &p_nn, double &p_ne, double &p_ee) const
+{
+    p_nn = P_.at<double>(0, 0) / R_SCALE;
+    p_ne = P_.at<double>(0, 1) / R_SCALE;
+    p_ee = P_.at<double>(1, 1) / R_SCALE;
+}
+
+void KalmanFilter::PositionCovariance(const double cov[16], double &p_nn, double &p_ne, double &p_ee)
+{
+    p_nn = cov[0] / R_SCALE;
+    p_ne = cov[1] / R_SCALE;
+    p_ee = cov[5] / R_SCALE;
+}
+
+void KalmanFilter::ExportState(double state[4], double cov[16]) const
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        state[i] = state_.at<double>(i);
+        for (int j = 0; j < 4; ++j)
+            cov[i * 4 + j] = P_.at<double>(i, j);
+    }
+}
+
+void KalmanFilter::ImportState(const double state[4], const double cov[16])
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        state_.at<double>(i) = state[i];
+        for (int j = 0; j < 4; ++j)
+            P_.at<double>(i, j) = cov[i * 4 + j];
+    }
+    initialized_ = true;
+    last_nis_ = -1.0;
+}
@@ -8,12 +8,55 @@ class KalmanFilter {
 public:
     KalmanFilter();
     void Initialize(double lat, double lon);
+
+    // Back to the constructed, uninitialized state.
+    void Reset();
     void Predict(double dt_seconds);
     void Update(double meas_lat, double meas_lon, double noise_scale);
+
+    // EKF update with a radar range rate (m/s, positive opening) seen along
+    // `bearing_deg` from the radar, with noise sigma_mps. The measurement is
+    // linear in the velocity states, v_lat cos(b) + v_lon cos(lat) sin(b) in
+    // deg/s. Ignored before the first position update.
+    void UpdateRangeRate(double range_rate, double bearing_deg, double sigma_mps);
+
+    // Position and its covariance `dt_seconds` ahead, leaving the filter as
+    // it is. The covariance is in m^2 on the scale of Update's noise_scale
+    // (sigma^2 in meters; R_ holds 0.1 * sigma^2).
+    void PredictPosition(double dt_seconds, double &lat, double &lon,
+                         double &p_nn, double &p_ne, double &p_ee) const;
+
+    // Probabilistic data association update with `n` candidate positions.
+    // beta[i] is the probability that candidate i is the target, 1 - sum(beta)
+    // that none is; the candidates share one measurement covariance (m^2,
+    // north/east). The covariance grows with the spread of the candidates.
+    void UpdatePda(const double *lat, const double *lon, const double *beta, size_t n,
+                   double r_nn, double r_ne, double r_ee);
+
     void GetState(double &lat, double &lon, double &v_lat, double &v_lon) const;
     double GetCovarianceTrace() const;
 
+    // Position covariance in local m^2 (north/east). P is kept on the scale
+    // of R_ (R_SCALE * sigma^2, sigma in meters), so this is P / R_SCALE;
+    // every covariance that leaves the filter goes through this convention.
+    void GetPositionCovariance(double &p_nn, double &p_ne, double &p_ee) const;
+
+    // The same for a row-major 4x4 covariance taken with ExportState.
+    static void PositionCovariance(const double cov[16], double &p_nn, double &p_ne, double &p_ee);
+
+    // Normalized innovation squared of the last Update or UpdatePda, the
+    // innovation in local meters against S in m^2 (negative when that update
+    // only initialized the filter).
+    double GetLastNis() const { return last_nis_; }
+
+    // Raw state [lat, lon, v_lat, v_lon] and row-major 4x4 covariance, used
+    // to hand a track over to another fusion shard.
+    bool IsInitialized() const { return initialized_; }
+    void ExportState(double state[4], double cov[16]) const;
+    void ImportState(const double state[4], const double cov[16]);
+
 private:
     cv::Mat state_, P_, Q_, R_;
     bool initialized_ = false;
+    double last_nis_ = -1.0;
 };
@@ -1,5 +1,10 @@
 #include "fusion_service.h"
 #include "fusion_monitor.h"
+#include "fusion_shard.h"
+#include "config.h"
+#include "metrics/metrics.h"
+#include "metrics/http_server.h"
+#include "tracing/trace.h"
 #include <grpcpp/grpcpp.h>
 #include <iostream>
 #include <thread>
@@ -7,8 +12,13 @@
 
 int main()
 {
-    std::string fusion_address("0.0.0.0:6000");
-    std::string monitor_address("0.0.0.0:6005");
+    // Ports are configurable so several shards can run on one host.
+    std::string fusion_address("0.0.0.0:" + std::to_string((int)utils::GetEnvDouble("FUSION_PORT", 6000)));
+    std::string monitor_address("0.0.0.0:" + std::to_string((int)utils::GetEnvDouble("MONITOR_PORT", 6005)));
+
+    // Tracing is compiled in with FUSION_TRACING and switched on by TRACE_ENABLED=1
+    // or at runtime with POST /trace/start.
+    tracing::SetEnabled(utils::GetEnvString("TRACE_ENABLED", "0") == "1");
 
     FusionServiceImpl fusion_service;
 
@@ -26,18 +36,40 @@ int main()
     grpc::ServerBuilder fusion_builder;
     fusion_builder.AddListeningPort(fusion_address, grpc::InsecureServerCredentials());
     fusion_builder.RegisterService(&fusion_service);
+    FusionShardServiceImpl shard_service(fusion_service); // Track handoff (fusion_router)
+    fusion_builder.RegisterService(&shard_service);
     std::unique_ptr<grpc::Server> fusion_server(fusion_builder.BuildAndStart());
     std::cout << "[FusionService] Running at " << fusion_address << std::endl;
 
     // 2. Monitor server setup (for CLI/Web UI)
     // Get shared data and mutex from FusionService.
-    FusionMonitorServiceImpl monitor_service(fusion_service.mtx_, fusion_service.fused_tracks_);
+    FusionMonitorServiceImpl monitor_service(fusion_service.mtx_, fusion_service.fused_tracks_,
+                                             fusion_service.smoothed_tracks_,
+                                             fusion_service.publish_cv_, fusion_service.publish_seq_,
+                                             fusion_service.spatial_index_,
+                                             fusion_service.track_history_);
     grpc::ServerBuilder monitor_builder;
     monitor_builder.AddListeningPort(monitor_address, grpc::InsecureServerCredentials());
     monitor_builder.RegisterService(&monitor_service);
     std::unique_ptr<grpc::Server> monitor_server(monitor_builder.BuildAndStart());
     std::cout << "[FusionMonitor] Running at " << monitor_address << std::endl;
 
+    // 3. Prometheus-style metrics endpoint (METRICS_PORT=0 disables it). Loopback
+    // only unless METRICS_BIND says otherwise (the container sets 0.0.0.0).
+    int metrics_port = static_cast<int>(utils::GetEnvDouble("METRICS_PORT", 6010));
+    std::string metrics_bind = utils::GetEnvString("METRICS_BIND", "127.0.0.1");
+    metrics::HttpServer metrics_server(metrics_port, metrics_bind);
+    if (metrics_port > 0)
+    {
+        metrics_server.Handle("GET", "/metrics", "text/plain; version=0.0.4",
+                              [] { return metrics::Registry::Global().RenderPrometheus(); });
+        metrics_server.Handle("GET", "/trace", "application/json", [] { return tracing::DumpChromeJson(); });
+        metrics_server.Handle("POST", "/trace/start", "text/plain", [] { tracing::SetEnabled(true); return std::string("tracing on\n"); });
+        metrics_server.Handle("POST", "/trace/stop", "text/plain", [] { tracing::SetEnabled(false); return std::string("tracing off\n"); });
+        if (metrics_server.Start())
+            std::cout << "[Metrics] Serving /metrics on " << metrics_bind << ":" << metrics_port << std::endl;
+    }
+
     // Run the monitor in a separate thread
     std::thread monitor_thread([&monitor_server]() {
         std::cout << "Monitor Server Thread Started." << std::endl;
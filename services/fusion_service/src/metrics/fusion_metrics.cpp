@@ -0,0 +1,70 @@
+#include "metrics/fusion_metrics.h"
+
+namespace metrics {
+
+namespace {
+    constexpr double NS_TO_S = 1e-9;
+}
+
+FusionMetrics &FusionMetrics::Get()
+{
+    Registry &r = Registry::Global();
+    static FusionMetrics m{
+        r.GetGauge("fusion_queue_depth", "Measurements waiting in the ingest queue"),
+        r.GetGauge("fusion_admission_stage", "Ingest load-shedding stage (0 = admit all, 4 = queue full)"),
+        r.GetHistogram("fusion_batch_size", "Measurements processed per fusion cycle"),
+        r.GetHistogram("fusion_cycle_seconds", "Processing time of one fusion cycle", NS_TO_S),
+        r.GetCounter("fusion_filter_updates_total", "Kalman measurement updates applied"),
+        r.GetCounter("fusion_gate_rejections_total", "Measurements de-weighted by the innovation gate"),
+        r.GetCounter("fusion_doppler_updates_total", "Radar range-rate updates applied"),
+        r.GetCounter("fusion_jpda_clusters_total", "JPDA track/measurement clusters solved"),
+        r.GetCounter("fusion_jpda_approximated_total", "JPDA clusters solved with the cheap approximation"),
+        r.GetCounter("fusion_jpda_unassociated_total", "Radar detections outside every JPDA gate"),
+        r.GetGauge("fusion_tracks", "Fused tracks currently published"),
+        r.GetGauge("fusion_smoothed_tracks", "Fixed-lag smoothed tracks currently published"),
+        r.GetGauge("fusion_smoother_bytes", "Memory held by the fixed-lag smoother windows"),
+        r.GetGauge("fusion_track_store_bytes", "Memory held by the compact per-track filter states"),
+        r.GetCounter("fusion_track_evictions_total", "Coasting tracks dropped when the track store was full"),
+        r.GetCounter("fusion_handoff_dropped_total", "Measurements of targets already handed off to another shard"),
+        r.GetGauge("fusion_monitor_subscribers", "Open FusionMonitor subscriptions"),
+        r.GetCounter("fusion_monitor_frames_total", "Track pictures serialized for monitor subscribers"),
+        r.GetCounter("fusion_monitor_frames_conflated_total", "Monitor frames skipped for slow subscribers"),
+        r.GetHistogram("fusion_log_writer_lag_seconds", "Delay from measurement timestamp to CSV write", NS_TO_S),
+        r.GetCounter("fusion_multicast_datagrams_total", "Fused-track datagrams sent to the multicast group"),
+        r.GetCounter("fusion_multicast_bytes_total", "Bytes sent to the multicast group"),
+        r.GetCounter("fusion_multicast_keyframes_total", "Full-picture keyframes sent to the multicast group"),
+        r.GetCounter("fusion_multicast_send_errors_total", "Multicast datagrams the socket did not accept"),
+    };
+    return m;
+}
+
+Counter &FusionMetrics::Ingest(const std::string &sensor_type, const std::string &sensor_id)
+{
+    return Registry::Global().GetCounter(
+        "fusion_ingest_messages_total", "Sensor messages received",
+        "sensor_type=\"" + LabelValue(sensor_type) + "\",sensor_id=\"" + LabelValue(sensor_id) + "\"");
+}
+
+Counter &FusionMetrics::Shed(const std::string &sensor_type, const std::string &sensor_id, const std::string &reason)
+{
+    return Registry::Global().GetCounter(
+        "fusion_shed_total", "Sensor messages shed by ingest admission control",
+        "sensor_type=\"" + LabelValue(sensor_type) + "\",sensor_id=\"" + LabelValue(sensor_id) +
+            "\",reason=\"" + LabelValue(reason) + "\"");
+}
+
+Gauge &FusionMetrics::ClockOffset(const std::string &sensor_type, const std::string &sensor_id)
+{
+    return Registry::Global().GetGauge(
+        "fusion_clock_offset_us", "Estimated sensor-to-fusion clock offset, minimum transport delay included",
+        "sensor_type=\"" + LabelValue(sensor_type) + "\",sensor_id=\"" + LabelValue(sensor_id) + "\"");
+}
+
+Gauge &FusionMetrics::ClockSkew(const std::string &sensor_type, const std::string &sensor_id)
+{
+    return Registry::Global().GetGauge(
+        "fusion_clock_skew_ppb", "Estimated sensor clock skew against the fusion clock",
+        "sensor_type=\"" + LabelValue(sensor_type) + "\",sensor_id=\"" + LabelValue(sensor_id) + "\"");
+}
+
+} // namespace metrics
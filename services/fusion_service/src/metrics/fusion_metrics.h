@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include "metrics/metrics.h"
+
+namespace metrics {
+
+// Metrics exported by the fusion service. Resolved once from the global
+// registry; hot paths hold the references directly.
+struct FusionMetrics {
+    Gauge &queue_depth;
+    Gauge &admission_stage;      // 0 = admit all .. 4 = queue full
+    Histogram &batch_size;
+    Histogram &cycle_time;       // ns
+    Counter &filter_updates;
+    Counter &gate_rejections;
+    Counter &doppler_updates;
+    Counter &jpda_clusters;
+    Counter &jpda_approximated;  // Clusters too large to enumerate
+    Counter &jpda_unassociated;  // Detections outside every gate, dropped
+    Gauge &tracks;
+    Gauge &smoothed_tracks;
+    Gauge &smoother_bytes;       // Fixed-lag smoother windows
+    Gauge &track_store_bytes;    // Compact filter states
+    Counter &track_evictions;    // Coasting tracks dropped to stay in budget
+    Counter &handoff_dropped;    // Measurements of targets already handed to another shard
+    Gauge &monitor_subscribers;
+    Counter &monitor_frames;           // Pictures serialized for subscribers
+    Counter &monitor_frames_conflated; // Frames replaced before a slow subscriber took them
+    Histogram &log_writer_lag;   // ns from measurement timestamp to CSV write
+    Counter &multicast_datagrams;
+    Counter &multicast_bytes;
+    Counter &multicast_keyframes;
+    Counter &multicast_send_errors;    // Datagrams dropped on a full socket buffer
+
+    static FusionMetrics &Get();
+
+    // Per-sensor ingest counter. Takes the registry lock: cache the result
+    // per stream instead of calling it per message.
+    static Counter &Ingest(const std::string &sensor_type, const std::string &sensor_id);
+
+    // Measurements dropped by admission control, by reason. Same caveat.
+    static Counter &Shed(const std::string &sensor_type, const std::string &sensor_id, const std::string &reason);
+
+    // Estimated clock offset (us, sensor monotonic clock to fusion clock,
+    // minimum transport delay included) and skew (ppb) per stream.
+    static Gauge &ClockOffset(const std::string &sensor_type, const std::string &sensor_id);
+    static Gauge &ClockSkew(const std::string &sensor_type, const std::string &sensor_id);
+};
+
+} // namespace metrics
@@ -0,0 +1,152 @@
+#include "metrics/http_server.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace metrics {
+
+namespace
+{
+    // A client gets this long to send its request and take the response,
+    // so one that connects and goes quiet cannot hold the accept thread.
+    constexpr int CLIENT_TIMEOUT_MS = 1000;
+}
+
+HttpServer::HttpServer(int port, std::string bind_address) : port_(port), bind_address_(std::move(bind_address)) {}
+
+HttpServer::~HttpServer()
+{
+    Stop();
+}
+
+void HttpServer::Handle(const std::string &method, const std::string &path, const std::string &content_type,
+                        Handler handler)
+{
+    routes_[path] = {method, content_type, std::move(handler)};
+}
+
+bool HttpServer::Start()
+{
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0)
+        return false;
+
+    int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::inet_pton(AF_INET, bind_address_.c_str(), &addr.sin_addr) != 1)
+    {
+        std::cerr << "[METRICS] Invalid bind address " << bind_address_ << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 16) < 0)
+    {
+        std::cerr << "[METRICS] Could not listen on " << bind_address_ << ":" << port_ << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&HttpServer::AcceptLoop, this);
+    return true;
+}
+
+void HttpServer::Stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+    if (listen_fd_ >= 0)
+    {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void HttpServer::AcceptLoop()
+{
+    while (running_)
+    {
+        // Poll with a timeout so Stop() does not block on accept().
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, 200) <= 0)
+            continue;
+
+        int client = ::accept(listen_fd_, nullptr, nullptr);
+        if (client < 0)
+            continue;
+        Serve(client);
+        ::close(client);
+    }
+}
+
+void HttpServer::Serve(int client_fd)
+{
+    timeval timeout{CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000};
+    ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Only the request line matters; headers and body are ignored.
+    char buf[2048];
+    ssize_t n = ::recv(client_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0)
+        return;
+    buf[n] = '\0';
+
+    std::istringstream req(buf);
+    std::string method, target;
+    req >> method >> target;
+    std::string path = target.substr(0, target.find('?'));
+
+    std::string status = "200 OK", content_type = "text/plain", body, allow;
+    auto it = routes_.find(path);
+    if (it == routes_.end())
+    {
+        status = "404 Not Found";
+        body = "not found\n";
+    }
+    else if (method != it->second.method)
+    {
+        status = "405 Method Not Allowed";
+        allow = it->second.method;
+        body = "use " + allow + "\n";
+    }
+    else
+    {
+        content_type = it->second.content_type;
+        body = it->second.handler();
+    }
+
+    std::ostringstream resp;
+    resp << "HTTP/1.0 " << status << "\r\n"
+         << "Content-Type: " << content_type << "\r\n"
+         << "Content-Length: " << body.size() << "\r\n";
+    if (!allow.empty())
+        resp << "Allow: " << allow << "\r\n";
+    resp << "Connection: close\r\n\r\n" << body;
+    std::string out = resp.str();
+
+    size_t sent = 0;
+    while (sent < out.size())
+    {
+        ssize_t w = ::send(client_fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if (w <= 0)
+            break;
+        sent += static_cast<size_t>(w);
+    }
+}
+
+} // namespace metrics
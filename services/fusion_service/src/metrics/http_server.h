@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+
+namespace metrics {
+
+// Minimal blocking HTTP/1.0 server for local scrape endpoints (/metrics).
+// One accept thread serves requests sequentially; handlers must be cheap.
+// Each client has a short send/receive timeout, so a stalled one only
+// delays the others (and Stop()) by that much.
+class HttpServer {
+public:
+    using Handler = std::function<std::string()>;
+
+    // bind_address is an IPv4 address; "0.0.0.0" listens on every interface.
+    HttpServer(int port, std::string bind_address = "127.0.0.1");
+    ~HttpServer();
+
+    // Registers a handler for `method` (GET for reads, POST for anything
+    // that changes state) on `path`. Must be called before Start().
+    void Handle(const std::string &method, const std::string &path, const std::string &content_type,
+                Handler handler);
+
+    bool Start();
+    void Stop();
+
+private:
+    void AcceptLoop();
+    void Serve(int client_fd);
+
+    struct Route {
+        std::string method;
+        std::string content_type;
+        Handler handler;
+    };
+
+    int port_;
+    std::string bind_address_;
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::map<std::string, Route> routes_;
+};
+
+} // namespace metrics
@@ -0,0 +1,158 @@
+#include "metrics/metrics.h"
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+namespace metrics {
+
+size_t ThreadShard()
+{
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kCounterShards;
+    return shard;
+}
+
+uint64_t Counter::Value() const
+{
+    uint64_t total = 0;
+    for (const auto &s : shards_)
+        total += s.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t Histogram::BucketUpperBound(size_t idx)
+{
+    if (idx < (1u << kSubBucketBits))
+        return idx;
+    size_t shift = (idx >> kSubBucketBits) - 1;
+    uint64_t sub = idx & ((1u << kSubBucketBits) - 1);
+    uint64_t lower = ((1ull << kSubBucketBits) + sub) << shift;
+    return lower + ((1ull << shift) - 1);
+}
+
+double Histogram::Quantile(double q) const
+{
+    uint64_t total = Count();
+    if (total == 0)
+        return 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(q * total);
+    if (rank >= total)
+        rank = total - 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i)
+    {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen > rank)
+            return BucketUpperBound(i) * scale_;
+    }
+    return BucketUpperBound(kBuckets - 1) * scale_;
+}
+
+Registry &Registry::Global()
+{
+    static Registry registry;
+    return registry;
+}
+
+Registry::Entry &Registry::GetOrCreate(const std::string &name, const std::string &help,
+                                       const std::string &labels, Kind kind, double scale)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::string key = name + "{" + labels + "}";
+    auto it = index_.find(key);
+    if (it != index_.end())
+        return entries_[it->second];
+
+    Entry e;
+    e.name = name;
+    e.help = help;
+    e.labels = labels;
+    e.kind = kind;
+    if (kind == Kind::COUNTER)
+        e.counter = std::make_unique<Counter>();
+    else if (kind == Kind::GAUGE)
+        e.gauge = std::make_unique<Gauge>();
+    else
+        e.histogram = std::make_unique<Histogram>(scale);
+
+    entries_.push_back(std::move(e));
+    index_.emplace(key, entries_.size() - 1);
+    return entries_.back();
+}
+
+Counter &Registry::GetCounter(const std::string &name, const std::string &help, const std::string &labels)
+{
+    return *GetOrCreate(name, help, labels, Kind::COUNTER, 1.0).counter;
+}
+
+Gauge &Registry::GetGauge(const std::string &name, const std::string &help, const std::string &labels)
+{
+    return *GetOrCreate(name, help, labels, Kind::GAUGE, 1.0).gauge;
+}
+
+Histogram &Registry::GetHistogram(const std::string &name, const std::string &help,
+                                  double scale, const std::string &labels)
+{
+    return *GetOrCreate(name, help, labels, Kind::HISTOGRAM, scale).histogram;
+}
+
+std::string Registry::RenderPrometheus() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::ostringstream out;
+    out << std::setprecision(9);
+    std::set<std::string> described;
+
+    // index_ is ordered by name, which keeps each metric family contiguous.
+    for (const auto &kv : index_)
+    {
+        const Entry &e = entries_[kv.second];
+        if (described.insert(e.name).second)
+        {
+            const char *type = e.kind == Kind::COUNTER ? "counter" : e.kind == Kind::GAUGE ? "gauge" : "summary";
+            out << "# HELP " << e.name << " " << e.help << "\n";
+            out << "# TYPE " << e.name << " " << type << "\n";
+        }
+
+        std::string sep = e.labels.empty() ? "" : ",";
+        std::string braces = e.labels.empty() ? "" : "{" + e.labels + "}";
+        switch (e.kind)
+        {
+        case Kind::COUNTER:
+            out << e.name << braces << " " << e.counter->Value() << "\n";
+            break;
+        case Kind::GAUGE:
+            out << e.name << braces << " " << e.gauge->Value() << "\n";
+            break;
+        case Kind::HISTOGRAM:
+            for (double q : {0.5, 0.9, 0.99, 0.999})
+                out << e.name << "{" << e.labels << sep << "quantile=\"" << q << "\"} " << e.histogram->Quantile(q) << "\n";
+            out << e.name << "_sum" << braces << " " << e.histogram->Sum() << "\n";
+            out << e.name << "_count" << braces << " " << e.histogram->Count() << "\n";
+            break;
+        }
+    }
+    return out.str();
+}
+
+std::string LabelValue(const std::string &v)
+{
+    std::string out;
+    out.reserve(v.size());
+    for (char c : v)
+    {
+        if (c == '\\' || c == '"')
+            out += '\\';
+        if (c == '\n')
+        {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+} // namespace metrics
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace metrics {
+
+// Number of per-thread shards per counter. Threads beyond this share shards,
+// which stays correct (atomic adds) and only adds some contention.
+constexpr size_t kCounterShards = 16;
+
+// Index of the calling thread's counter shard (assigned on first use).
+size_t ThreadShard();
+
+// Monotonic counter. Each thread increments its own cache line with a relaxed
+// atomic add, so recording costs a few nanoseconds and never contends.
+class Counter {
+public:
+    void Inc(uint64_t n = 1)
+    {
+        shards_[ThreadShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t Value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, kCounterShards> shards_;
+};
+
+// Point-in-time value (queue depth, subscribers, ...).
+class Gauge {
+public:
+    void Set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void Add(int64_t d) { value_.fetch_add(d, std::memory_order_relaxed); }
+    int64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// HDR-style log-linear histogram over uint64 values: exact below 16, then 16
+// sub-buckets per power of two (~6% relative error) up to 2^64. Recording is a
+// bit scan plus one relaxed atomic add.
+class Histogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) << kSubBucketBits;
+
+    // `scale` converts recorded units into exported units (e.g. 1e-9 for ns -> s).
+    explicit Histogram(double scale = 1.0) : scale_(scale) {}
+
+    void Record(uint64_t v)
+    {
+        buckets_[BucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+    double Sum() const { return sum_.load(std::memory_order_relaxed) * scale_; }
+
+    // Value (in exported units) below which a fraction q of samples fall.
+    double Quantile(double q) const;
+
+    static size_t BucketIndex(uint64_t v)
+    {
+        if (v < (1u << kSubBucketBits))
+            return static_cast<size_t>(v);
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - kSubBucketBits;
+        return (static_cast<size_t>(shift + 1) << kSubBucketBits) +
+               static_cast<size_t>((v >> shift) & ((1u << kSubBucketBits) - 1));
+    }
+    static uint64_t BucketUpperBound(size_t idx);
+
+private:
+    double scale_;
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+// Records the lifetime of the scope in nanoseconds.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram &h) : h_(h), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer()
+    {
+        h_.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start_).count());
+    }
+
+private:
+    Histogram &h_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Owns all metrics and renders them in the Prometheus text exposition format.
+// Lookups take a mutex: resolve metrics once and keep the reference.
+class Registry {
+public:
+    static Registry &Global();
+
+    // `labels` is a preformatted label set, e.g. `sensor_type="RADAR"`.
+    Counter &GetCounter(const std::string &name, const std::string &help, const std::string &labels = "");
+    Gauge &GetGauge(const std::string &name, const std::string &help, const std::string &labels = "");
+    Histogram &GetHistogram(const std::string &name, const std::string &help,
+                            double scale = 1.0, const std::string &labels = "");
+
+    std::string RenderPrometheus() const;
+
+private:
+    enum class Kind { COUNTER, GAUGE, HISTOGRAM };
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        Kind kind;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    Entry &GetOrCreate(const std::string &name, const std::string &help,
+                       const std::string &labels, Kind kind, double scale);
+
+    mutable std::mutex mtx_;
+    std::deque<Entry> entries_;
+    std::map<std::string, size_t> index_; // name{labels} -> entries_ index
+};
+
+// Escapes a label value for the exposition format.
+std::string LabelValue(const std::string &v);
+
+} // namespace metrics
@@ -0,0 +1,108 @@
+#include "multicast_sink.h"
+#include "config.h"
+#include "metrics/fusion_metrics.h"
+
+#include <algorithm>
+#include <iostream>
+
+MulticastSink::Config MulticastSink::Config::FromEnv()
+{
+    Config c;
+    c.group = utils::GetEnvString("MULTICAST_GROUP", "");
+    c.port = (int)utils::GetEnvDouble("MULTICAST_PORT", c.port);
+    c.ttl = (int)utils::GetEnvDouble("MULTICAST_TTL", c.ttl);
+    c.iface = utils::GetEnvString("MULTICAST_IFACE", "");
+    c.loopback = utils::GetEnvString("MULTICAST_LOOP", "1") == "1";
+    c.keyframe_ms = std::max((int)utils::GetEnvDouble("MULTICAST_KEYFRAME_MS", c.keyframe_ms), 10);
+    return c;
+}
+
+std::unique_ptr<MulticastSink> MulticastSink::Create(const Config &config)
+{
+    if (config.group.empty())
+        return nullptr;
+    std::unique_ptr<mcast::Sender> sender =
+        mcast::Sender::Open(config.group, config.port, config.ttl, config.iface, config.loopback);
+    if (!sender)
+        return nullptr;
+    return std::unique_ptr<MulticastSink>(new MulticastSink(config, std::move(sender)));
+}
+
+MulticastSink::MulticastSink(const Config &config, std::unique_ptr<mcast::Sender> sender)
+    : config_(config), sender_(std::move(sender)), next_keyframe_(std::chrono::steady_clock::now())
+{
+}
+
+void MulticastSink::Update(const fusion::FusedTrack &track)
+{
+    uint32_t slot = index_.Find(track.track_id());
+    if (slot == TrackIndex::NONE)
+    {
+        slot = (uint32_t)picture_.size();
+        index_.Set(track.track_id(), slot);
+        picture_.emplace_back();
+    }
+    mcast::TrackRecord &r = picture_[slot];
+    r.track_id = track.track_id();
+    r.flags = track.has_uav_reported() ? uint32_t(mcast::HAS_ERROR) : 0u;
+    r.measurement_ts = track.measurement_ts();
+    r.lat = track.position().lat();
+    r.lon = track.position().lon();
+    r.alt = (float)track.position().alt();
+    r.confidence = (float)track.confidence();
+    r.var_north = (float)track.covariance().north_north();
+    r.cov_north_east = (float)track.covariance().north_east();
+    r.var_east = (float)track.covariance().east_east();
+    r.uav_error_m = (float)track.uav_error_m();
+    mcast::SetExternalId(r, track.external_id());
+    delta_.push_back(r);
+}
+
+void MulticastSink::Remove(uint32_t track_id)
+{
+    uint32_t slot = index_.Find(track_id);
+    if (slot == TrackIndex::NONE)
+        return;
+    index_.Clear(track_id);
+    if (slot != picture_.size() - 1)
+    {
+        picture_[slot] = picture_.back();
+        index_.Set(picture_[slot].track_id, slot);
+    }
+    picture_.pop_back();
+
+    mcast::TrackRecord r{};
+    r.track_id = track_id;
+    r.flags = mcast::REMOVED;
+    delta_.push_back(r);
+}
+
+void MulticastSink::Flush()
+{
+    auto now = std::chrono::steady_clock::now();
+    bool keyframe = now >= next_keyframe_;
+    if (!keyframe && delta_.empty())
+        return;
+
+    // A keyframe already holds this cycle's updates.
+    if (keyframe)
+    {
+        sender_->SendCycle(++cycle_, true, picture_.data(), picture_.size());
+        next_keyframe_ = now + std::chrono::milliseconds(config_.keyframe_ms);
+    }
+    else
+    {
+        sender_->SendCycle(++cycle_, false, delta_.data(), delta_.size());
+    }
+    delta_.clear();
+
+    metrics::FusionMetrics &fm = metrics::FusionMetrics::Get();
+    if (keyframe)
+        fm.multicast_keyframes.Inc();
+    fm.multicast_datagrams.Inc(sender_->datagrams_sent() - reported_datagrams_);
+    fm.multicast_bytes.Inc(sender_->bytes_sent() - reported_bytes_);
+    fm.multicast_send_errors.Inc(sender_->send_errors() - reported_errors_);
+    reported_datagrams_ = sender_->datagrams_sent();
+    reported_bytes_ = sender_->bytes_sent();
+    reported_errors_ = sender_->send_errors();
+}
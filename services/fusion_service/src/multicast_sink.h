@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "track_multicast.h"
+#include "track_table.h"
+#include "fusion/fusion.pb.h"
+
+// Publishes the fused picture over UDP multicast (MULTICAST_GROUP), next to
+// the FusionMonitor gRPC path. Tracks updated or removed during a fusion
+// cycle are collected and sent as one delta on Flush(); every keyframe_ms
+// the whole picture goes out as a keyframe instead. The sink keeps its own
+// compact copy of the picture for the keyframes. Fusion thread only.
+class MulticastSink {
+public:
+    struct Config {
+        std::string group;          // MULTICAST_GROUP, empty = disabled
+        int port = 6020;            // MULTICAST_PORT
+        int ttl = 1;                // MULTICAST_TTL, 1 = local network only
+        std::string iface;          // MULTICAST_IFACE, IPv4 address of the outgoing interface
+        bool loopback = true;       // MULTICAST_LOOP, deliver to receivers on this host
+        int keyframe_ms = 500;      // MULTICAST_KEYFRAME_MS
+
+        static Config FromEnv();
+    };
+
+    // Null when the group is empty or the socket cannot be set up.
+    static std::unique_ptr<MulticastSink> Create(const Config& config);
+
+    void Update(const fusion::FusedTrack& track);
+    void Remove(uint32_t track_id);
+
+    // Sends the cycle's changes, or the keyframe when one is due.
+    void Flush();
+
+private:
+    MulticastSink(const Config& config, std::unique_ptr<mcast::Sender> sender);
+
+    Config config_;
+    std::unique_ptr<mcast::Sender> sender_;
+    std::vector<mcast::TrackRecord> picture_;       // Dense, for keyframes
+    TrackIndex index_;                              // track id -> slot in picture_
+    std::vector<mcast::TrackRecord> delta_;
+    uint64_t cycle_ = 0;
+    std::chrono::steady_clock::time_point next_keyframe_;
+    uint64_t reported_datagrams_ = 0;
+    uint64_t reported_bytes_ = 0;
+    uint64_t reported_errors_ = 0;
+};
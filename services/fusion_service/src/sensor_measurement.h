@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Raw sensor measurement structure
+struct SensorMeasurement
+{
+    uint64_t timestamp; // ms since epoch, as sent
+    std::string sensor_type;
+    std::string sensor_id;
+    std::string target_id; // External target identifier (radar track_id / uav_id)
+    double lat;
+    double lon;
+    double alt;
+    std::string extras;
+
+    // Radar Doppler: range rate (m/s, positive opening) along the measured
+    // bearing (degrees). range_rate_sigma is 0 when there is no Doppler.
+    double range_rate = 0.0;
+    double range_rate_sigma = 0.0;
+    double bearing = 0.0;
+
+    // Radar polar measurement behind lat/lon, for the JPDA measurement
+    // covariance. The sigmas are 0 when the sensor does not report them.
+    double range = 0.0;         // m
+    double range_sigma = 0.0;   // m
+    double bearing_sigma = 0.0; // degrees
+
+    // Timing. sensor_ns is Header.timestamp_ns (0 when not sent) and
+    // received_ns the fusion clock at ingest; ClockSync turns them into
+    // time_ns, the measurement time on the fusion clock that prediction uses.
+    int64_t sensor_ns = 0;
+    int64_t received_ns = 0;
+    int64_t time_ns = 0;
+};
@@ -0,0 +1,145 @@
+#include "shm_ingest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+#include "clock_sync.h"
+#include "metrics/fusion_metrics.h"
+
+namespace
+{
+    constexpr size_t DRAIN_PER_RING = 4096; // Records per ring per round, keeps rings fair
+
+    SensorMeasurement ToMeasurement(const shm::MeasurementRecord &r)
+    {
+        // Same mapping as the Stream* RPCs.
+        switch (r.kind)
+        {
+        case shm::RecordKind::UAV:
+        {
+            std::string uav_id = shm::GetId(r.target_id);
+            return {(uint64_t)r.timestamp_ms, "UAV", uav_id, uav_id, r.lat, r.lon, r.alt, uav_id};
+        }
+        case shm::RecordKind::RADAR:
+        {
+            SensorMeasurement m{(uint64_t)r.timestamp_ms, "RADAR", shm::GetId(r.sensor_id), shm::GetId(r.target_id),
+                                r.lat, r.lon, r.alt, ""};
+            m.range_rate = r.velocity;
+            m.range_rate_sigma = r.velocity_sigma;
+            m.bearing = r.bearing;
+            m.range = r.range;
+            m.range_sigma = r.range_sigma;
+            m.bearing_sigma = r.bearing_sigma;
+            return m;
+        }
+        default:
+            return {(uint64_t)r.timestamp_ms, "SIGINT", shm::GetId(r.sensor_id), "", 0.0, 0.0, 0.0, ""};
+        }
+    }
+}
+
+ShmIngest::ShmIngest(std::string dir, Sink sink) : dir_(std::move(dir)), sink_(std::move(sink))
+{
+    thread_ = std::thread(&ShmIngest::Run, this);
+}
+
+ShmIngest::~ShmIngest()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void ShmIngest::Scan()
+{
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(dir_, ec))
+    {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("bfsim.", 0) != 0 || name.size() < 11 || name.compare(name.size() - 5, 5, ".ring") != 0)
+            continue;
+
+        std::string path = entry.path().string();
+        bool attached = false;
+        for (const auto &ring : rings_)
+            attached = attached || ring->path() == path;
+        if (attached)
+            continue;
+
+        if (auto ring = shm::Consumer::Attach(path))
+        {
+            std::cout << "[FUSION] Reading shared-memory ring " << path << std::endl;
+            rings_.push_back(std::move(ring));
+        }
+    }
+
+    for (auto it = rings_.begin(); it != rings_.end();)
+    {
+        if ((*it)->Finished())
+        {
+            std::cout << "[FUSION] Shared-memory ring " << (*it)->path() << " closed" << std::endl;
+            it = rings_.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void ShmIngest::Run()
+{
+    std::vector<SensorMeasurement> round;
+    std::string counter_key;
+    metrics::Counter *counter = nullptr;
+    auto next_scan = std::chrono::steady_clock::now();
+    auto next_beat = next_scan;
+    shm::IdleWait idle;
+
+    while (running_)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_scan)
+        {
+            Scan();
+            next_scan = now + std::chrono::seconds(1);
+        }
+        // Producers treat a heartbeat older than a second as "nobody reads".
+        if (now >= next_beat)
+        {
+            for (auto &ring : rings_)
+                ring->Heartbeat();
+            next_beat = now + std::chrono::milliseconds(200);
+        }
+
+        round.clear();
+        for (auto &ring : rings_)
+        {
+            int64_t received_ns = ClockSync::Now();
+            ring->Drain(DRAIN_PER_RING, [&](const shm::MeasurementRecord &r)
+                        {
+                            round.push_back(ToMeasurement(r));
+                            SensorMeasurement &m = round.back();
+                            m.sensor_ns = r.timestamp_ns;
+                            m.received_ns = received_ns;
+                            // Ingest counter resolved again only when the sensor changes.
+                            if (!counter || counter_key != m.sensor_type + m.sensor_id)
+                            {
+                                counter_key = m.sensor_type + m.sensor_id;
+                                counter = &metrics::FusionMetrics::Ingest(m.sensor_type, m.sensor_id);
+                            }
+                            counter->Inc();
+                        });
+        }
+
+        if (!round.empty())
+        {
+            sink_(round);
+            idle.Reset();
+            continue;
+        }
+        if (rings_.empty())
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        else
+            idle.Wait();
+    }
+}
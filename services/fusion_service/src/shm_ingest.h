@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sensor_measurement.h"
+#include "shm_ring.h"
+
+// Reads measurements from the shared-memory rings of co-located sensors
+// (see common_utils/shm_ring.h). A single thread scans the segment
+// directory once a second, drains every attached ring and hands each
+// round of records to `sink` in one call.
+class ShmIngest
+{
+public:
+    using Sink = std::function<void(std::vector<SensorMeasurement> &)>;
+
+    ShmIngest(std::string dir, Sink sink);
+    ~ShmIngest();
+
+private:
+    void Run();
+    void Scan();
+
+    std::string dir_;
+    Sink sink_;
+    std::vector<std::unique_ptr<shm::Consumer>> rings_; // Ingest thread only
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
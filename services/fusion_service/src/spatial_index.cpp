@@ -0,0 +1,159 @@
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+
+#include "geo_utils.h"
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+}
+
+SpatialIndex::SpatialIndex(double cell_deg) : cell_deg_(cell_deg > 0 ? cell_deg : 0.1) {}
+
+int32_t SpatialIndex::LatIndex(double lat) const
+{
+    return static_cast<int32_t>(std::floor((lat + 90.0) / cell_deg_));
+}
+
+int32_t SpatialIndex::LonIndex(double lon) const
+{
+    return static_cast<int32_t>(std::floor((lon + 180.0) / cell_deg_));
+}
+
+int64_t SpatialIndex::CellKey(int32_t ilat, int32_t ilon) const
+{
+    return (static_cast<int64_t>(ilat) << 32) | static_cast<uint32_t>(ilon);
+}
+
+void SpatialIndex::RemoveFromCell(int64_t cell, uint32_t track_id)
+{
+    auto it = cells_.find(cell);
+    if (it == cells_.end())
+        return;
+    auto &ids = it->second;
+    auto pos = std::find(ids.begin(), ids.end(), track_id);
+    if (pos != ids.end())
+    {
+        *pos = ids.back();
+        ids.pop_back();
+    }
+    if (ids.empty())
+        cells_.erase(it);
+}
+
+void SpatialIndex::Update(uint32_t track_id, double lat, double lon)
+{
+    int64_t cell = CellKey(LatIndex(lat), LonIndex(lon));
+    auto it = entries_.find(track_id);
+    if (it == entries_.end())
+    {
+        entries_.emplace(track_id, Entry{cell, lat, lon});
+        cells_[cell].push_back(track_id);
+        return;
+    }
+
+    if (it->second.cell != cell)
+    {
+        RemoveFromCell(it->second.cell, track_id);
+        cells_[cell].push_back(track_id);
+        it->second.cell = cell;
+    }
+    it->second.lat = lat;
+    it->second.lon = lon;
+}
+
+void SpatialIndex::Remove(uint32_t track_id)
+{
+    auto it = entries_.find(track_id);
+    if (it == entries_.end())
+        return;
+    RemoveFromCell(it->second.cell, track_id);
+    entries_.erase(it);
+}
+
+template <typename Fn>
+void SpatialIndex::ForEachCandidate(double min_lat, double min_lon, double max_lat, double max_lon, Fn fn) const
+{
+    int32_t lat0 = LatIndex(std::max(min_lat, -90.0)), lat1 = LatIndex(std::min(max_lat, 90.0));
+    int32_t lon0 = LonIndex(min_lon), lon1 = LonIndex(max_lon);
+    uint64_t cell_count = static_cast<uint64_t>(lat1 - lat0 + 1) * static_cast<uint64_t>(lon1 - lon0 + 1);
+
+    // A box spanning more cells than there are tracks is cheaper to scan directly.
+    if (cell_count > entries_.size())
+    {
+        for (const auto &kv : entries_)
+            fn(kv.first, kv.second);
+        return;
+    }
+
+    for (int32_t ilat = lat0; ilat <= lat1; ++ilat)
+    {
+        for (int32_t ilon = lon0; ilon <= lon1; ++ilon)
+        {
+            auto it = cells_.find(CellKey(ilat, ilon));
+            if (it == cells_.end())
+                continue;
+            for (uint32_t id : it->second)
+                fn(id, entries_.at(id));
+        }
+    }
+}
+
+void SpatialIndex::QueryBox(double min_lat, double min_lon, double max_lat, double max_lon,
+                            std::vector<uint32_t> &out) const
+{
+    if (min_lat > max_lat)
+        return;
+    if (min_lon > max_lon)
+    {
+        QueryBox(min_lat, min_lon, max_lat, 180.0, out);
+        QueryBox(min_lat, -180.0, max_lat, max_lon, out);
+        return;
+    }
+
+    ForEachCandidate(min_lat, min_lon, max_lat, max_lon, [&](uint32_t id, const Entry &e) {
+        if (e.lat >= min_lat && e.lat <= max_lat && e.lon >= min_lon && e.lon <= max_lon)
+            out.push_back(id);
+    });
+}
+
+void SpatialIndex::QueryRadius(double lat, double lon, double radius_m, std::vector<uint32_t> &out) const
+{
+    if (radius_m <= 0)
+        return;
+
+    double dlat = radius_m / METERS_PER_DEG_LAT;
+    double cos_lat = std::cos(lat * M_PI / 180.0);
+    double dlon = (cos_lat > 1e-6) ? std::min(radius_m / (METERS_PER_DEG_LAT * cos_lat), 180.0) : 180.0;
+
+    size_t first = out.size();
+    double min_lon = lon - dlon, max_lon = lon + dlon;
+    auto visit = [&](uint32_t id, const Entry &e) {
+        if (geo_utils::CalculateHaversine(lat, lon, e.lat, e.lon) <= radius_m)
+            out.push_back(id);
+    };
+
+    if (dlon >= 180.0)
+    {
+        ForEachCandidate(lat - dlat, -180.0, lat + dlat, 180.0, visit);
+    }
+    else if (min_lon < -180.0)
+    {
+        ForEachCandidate(lat - dlat, min_lon + 360.0, lat + dlat, 180.0, visit);
+        ForEachCandidate(lat - dlat, -180.0, lat + dlat, max_lon, visit);
+    }
+    else if (max_lon > 180.0)
+    {
+        ForEachCandidate(lat - dlat, min_lon, lat + dlat, 180.0, visit);
+        ForEachCandidate(lat - dlat, -180.0, lat + dlat, max_lon - 360.0, visit);
+    }
+    else
+    {
+        ForEachCandidate(lat - dlat, min_lon, lat + dlat, max_lon, visit);
+    }
+
+    // Split queries can report a track twice when they fall back to a full scan.
+    std::sort(out.begin() + first, out.end());
+    out.erase(std::unique(out.begin() + first, out.end()), out.end());
+}
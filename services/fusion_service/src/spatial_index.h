@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform lat/lon grid over track positions (geohash-style fixed cells).
+// Updated incrementally as tracks move, so region and proximity queries only
+// touch the cells they overlap instead of scanning every track.
+// Not thread-safe: callers guard it with the fused track mutex.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(double cell_deg = 0.1);
+
+    // Inserts or moves a track. O(1) when the track stays in its cell.
+    void Update(uint32_t track_id, double lat, double lon);
+    void Remove(uint32_t track_id);
+
+    // Tracks inside the box (degrees, inclusive). min_lon > max_lon wraps
+    // across the antimeridian.
+    void QueryBox(double min_lat, double min_lon, double max_lat, double max_lon,
+                  std::vector<uint32_t> &out) const;
+
+    // Tracks within radius_m (great-circle) of the given point.
+    void QueryRadius(double lat, double lon, double radius_m, std::vector<uint32_t> &out) const;
+
+    size_t Size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        int64_t cell;
+        double lat;
+        double lon;
+    };
+
+    int64_t CellKey(int32_t ilat, int32_t ilon) const;
+    int32_t LatIndex(double lat) const;
+    int32_t LonIndex(double lon) const;
+    void RemoveFromCell(int64_t cell, uint32_t track_id);
+
+    // Visits candidates in the box, without exact filtering.
+    template <typename Fn>
+    void ForEachCandidate(double min_lat, double min_lon, double max_lat, double max_lon, Fn fn) const;
+
+    double cell_deg_;
+    std::unordered_map<int64_t, std::vector<uint32_t>> cells_;
+    std::unordered_map<uint32_t, Entry> entries_;
+};
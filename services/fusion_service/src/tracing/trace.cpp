@@ -0,0 +1,168 @@
+#include "tracing/trace.h"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace tracing {
+
+namespace {
+
+    struct Event
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<uint64_t> start_ns{0};
+        std::atomic<uint64_t> dur_ns{0};
+    };
+
+    // Single-writer ring owned by one thread. Fields are relaxed atomics so a
+    // concurrent dump never races; `head` publishes completed events.
+    struct ThreadBuffer
+    {
+        uint32_t tid = 0;
+        std::string name;
+        std::atomic<uint64_t> head{0};
+        std::unique_ptr<Event[]> events{new Event[kRingCapacity]};
+    };
+
+    std::atomic<bool> g_enabled{false};
+
+    std::mutex &BuffersMutex()
+    {
+        static std::mutex mtx;
+        return mtx;
+    }
+
+    // Buffers outlive their threads so spans from finished threads still dump.
+    std::vector<std::shared_ptr<ThreadBuffer>> &Buffers()
+    {
+        static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        return buffers;
+    }
+
+    ThreadBuffer &LocalBuffer()
+    {
+        thread_local std::shared_ptr<ThreadBuffer> local = [] {
+            auto buf = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(BuffersMutex());
+            buf->tid = static_cast<uint32_t>(Buffers().size() + 1);
+            buf->name = "thread-" + std::to_string(buf->tid);
+            Buffers().push_back(buf);
+            return buf;
+        }();
+        return *local;
+    }
+
+    void AppendJsonString(std::ostringstream &out, const std::string &s)
+    {
+        out << '"';
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                out << ' ';
+            else
+                out << c;
+        }
+        out << '"';
+    }
+}
+
+bool Enabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void SetEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SetThreadName(const std::string &name)
+{
+    ThreadBuffer &buf = LocalBuffer();
+    std::lock_guard<std::mutex> lock(BuffersMutex());
+    buf.name = name;
+}
+
+uint64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Record(const char *name, uint64_t start_ns, uint64_t dur_ns)
+{
+    ThreadBuffer &buf = LocalBuffer();
+    uint64_t h = buf.head.load(std::memory_order_relaxed);
+    Event &e = buf.events[h % kRingCapacity];
+    // Pairs with the dump's acquire fence: a reader that sees any of these
+    // stores also sees head at h, which marks the slot as being rewritten.
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name.store(name, std::memory_order_relaxed);
+    e.start_ns.store(start_ns, std::memory_order_relaxed);
+    e.dur_ns.store(dur_ns, std::memory_order_relaxed);
+    buf.head.store(h + 1, std::memory_order_release);
+}
+
+std::string DumpChromeJson()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(BuffersMutex());
+        buffers = Buffers();
+    }
+
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto &buf : buffers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(BuffersMutex());
+            out << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buf->tid
+                << ",\"args\":{\"name\":";
+            AppendJsonString(out, buf->name);
+            out << "}}";
+            first = false;
+        }
+
+        uint64_t head = buf->head.load(std::memory_order_acquire);
+        uint64_t begin = head > kRingCapacity ? head - kRingCapacity : 0;
+        for (uint64_t i = begin; i < head; ++i)
+        {
+            const Event &e = buf->events[i % kRingCapacity];
+            const char *name = e.name.load(std::memory_order_relaxed);
+            uint64_t start = e.start_ns.load(std::memory_order_relaxed);
+            uint64_t dur = e.dur_ns.load(std::memory_order_relaxed);
+
+            // Skip slots the writer lapped while we were copying. Slot i is
+            // rewritten from the moment head reaches i + kRingCapacity; the
+            // fence keeps the field loads above from moving past this check.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buf->head.load(std::memory_order_relaxed) - i >= kRingCapacity || !name)
+                continue;
+
+            out << ",{\"name\":";
+            AppendJsonString(out, name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buf->tid
+                << ",\"ts\":" << start / 1000 << "." << (start % 1000) / 100
+                << ",\"dur\":" << dur / 1000 << "." << (dur % 1000) / 100 << "}";
+        }
+    }
+    out << "]}\n";
+    return out.str();
+}
+
+bool WriteChromeJson(const std::string &path)
+{
+    std::ofstream ofs(path, std::ios::trunc);
+    if (!ofs.is_open())
+        return false;
+    ofs << DumpChromeJson();
+    return static_cast<bool>(ofs);
+}
+
+} // namespace tracing
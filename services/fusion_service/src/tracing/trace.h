@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Scoped hot-path tracing exported as Chrome trace JSON (chrome://tracing,
+// ui.perfetto.dev). Spans are compiled in when FUSION_TRACING is defined and
+// recorded only while tracing is enabled at runtime.
+namespace tracing {
+
+// Events kept per thread; older events are overwritten.
+constexpr size_t kRingCapacity = 1 << 15;
+
+bool Enabled();
+void SetEnabled(bool enabled);
+
+// Labels the calling thread in the exported trace.
+void SetThreadName(const std::string &name);
+
+// Appends a completed span to the calling thread's ring buffer.
+// `name` must have static storage duration.
+void Record(const char *name, uint64_t start_ns, uint64_t dur_ns);
+
+uint64_t NowNs();
+
+// Serializes every thread's ring buffer as a Chrome trace JSON document.
+std::string DumpChromeJson();
+
+// Writes DumpChromeJson() to `path`. Returns false on I/O failure.
+bool WriteChromeJson(const std::string &path);
+
+class ScopedSpan {
+public:
+    explicit ScopedSpan(const char *name) : name_(name), start_(Enabled() ? NowNs() : 0) {}
+    ~ScopedSpan()
+    {
+        if (start_ != 0)
+            Record(name_, start_, NowNs() - start_);
+    }
+    ScopedSpan(const ScopedSpan &) = delete;
+    ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+private:
+    const char *name_;
+    uint64_t start_;
+};
+
+} // namespace tracing
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef FUSION_TRACING
+#define TRACE_SCOPE(name) ::tracing::ScopedSpan TRACE_CONCAT(trace_span_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) ::tracing::SetThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,144 @@
+#include "track_evaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "geo_utils.h"
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+}
+
+TrackEvaluator::TrackEvaluator(double converge_m, uint32_t converge_samples)
+    : converge_m_(converge_m), converge_samples_(std::max<uint32_t>(converge_samples, 1))
+{}
+
+void TrackEvaluator::RecordAssociation(uint32_t track_id, const std::string& source_id)
+{
+    stats_[track_id].sources[source_id]++;
+}
+
+void TrackEvaluator::RecordNis(uint32_t track_id, double nis)
+{
+    if (!std::isfinite(nis))
+        return;
+    Stats& s = stats_[track_id];
+    s.nis_sum += nis;
+    s.nis_count++;
+}
+
+double TrackEvaluator::Evaluate(uint32_t track_id, int64_t timestamp_ms,
+                                double lat, double lon, double p_nn, double p_ne, double p_ee,
+                                double truth_lat, double truth_lon)
+{
+    Stats& s = stats_[track_id];
+    if (s.first_ts < 0)
+        s.first_ts = timestamp_ms;
+
+    double err = geo_utils::CalculateHaversine(lat, lon, truth_lat, truth_lon);
+    s.samples++;
+    s.sum_sq_err += err * err;
+    s.max_err = std::max(s.max_err, err);
+
+    // NEES = e' P^-1 e over the 2x2 position block, in local meters.
+    double det = p_nn * p_ee - p_ne * p_ne;
+    if (det > 0.0)
+    {
+        double e_n = (lat - truth_lat) * METERS_PER_DEG_LAT;
+        double e_e = (lon - truth_lon) * METERS_PER_DEG_LAT * std::cos(truth_lat * M_PI / 180.0);
+        double nees = (p_ee * e_n * e_n - 2.0 * p_ne * e_n * e_e + p_nn * e_e * e_e) / det;
+        if (std::isfinite(nees))
+        {
+            s.nees_sum += nees;
+            s.nees_count++;
+        }
+    }
+
+    if (s.convergence_s < 0.0)
+    {
+        if (err < converge_m_)
+        {
+            if (s.streak++ == 0)
+                s.streak_start = timestamp_ms;
+            if (s.streak >= converge_samples_)
+                s.convergence_s = (double)(s.streak_start - s.first_ts) / 1000.0;
+        }
+        else
+        {
+            s.streak = 0;
+        }
+    }
+    return err;
+}
+
+double TrackEvaluator::Purity(const Stats& s)
+{
+    uint64_t total = 0, best = 0;
+    for (const auto& kv : s.sources)
+    {
+        total += kv.second;
+        best = std::max(best, kv.second);
+    }
+    return total ? (double)best / (double)total : 0.0;
+}
+
+void TrackEvaluator::Fill(uint32_t track_id, fusion::TrackQuality* out) const
+{
+    auto it = stats_.find(track_id);
+    if (it == stats_.end())
+        return;
+    const Stats& s = it->second;
+    out->set_samples(s.samples);
+    out->set_rmse_m(s.samples ? std::sqrt(s.sum_sq_err / (double)s.samples) : 0.0);
+    out->set_max_error_m(s.max_err);
+    out->set_nees(s.nees_count ? s.nees_sum / (double)s.nees_count : 0.0);
+    out->set_nis(s.nis_count ? s.nis_sum / (double)s.nis_count : 0.0);
+    out->set_convergence_s(s.convergence_s);
+    out->set_purity(Purity(s));
+}
+
+void TrackEvaluator::WriteSummary(const std::string& path) const
+{
+    std::vector<uint32_t> ids;
+    for (const auto& kv : stats_)
+        ids.push_back(kv.first);
+    std::sort(ids.begin(), ids.end());
+
+    std::ofstream file;
+    if (!path.empty())
+    {
+        file.open(path, std::ios::trunc);
+        if (file.is_open())
+            file << "track_id,samples,rmse_m,max_error_m,avg_nees,avg_nis,convergence_s,purity\n";
+        else
+            std::cerr << "[FUSION] Cannot write summary to " << path << std::endl;
+    }
+
+    std::cout << "[FUSION] ===== Run Summary =====" << std::endl;
+    for (uint32_t id : ids)
+    {
+        fusion::TrackQuality q;
+        Fill(id, &q);
+        std::cout << "[FUSION] Track " << id << std::fixed << std::setprecision(2)
+                  << " | samples " << q.samples()
+                  << " | RMSE " << q.rmse_m() << " m"
+                  << " | max " << q.max_error_m() << " m"
+                  << std::defaultfloat << std::setprecision(3)
+                  << " | NEES " << q.nees()
+                  << " | NIS " << q.nis()
+                  << std::fixed << std::setprecision(2)
+                  << " | converged " << q.convergence_s() << " s"
+                  << " | purity " << q.purity() << std::endl;
+        if (file.is_open())
+        {
+            file << id << "," << q.samples() << std::fixed << std::setprecision(3)
+                 << "," << q.rmse_m() << "," << q.max_error_m()
+                 << std::scientific << "," << q.nees() << "," << q.nis()
+                 << std::fixed << "," << q.convergence_s() << "," << q.purity() << "\n";
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "fusion/fusion.pb.h"
+
+// Streaming accuracy and consistency statistics per fused track.
+//
+// Fed by the fusion loop after every track update; replaces post-processing
+// the results CSV. NEES uses the position block of the filter covariance,
+// NIS the innovation covariance of each measurement update, both with the
+// error in local meters against the covariance in m^2 (2 DOF, so a
+// consistent filter averages ~2). Not thread-safe: owned by the fusion loop.
+class TrackEvaluator {
+public:
+    // A track counts as converged once its error stays below converge_m for
+    // converge_samples consecutive evaluations.
+    TrackEvaluator(double converge_m, uint32_t converge_samples);
+
+    // Records which external target a measurement associated to the track came from.
+    void RecordAssociation(uint32_t track_id, const std::string& source_id);
+
+    void RecordNis(uint32_t track_id, double nis);
+
+    // Scores a fused estimate against truth at the same time. The covariance
+    // is north/east in m^2 (KalmanFilter::GetPositionCovariance). Returns the
+    // horizontal error in meters.
+    double Evaluate(uint32_t track_id, int64_t timestamp_ms,
+                    double lat, double lon, double p_nn, double p_ne, double p_ee,
+                    double truth_lat, double truth_lon);
+
+    void Fill(uint32_t track_id, fusion::TrackQuality* out) const;
+
+    // Prints the per-track table and writes it as CSV to `path` (skipped when empty).
+    void WriteSummary(const std::string& path) const;
+
+private:
+    struct Stats {
+        int64_t first_ts = -1;
+        uint64_t samples = 0;
+        double sum_sq_err = 0.0;
+        double max_err = 0.0;
+        uint64_t nees_count = 0;
+        double nees_sum = 0.0;
+        uint64_t nis_count = 0;
+        double nis_sum = 0.0;
+        int64_t streak_start = -1;
+        uint32_t streak = 0;
+        double convergence_s = -1.0;
+        std::map<std::string, uint64_t> sources;
+    };
+
+    static double Purity(const Stats& s);
+
+    double converge_m_;
+    uint32_t converge_samples_;
+    std::unordered_map<uint32_t, Stats> stats_;
+};
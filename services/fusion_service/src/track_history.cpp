@@ -0,0 +1,149 @@
+#include "track_history.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr double DEG_SCALE = 1e7;   // 1e-7 deg (~1 cm)
+    constexpr double ALT_SCALE = 10.0;  // 0.1 m
+    constexpr int64_t TICK_MS = 10;
+    constexpr int64_t LON_WRAP = 3600000000LL; // 360 deg in 1e-7 deg
+
+    int32_t Quantize(double v, double scale)
+    {
+        return static_cast<int32_t>(std::llround(v * scale));
+    }
+
+    // Longitude difference in (-180, 180] deg so the delta always fits in int32.
+    int64_t WrapLon(int64_t d)
+    {
+        while (d > LON_WRAP / 2)
+            d -= LON_WRAP;
+        while (d <= -LON_WRAP / 2)
+            d += LON_WRAP;
+        return d;
+    }
+
+    int32_t NormalizeLon(int64_t lon)
+    {
+        return static_cast<int32_t>(WrapLon(lon));
+    }
+}
+
+TrackHistoryStore::TrackHistoryStore(size_t budget_bytes, size_t samples_per_track)
+    : capacity_(std::max<size_t>(samples_per_track, 2))
+{
+    max_tracks_ = std::max<size_t>(budget_bytes / BytesPerTrack(), 1);
+}
+
+void TrackHistoryStore::Reset(Ring& ring, int64_t ts_ticks, int32_t lat, int32_t lon, int32_t alt)
+{
+    ring.tail_ts = ring.head_ts = ts_ticks;
+    ring.tail_lat = ring.head_lat = lat;
+    ring.tail_lon = ring.head_lon = lon;
+    ring.tail_alt = ring.head_alt = alt;
+    ring.start = 0;
+    ring.count = 1;
+}
+
+void TrackHistoryStore::EvictOldest()
+{
+    uint32_t victim = lru_.back();
+    lru_.pop_back();
+    rings_.erase(victim);
+}
+
+void TrackHistoryStore::Append(uint32_t track_id, int64_t timestamp_ms, double lat, double lon, double alt)
+{
+    int64_t ts = timestamp_ms / TICK_MS;
+    int32_t qlat = Quantize(lat, DEG_SCALE);
+    int32_t qlon = Quantize(lon, DEG_SCALE);
+    int32_t qalt = Quantize(alt, ALT_SCALE);
+
+    auto it = rings_.find(track_id);
+    if (it == rings_.end())
+    {
+        if (rings_.size() >= max_tracks_)
+            EvictOldest();
+        Ring& ring = rings_[track_id];
+        ring.slots.resize(capacity_);
+        lru_.push_front(track_id);
+        ring.lru_pos = lru_.begin();
+        Reset(ring, ts, qlat, qlon, qalt);
+        return;
+    }
+
+    Ring& ring = it->second;
+    lru_.splice(lru_.begin(), lru_, ring.lru_pos);
+
+    int64_t dt = ts - ring.head_ts;
+    if (dt <= 0)
+        return; // Same tick or out of order: keep the first sample
+
+    int64_t dalt = static_cast<int64_t>(qalt) - ring.head_alt;
+    if (dt > std::numeric_limits<uint16_t>::max() ||
+        dalt > std::numeric_limits<int16_t>::max() || dalt < std::numeric_limits<int16_t>::min())
+    {
+        // Gap or jump too large for a delta record: restart the trail.
+        Reset(ring, ts, qlat, qlon, qalt);
+        return;
+    }
+
+    if (ring.count == capacity_)
+    {
+        // Drop the oldest sample; the next one becomes the new anchor.
+        ring.start = (ring.start + 1) % capacity_;
+        const Delta& d = ring.slots[ring.start];
+        ring.tail_ts += d.dt;
+        ring.tail_lat += d.dlat;
+        ring.tail_lon = NormalizeLon(static_cast<int64_t>(ring.tail_lon) + d.dlon);
+        ring.tail_alt += d.dalt;
+        ring.count--;
+    }
+
+    Delta& d = ring.slots[(ring.start + ring.count) % capacity_];
+    d.dt = static_cast<uint16_t>(dt);
+    d.dlat = qlat - ring.head_lat;
+    d.dlon = static_cast<int32_t>(WrapLon(static_cast<int64_t>(qlon) - ring.head_lon));
+    d.dalt = static_cast<int16_t>(dalt);
+    ring.count++;
+
+    ring.head_ts = ts;
+    ring.head_lat = qlat;
+    ring.head_lon = qlon;
+    ring.head_alt = qalt;
+}
+
+void TrackHistoryStore::Read(uint32_t track_id, int64_t since_ms, std::vector<Sample>& out) const
+{
+    auto it = rings_.find(track_id);
+    if (it == rings_.end())
+        return;
+
+    const Ring& ring = it->second;
+    int64_t ts = ring.tail_ts;
+    int64_t lat = ring.tail_lat, lon = ring.tail_lon, alt = ring.tail_alt;
+    for (uint32_t i = 0; i < ring.count; ++i)
+    {
+        if (i > 0)
+        {
+            const Delta& d = ring.slots[(ring.start + i) % capacity_];
+            ts += d.dt;
+            lat += d.dlat;
+            lon = NormalizeLon(lon + d.dlon);
+            alt += d.dalt;
+        }
+        if (ts * TICK_MS >= since_ms)
+            out.push_back({ts * TICK_MS, lat / DEG_SCALE, lon / DEG_SCALE, alt / ALT_SCALE});
+    }
+}
+
+void TrackHistoryStore::Remove(uint32_t track_id)
+{
+    auto it = rings_.find(track_id);
+    if (it == rings_.end())
+        return;
+    lru_.erase(it->second.lru_pos);
+    rings_.erase(it);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Bounded per-track position history.
+//
+// Each track keeps a fixed-capacity ring of 12-byte delta records
+// (1e-7 deg lat/lon, 0.1 m altitude, 10 ms time ticks) anchored on the oldest
+// retained sample. The whole store stays inside a fixed memory budget; when it
+// is exhausted the least recently updated track loses its history.
+// Not thread-safe: callers guard it with the fused track mutex.
+class TrackHistoryStore {
+public:
+    struct Sample {
+        int64_t timestamp_ms;
+        double lat;
+        double lon;
+        double alt;
+    };
+
+    TrackHistoryStore(size_t budget_bytes, size_t samples_per_track);
+
+    void Append(uint32_t track_id, int64_t timestamp_ms, double lat, double lon, double alt);
+
+    // Appends samples with timestamp >= since_ms to `out`, oldest first.
+    void Read(uint32_t track_id, int64_t since_ms, std::vector<Sample>& out) const;
+
+    void Remove(uint32_t track_id);
+
+    size_t TrackCount() const { return rings_.size(); }
+    size_t MemoryBytes() const { return rings_.size() * BytesPerTrack(); }
+
+private:
+    struct Delta {
+        int32_t dlat;   // 1e-7 deg
+        int32_t dlon;   // 1e-7 deg, wrapped to [-180, 180)
+        int16_t dalt;   // 0.1 m
+        uint16_t dt;    // 10 ms ticks
+    };
+    static_assert(sizeof(Delta) == 12, "history record must stay packed");
+
+    struct Ring {
+        // Absolute quantized values of the oldest and newest retained samples.
+        int64_t tail_ts, head_ts;
+        int32_t tail_lat, tail_lon, tail_alt;
+        int32_t head_lat, head_lon, head_alt;
+        uint32_t start = 0; // Slot of the oldest sample (its delta is unused)
+        uint32_t count = 0;
+        std::vector<Delta> slots;
+        std::list<uint32_t>::iterator lru_pos;
+    };
+
+    size_t BytesPerTrack() const { return capacity_ * sizeof(Delta) + sizeof(Ring); }
+    void Reset(Ring& ring, int64_t ts_ticks, int32_t lat, int32_t lon, int32_t alt);
+    void EvictOldest();
+
+    size_t capacity_;
+    size_t max_tracks_;
+    std::unordered_map<uint32_t, Ring> rings_;
+    std::list<uint32_t> lru_; // Front = most recently updated
+};
@@ -0,0 +1,159 @@
+#include "track_store.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Index of L(i, j), j <= i, in the packed lower triangle
+    inline int Tri(int i, int j)
+    {
+        return i * (i + 1) / 2 + j;
+    }
+}
+
+TrackStore::TrackStore(size_t budget_bytes)
+    : max_tracks_(std::max<size_t>(budget_bytes / BYTES_PER_TRACK, 1))
+{
+}
+
+void TrackStore::Pack(const KalmanFilter &kf, Record &r)
+{
+    double state[4], cov[16];
+    kf.ExportState(state, cov);
+    r.lat = state[0];
+    r.lon = state[1];
+    r.v_lat = (float)state[2];
+    r.v_lon = (float)state[3];
+
+    // Cholesky in double, rounded once at the end. A pivot that is not
+    // positive (P numerically semi-definite) zeroes its column.
+    double L[10];
+    for (int j = 0; j < 4; ++j)
+    {
+        double d = cov[j * 4 + j];
+        for (int k = 0; k < j; ++k)
+            d -= L[Tri(j, k)] * L[Tri(j, k)];
+        double ljj = d > 0.0 ? std::sqrt(d) : 0.0;
+        L[Tri(j, j)] = ljj;
+        for (int i = j + 1; i < 4; ++i)
+        {
+            double s = 0.5 * (cov[i * 4 + j] + cov[j * 4 + i]);
+            for (int k = 0; k < j; ++k)
+                s -= L[Tri(i, k)] * L[Tri(j, k)];
+            L[Tri(i, j)] = ljj > 0.0 ? s / ljj : 0.0;
+        }
+    }
+    for (int i = 0; i < 10; ++i)
+        r.chol[i] = (float)L[i];
+}
+
+void TrackStore::Unpack(const Record &r, KalmanFilter &kf)
+{
+    double state[4], cov[16];
+    Unpack(r, state, cov);
+    kf.ImportState(state, cov);
+}
+
+void TrackStore::Unpack(const Record &r, double state[4], double cov[16])
+{
+    state[0] = r.lat;
+    state[1] = r.lon;
+    state[2] = r.v_lat;
+    state[3] = r.v_lon;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            double s = 0.0;
+            for (int k = 0; k <= j; ++k)
+                s += (double)r.chol[Tri(i, k)] * (double)r.chol[Tri(j, k)];
+            cov[i * 4 + j] = cov[j * 4 + i] = s;
+        }
+    }
+}
+
+void TrackStore::CopyTo(Image &image) const
+{
+    image.records_ = records_;
+    image.ids_ = ids_;
+    image.updated_ns_ = updated_ns_;
+}
+
+bool TrackStore::Load(uint32_t track_id, KalmanFilter &kf) const
+{
+    uint32_t slot = index_.Find(track_id);
+    if (slot == TrackIndex::NONE)
+        return false;
+    Unpack(records_[slot], kf);
+    return true;
+}
+
+void TrackStore::Store(uint32_t track_id, const KalmanFilter &kf, uint64_t time_ns, std::vector<uint32_t> &evicted)
+{
+    if (!kf.IsInitialized())
+        return;
+
+    uint32_t slot = index_.Find(track_id);
+    if (slot == TrackIndex::NONE)
+    {
+        if (records_.size() >= max_tracks_)
+            EvictCoasting(evicted);
+        slot = (uint32_t)records_.size();
+        index_.Set(track_id, slot);
+        records_.emplace_back();
+        ids_.push_back(track_id);
+        updated_ns_.push_back(0);
+    }
+    Pack(kf, records_[slot]);
+    updated_ns_[slot] = std::max(updated_ns_[slot], time_ns);
+}
+
+void TrackStore::EvictCoasting(std::vector<uint32_t> &evicted)
+{
+    // One selection pass frees room for many inserts.
+    size_t n = std::max<size_t>(records_.size() / 64, 1);
+    std::vector<std::pair<uint64_t, uint32_t>> by_age;
+    by_age.reserve(records_.size());
+    for (size_t i = 0; i < records_.size(); ++i)
+        by_age.emplace_back(updated_ns_[i], ids_[i]);
+    std::nth_element(by_age.begin(), by_age.begin() + (n - 1), by_age.end());
+    for (size_t i = 0; i < n; ++i)
+    {
+        evicted.push_back(by_age[i].second);
+        Remove(by_age[i].second);
+    }
+}
+
+void TrackStore::Remove(uint32_t track_id)
+{
+    uint32_t slot = index_.Find(track_id);
+    if (slot == TrackIndex::NONE)
+        return;
+    index_.Clear(track_id);
+    RemoveSlot(slot);
+}
+
+void TrackStore::RemoveSlot(uint32_t slot)
+{
+    // The last record fills the hole, keeping the array dense.
+    uint32_t last = (uint32_t)records_.size() - 1;
+    if (slot != last)
+    {
+        records_[slot] = records_[last];
+        ids_[slot] = ids_[last];
+        updated_ns_[slot] = updated_ns_[last];
+        index_.Set(ids_[slot], slot);
+    }
+    records_.pop_back();
+    ids_.pop_back();
+    updated_ns_.pop_back();
+}
+
+void TrackStore::ForEach(const std::function<void(uint32_t, const KalmanFilter &)> &fn) const
+{
+    for (size_t i = 0; i < records_.size(); ++i)
+    {
+        Unpack(records_[i], scratch_);
+        fn(ids_[i], scratch_);
+    }
+}
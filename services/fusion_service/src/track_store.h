@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "kalman_filter.h"
+#include "track_table.h"
+
+// Compact, memory-budgeted store of the per-track filter states.
+//
+// A KalmanFilter carries four cv::Mat objects, each with its own heap block,
+// so keeping one per track scatters several hundred bytes per track around
+// the heap. The store keeps each track in one 64-byte record instead, in one
+// contiguous array: position in double (float would lose ~0.5 m), velocity
+// in float, and the covariance as the packed lower-triangular Cholesky
+// factor in float. The factor always reconstructs a positive semi-definite
+// covariance, which a rounded float copy of P would not. Filtering itself
+// stays in double: callers Load a track into a KalmanFilter, run the cycle
+// and Store it back.
+//
+// When the budget is full, inserting a track first evicts the tracks that
+// have coasted longest (oldest last update), 1/64 of the store at a time.
+// Not thread-safe: fusion thread only.
+class TrackStore {
+public:
+    explicit TrackStore(size_t budget_bytes);
+
+    // Copies the filter of `track_id` into `kf`. False, leaving `kf`
+    // untouched, when the store has no filter for the track.
+    bool Load(uint32_t track_id, KalmanFilter& kf) const;
+
+    // Stores an initialized filter; uninitialized ones are ignored.
+    // `time_ns` is the fusion time of its last update. Tracks evicted to
+    // make room are appended to `evicted`.
+    void Store(uint32_t track_id, const KalmanFilter& kf, uint64_t time_ns, std::vector<uint32_t>& evicted);
+
+    bool Contains(uint32_t track_id) const { return index_.Find(track_id) != TrackIndex::NONE; }
+    void Remove(uint32_t track_id);
+
+    // Calls fn for every stored track with its filter (a shared scratch
+    // filter, valid only during the call).
+    void ForEach(const std::function<void(uint32_t, const KalmanFilter&)>& fn) const;
+
+    size_t size() const { return records_.size(); }
+    size_t capacity() const { return max_tracks_; }
+    size_t MemoryBytes() const { return records_.size() * BYTES_PER_TRACK; }
+
+    // Copy of the dense arrays, readable on another thread.
+    class Image;
+
+    // Copies the arrays as they are (one memcpy each); nothing is unpacked.
+    void CopyTo(Image& image) const;
+
+private:
+    struct Record {
+        double lat, lon;        // deg
+        float v_lat, v_lon;     // deg/s
+        float chol[10];         // L with P = L L', rows of the lower triangle
+    };
+    static_assert(sizeof(Record) == 64, "track record must stay one cache line");
+
+    // Record, id, update time and index entry
+    static constexpr size_t BYTES_PER_TRACK = sizeof(Record) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+    static void Pack(const KalmanFilter& kf, Record& r);
+    static void Unpack(const Record& r, KalmanFilter& kf);
+    static void Unpack(const Record& r, double state[4], double cov[16]);
+    void EvictCoasting(std::vector<uint32_t>& evicted);
+    void RemoveSlot(uint32_t slot);
+
+    size_t max_tracks_;
+    std::vector<Record> records_;
+    std::vector<uint32_t> ids_;          // Parallel to records_
+    std::vector<uint64_t> updated_ns_;   // Parallel to records_
+    TrackIndex index_;                   // track id -> slot
+    mutable KalmanFilter scratch_;
+};
+
+class TrackStore::Image {
+public:
+    size_t size() const { return ids_.size(); }
+    uint32_t id(size_t i) const { return ids_[i]; }
+    uint64_t updated_ns(size_t i) const { return updated_ns_[i]; }
+
+    // State and row-major covariance of entry i, as ExportState gives them.
+    void Export(size_t i, double state[4], double cov[16]) const { Unpack(records_[i], state, cov); }
+
+private:
+    friend class TrackStore;
+    std::vector<Record> records_;
+    std::vector<uint32_t> ids_;
+    std::vector<uint64_t> updated_ns_;
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Track id -> slot lookup without per-entry allocation.
+//
+// Track ids are handed out sequentially (ResolveId), so the index is a
+// direct table over the id space, allocated in pages of 4096 ids the first
+// time an id in the page is used. Insert and erase only write a slot
+// number; a page once allocated stays (4 bytes per id ever used).
+class TrackIndex {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t Find(uint32_t track_id) const
+    {
+        size_t page = track_id >> PAGE_BITS;
+        if (page >= pages_.size() || !pages_[page])
+            return NONE;
+        return pages_[page][track_id & PAGE_MASK];
+    }
+
+    void Set(uint32_t track_id, uint32_t slot)
+    {
+        size_t page = track_id >> PAGE_BITS;
+        if (page >= pages_.size())
+            pages_.resize(page + 1);
+        if (!pages_[page])
+        {
+            pages_[page].reset(new uint32_t[PAGE_SIZE]);
+            std::fill(pages_[page].get(), pages_[page].get() + PAGE_SIZE, NONE);
+        }
+        pages_[page][track_id & PAGE_MASK] = slot;
+    }
+
+    void Clear(uint32_t track_id)
+    {
+        size_t page = track_id >> PAGE_BITS;
+        if (page < pages_.size() && pages_[page])
+            pages_[page][track_id & PAGE_MASK] = NONE;
+    }
+
+private:
+    static constexpr uint32_t PAGE_BITS = 12;
+    static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+    std::vector<std::unique_ptr<uint32_t[]>> pages_;
+};
+
+// Per-track objects in a slab with generational handles.
+//
+// Objects live in fixed blocks, so their addresses and slot numbers are
+// stable while the track exists, and slots can be used to index parallel
+// arrays. Erasing a track keeps its object: the next track created takes
+// the slot (most recently freed first) and gets the object back, reset by
+// the Recycle policy, with whatever it had allocated (strings, repeated
+// fields). Creating and deleting tracks therefore costs no allocation once
+// the table has seen its peak size.
+//
+// A Handle names one lifetime of a slot. Each create and erase bumps the
+// slot's generation (odd while live), so a handle kept past its track's
+// deletion resolves to nullptr instead of a different track.
+//
+// T must be default-constructible; Recycle resets a reused object (by
+// default through Clear()). Not thread-safe.
+template <typename T>
+struct ClearOnRecycle {
+    void operator()(T& obj) const { obj.Clear(); }
+};
+
+template <typename T, typename Recycle = ClearOnRecycle<T>>
+class TrackTable {
+public:
+    struct Handle {
+        uint32_t slot = 0;
+        uint32_t generation = 0; // 0 = null handle
+    };
+
+    // The object of `track_id`, created (cleared) if the track has none.
+    T& Emplace(uint32_t track_id)
+    {
+        uint32_t slot = index_.Find(track_id);
+        if (slot != TrackIndex::NONE)
+            return At(slot);
+
+        if (!free_.empty())
+        {
+            slot = free_.back();
+            free_.pop_back();
+            Recycle()(At(slot));
+        }
+        else
+        {
+            slot = (uint32_t)ids_.size();
+            if ((slot & BLOCK_MASK) == 0)
+                blocks_.emplace_back(new T[BLOCK_SIZE]);
+            ids_.push_back(0);
+            generations_.push_back(0);
+        }
+        ids_[slot] = track_id;
+        ++generations_[slot];
+        index_.Set(track_id, slot);
+        ++size_;
+        return At(slot);
+    }
+
+    T* Find(uint32_t track_id)
+    {
+        uint32_t slot = index_.Find(track_id);
+        return slot == TrackIndex::NONE ? nullptr : &At(slot);
+    }
+    const T* Find(uint32_t track_id) const
+    {
+        uint32_t slot = index_.Find(track_id);
+        return slot == TrackIndex::NONE ? nullptr : &At(slot);
+    }
+
+    bool Erase(uint32_t track_id)
+    {
+        uint32_t slot = index_.Find(track_id);
+        if (slot == TrackIndex::NONE)
+            return false;
+        index_.Clear(track_id);
+        ++generations_[slot];
+        free_.push_back(slot);
+        --size_;
+        return true;
+    }
+
+    Handle HandleOf(uint32_t track_id) const
+    {
+        uint32_t slot = index_.Find(track_id);
+        return slot == TrackIndex::NONE ? Handle{} : Handle{slot, generations_[slot]};
+    }
+
+    // Null once the handle's track has been erased.
+    T* Get(Handle h)
+    {
+        return Valid(h) ? &At(h.slot) : nullptr;
+    }
+    const T* Get(Handle h) const
+    {
+        return Valid(h) ? &At(h.slot) : nullptr;
+    }
+
+    // Calls fn(track_id, object) for every live track, in slot order.
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (uint32_t slot = 0; slot < ids_.size(); ++slot)
+        {
+            if (generations_[slot] & 1)
+                fn(ids_[slot], At(slot));
+        }
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Slots ever used; live ones are < slot_count().
+    uint32_t slot_count() const { return (uint32_t)ids_.size(); }
+    uint32_t SlotOf(uint32_t track_id) const { return index_.Find(track_id); }
+
+private:
+    static constexpr uint32_t BLOCK_BITS = 8;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+    static constexpr uint32_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    T& At(uint32_t slot) { return blocks_[slot >> BLOCK_BITS][slot & BLOCK_MASK]; }
+    const T& At(uint32_t slot) const { return blocks_[slot >> BLOCK_BITS][slot & BLOCK_MASK]; }
+
+    bool Valid(Handle h) const
+    {
+        return h.generation != 0 && h.slot < generations_.size() && generations_[h.slot] == h.generation;
+    }
+
+    std::vector<std::unique_ptr<T[]>> blocks_;
+    std::vector<uint32_t> ids_;          // Track id per slot
+    std::vector<uint32_t> generations_;  // Per slot, odd while live
+    std::vector<uint32_t> free_;
+    TrackIndex index_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,53 @@
+#include "track_update.h"
+
+#include <cmath>
+
+#include "geo_utils.h"
+
+double MeasurementSigma(const std::string &sensor_id)
+{
+    // If the radar client does not send sigma info inside the message,
+    // we assign a default based on sensor_id here.
+    if (sensor_id == "TPS-77-LONG-RANGE")
+        return 50.0;
+    if (sensor_id == "AN-MPQ-53-PATRIOT")
+        return 5.0;
+    return 30.0;
+}
+
+double PredictInterval(uint64_t last_fusion_ns, uint64_t batch_ns)
+{
+    if (last_fusion_ns == 0 || batch_ns <= last_fusion_ns)
+        return 0.0;
+    return (double)(batch_ns - last_fusion_ns) / 1e9;
+}
+
+bool GatedUpdate(KalmanFilter &kf, const std::string &sensor_id, double lat, double lon)
+{
+    // Kalman's R matrix is the variance: R = sigma^2
+    double base_R = std::pow(MeasurementSigma(sensor_id), 2);
+
+    double pred_lat, pred_lon, v_lat, v_lon;
+    kf.GetState(pred_lat, pred_lon, v_lat, v_lon);
+    double innovation = geo_utils::CalculateHaversine(lat, lon, pred_lat, pred_lon);
+
+    // Gating: Filter very large deviations (outliers)
+    double adaptive_R = base_R;
+    bool gated = innovation > 1000.0;
+    if (gated)
+    {
+        // If the measurement is very distant, increase R to desensitize the filter (Outlier Rejection)
+        adaptive_R = base_R * std::pow(innovation / 500.0, 2);
+    }
+
+    kf.Update(lat, lon, adaptive_R);
+    return gated;
+}
+
+bool RangeRateUpdate(KalmanFilter &kf, double range_rate, double bearing_deg, double sigma_mps)
+{
+    if (sigma_mps <= 0.0 || !kf.IsInitialized())
+        return false;
+    kf.UpdateRangeRate(range_rate, bearing_deg, sigma_mps);
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "kalman_filter.h"
+
+// Per-measurement filter logic of the fusion loop, shared with the
+// campaign runner so offline trials fuse exactly like the service.
+
+// Measurement noise sigma for a sensor (meters, as configured in
+// docker-compose); the filter uses R = sigma^2.
+double MeasurementSigma(const std::string &sensor_id);
+
+// Predict interval between two batches of a track in seconds, from their
+// times on the fusion clock (ns). 0 for the first batch and for a batch
+// older than the last one: the filter is never predicted backwards.
+double PredictInterval(uint64_t last_fusion_ns, uint64_t batch_ns);
+
+// Updates the filter with one position measurement. Measurements more than
+// 1 km from the prediction have R inflated quadratically instead of being
+// dropped. Returns true when the measurement was gated that way.
+bool GatedUpdate(KalmanFilter &kf, const std::string &sensor_id, double lat, double lon);
+
+// Applies a radar Doppler range rate after the position update. Returns
+// false (no update) when the measurement carries no Doppler (sigma 0).
+bool RangeRateUpdate(KalmanFilter &kf, double range_rate, double bearing_deg, double sigma_mps);
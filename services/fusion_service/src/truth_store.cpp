@@ -0,0 +1,132 @@
+#include "truth_store.h"
+#include <algorithm>
+
+namespace
+{
+    // Linear interpolation with the longitude difference wrapped to (-180, 180].
+    TruthStore::Point Lerp(const TruthStore::Point& a, const TruthStore::Point& b, double f)
+    {
+        double dlon = b.lon - a.lon;
+        if (dlon > 180.0)
+            dlon -= 360.0;
+        else if (dlon <= -180.0)
+            dlon += 360.0;
+
+        TruthStore::Point p;
+        p.lat = a.lat + (b.lat - a.lat) * f;
+        p.lon = a.lon + dlon * f;
+        if (p.lon > 180.0)
+            p.lon -= 360.0;
+        else if (p.lon <= -180.0)
+            p.lon += 360.0;
+        p.alt = a.alt + (b.alt - a.alt) * f;
+        return p;
+    }
+
+    int64_t FloorDiv(int64_t a, int64_t b)
+    {
+        int64_t q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+}
+
+TruthStore::TruthStore(int64_t bucket_ms, size_t buckets, int64_t max_extrapolation_ms)
+    : bucket_ms_(std::max<int64_t>(bucket_ms, 1)),
+      buckets_(std::max<size_t>(buckets, 2)),
+      max_extrapolation_ms_(max_extrapolation_ms)
+{}
+
+const TruthStore::Point& TruthStore::Grid(const Track& t, int64_t bucket) const
+{
+    return t.grid[(size_t)(bucket % (int64_t)buckets_)];
+}
+
+void TruthStore::Add(uint32_t track_id, int64_t timestamp_ms, double lat, double lon, double alt)
+{
+    Track& t = tracks_[track_id];
+    Sample s{timestamp_ms, {lat, lon, alt}};
+
+    if (t.samples == 0)
+    {
+        t.grid.resize(buckets_);
+        // The grid starts at the first instant at or after the first sample.
+        t.first_bucket = FloorDiv(timestamp_ms + bucket_ms_ - 1, bucket_ms_);
+        t.last_bucket = t.first_bucket - 1;
+        if (t.first_bucket * bucket_ms_ == timestamp_ms)
+        {
+            t.grid[(size_t)(t.first_bucket % (int64_t)buckets_)] = s.p;
+            t.last_bucket = t.first_bucket;
+        }
+        t.prev = t.last = s;
+        t.samples = 1;
+        return;
+    }
+
+    if (timestamp_ms <= t.last.ts)
+        return;
+
+    // Fill every grid instant in (last.ts, timestamp_ms] from the new segment.
+    // A long gap only needs the newest `buckets_` instants.
+    int64_t to = FloorDiv(timestamp_ms, bucket_ms_);
+    int64_t from = std::max(t.last_bucket + 1, to - (int64_t)buckets_ + 1);
+    double span = (double)(timestamp_ms - t.last.ts);
+    for (int64_t k = from; k <= to; ++k)
+    {
+        double f = (double)(k * bucket_ms_ - t.last.ts) / span;
+        t.grid[(size_t)(k % (int64_t)buckets_)] = Lerp(t.last.p, s.p, f);
+    }
+    if (to >= from)
+    {
+        if (from > t.last_bucket + 1)
+            t.first_bucket = from; // Grid restarted after the gap
+        t.last_bucket = to;
+    }
+
+    t.prev = t.last;
+    t.last = s;
+    t.samples++;
+}
+
+bool TruthStore::Lookup(uint32_t track_id, int64_t timestamp_ms, Point& out) const
+{
+    auto it = tracks_.find(track_id);
+    if (it == tracks_.end())
+        return false;
+    const Track& t = it->second;
+
+    if (timestamp_ms >= t.last.ts)
+    {
+        int64_t ahead = timestamp_ms - t.last.ts;
+        if (ahead == 0)
+        {
+            out = t.last.p;
+            return true;
+        }
+        if (ahead > max_extrapolation_ms_ || t.samples < 2)
+            return false;
+        double f = (double)(timestamp_ms - t.prev.ts) / (double)(t.last.ts - t.prev.ts);
+        out = Lerp(t.prev.p, t.last.p, f);
+        return true;
+    }
+
+    if (t.last_bucket < t.first_bucket)
+        return false;
+
+    int64_t lo = std::max(t.first_bucket, t.last_bucket - (int64_t)buckets_ + 1);
+    int64_t k = FloorDiv(timestamp_ms, bucket_ms_);
+    if (k < lo)
+        return false;
+
+    if (k >= t.last_bucket)
+    {
+        // Between the newest grid instant and the newest sample.
+        int64_t g = t.last_bucket * bucket_ms_;
+        double f = (double)(timestamp_ms - g) / (double)(t.last.ts - g);
+        out = Lerp(Grid(t, t.last_bucket), t.last.p, f);
+        return true;
+    }
+
+    double f = (double)(timestamp_ms - k * bucket_ms_) / (double)bucket_ms_;
+    out = Lerp(Grid(t, k), Grid(t, k + 1), f);
+    return true;
+}
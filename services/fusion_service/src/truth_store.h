@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Time-indexed ground truth per track.
+//
+// Truth samples (UAV self-reported positions) are resampled onto a fixed time
+// grid as they arrive, so the truth at any fused timestamp is an O(1) lookup:
+// two grid points and a linear interpolation. Lookups past the newest sample
+// are extrapolated from the last segment for at most max_extrapolation_ms.
+// Not thread-safe: owned by the fusion loop.
+class TruthStore {
+public:
+    struct Point {
+        double lat;
+        double lon;
+        double alt;
+    };
+
+    TruthStore(int64_t bucket_ms, size_t buckets, int64_t max_extrapolation_ms);
+
+    // Samples older than the newest one already stored for the track are ignored.
+    void Add(uint32_t track_id, int64_t timestamp_ms, double lat, double lon, double alt);
+
+    // Truth for the track at timestamp_ms. False when the time is outside the
+    // retained window or no truth exists for the track.
+    bool Lookup(uint32_t track_id, int64_t timestamp_ms, Point& out) const;
+
+private:
+    struct Sample {
+        int64_t ts;
+        Point p;
+    };
+
+    struct Track {
+        std::vector<Point> grid; // grid[k % size] = truth at k * bucket_ms
+        int64_t first_bucket = 0;
+        int64_t last_bucket = -1; // Empty while < first_bucket
+        Sample prev{};
+        Sample last{};
+        size_t samples = 0;
+    };
+
+    const Point& Grid(const Track& t, int64_t bucket) const;
+
+    int64_t bucket_ms_;
+    size_t buckets_;
+    int64_t max_extrapolation_ms_;
+    std::unordered_map<uint32_t, Track> tracks_;
+};
@@ -0,0 +1,284 @@
+#include "load_generator.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+    const std::string TARGET_PREFIX = "LOADGEN-";
+
+    double Percentile(const std::vector<double> &sorted, double q)
+    {
+        if (sorted.empty())
+            return 0.0;
+        size_t idx = static_cast<size_t>(std::ceil(q * sorted.size())) - 1;
+        return sorted[std::min(idx, sorted.size() - 1)];
+    }
+
+    int64_t NowMs()
+    {
+        auto now = std::chrono::system_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    }
+
+    int64_t MonotonicNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+LoadGenerator::LoadGenerator(const LoadConfig &config) : config_(config)
+{
+    for (int i = 0; i < config_.targets; ++i)
+        pending_.push_back(std::make_unique<PendingTarget>());
+}
+
+std::shared_ptr<grpc::Channel> LoadGenerator::MakeChannel(const std::string &addr) const
+{
+    // A private subchannel pool gives every stream its own TCP connection,
+    // like separate sensor processes would have.
+    grpc::ChannelArguments args;
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    return grpc::CreateCustomChannel(addr, grpc::InsecureChannelCredentials(), args);
+}
+
+void LoadGenerator::TargetPosition(int target, double t_sec, double &lat, double &lon) const
+{
+    double lat0 = 39.5 + 0.01 * (target / 32);
+    double lon0 = 32.5 + 0.01 * (target % 32);
+    double heading_rad = std::fmod(target * 37.0, 360.0) * M_PI / 180.0;
+    double speed = 100.0; // m/s
+
+    lat = lat0 + speed * std::cos(heading_rad) * t_sec / METERS_PER_DEG_LAT;
+    lon = lon0 + speed * std::sin(heading_rad) * t_sec / (METERS_PER_DEG_LAT * std::cos(lat0 * M_PI / 180.0));
+}
+
+void LoadGenerator::RadarStreamLoop(int stream_index)
+{
+    auto stub = fusion::FusionService::NewStub(MakeChannel(config_.fusion_addr));
+    grpc::ClientContext ctx;
+    fusion::FusionAck ack;
+    auto writer = stub->StreamRadar(&ctx, &ack);
+
+    std::mt19937 gen(1000 + stream_index);
+    std::normal_distribution<> noise_m(0.0, 20.0);
+    const std::string sensor_id = "LOADGEN-RADAR-" + std::to_string(stream_index);
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / config_.radar_rate_hz));
+
+    auto next = Clock::now();
+    uint64_t seq = 0;
+    sensors::RadarDetection msg;
+    while (sending_)
+    {
+        int target = static_cast<int>((seq++ + stream_index) % config_.targets);
+        double t_sec = std::chrono::duration<double>(Clock::now() - start_).count();
+        double lat, lon;
+        TargetPosition(target, t_sec, lat, lon);
+        lat += noise_m(gen) / METERS_PER_DEG_LAT;
+        lon += noise_m(gen) / METERS_PER_DEG_LAT;
+
+        int64_t ts = NowMs();
+        msg.mutable_header()->set_timestamp(ts);
+        msg.mutable_header()->set_timestamp_ns(MonotonicNs());
+        msg.mutable_header()->set_sensor_id(sensor_id);
+        msg.set_track_id(TARGET_PREFIX + std::to_string(target));
+        msg.set_radar_lat(lat);
+        msg.set_radar_lon(lon);
+        msg.set_radar_alt(1000.0);
+
+        // Register before writing so a fast publish can never precede it.
+        {
+            PendingTarget &p = *pending_[target];
+            std::lock_guard<std::mutex> lock(p.mtx);
+            p.sent.emplace_back(ts, Clock::now());
+        }
+
+        if (!writer->Write(msg))
+        {
+            write_failures_++;
+            break;
+        }
+        radar_sent_++;
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    writer->WritesDone();
+    grpc::Status status = writer->Finish();
+    if (!status.ok())
+        std::cerr << "[LOADGEN] " << sensor_id << " stream closed with error: " << status.error_message() << std::endl;
+}
+
+void LoadGenerator::UAVStreamLoop(int stream_index)
+{
+    auto stub = fusion::FusionService::NewStub(MakeChannel(config_.fusion_addr));
+    grpc::ClientContext ctx;
+    fusion::FusionAck ack;
+    auto writer = stub->StreamUAV(&ctx, &ack);
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / config_.uav_rate_hz));
+
+    auto next = Clock::now();
+    uint64_t seq = 0;
+    sensors::UAVTelemetry msg;
+    while (sending_)
+    {
+        int target = static_cast<int>((seq++ + stream_index) % config_.targets);
+        double t_sec = std::chrono::duration<double>(Clock::now() - start_).count();
+        double lat, lon;
+        TargetPosition(target, t_sec, lat, lon);
+
+        msg.mutable_header()->set_timestamp(NowMs());
+        msg.mutable_header()->set_timestamp_ns(MonotonicNs());
+        msg.mutable_header()->set_sensor_id("LOADGEN-UAV-" + std::to_string(stream_index));
+        msg.set_uav_id(TARGET_PREFIX + std::to_string(target));
+        msg.mutable_position()->set_lat(lat);
+        msg.mutable_position()->set_lon(lon);
+        msg.mutable_position()->set_alt(1000.0);
+        msg.set_speed(100.0);
+        msg.set_status("Flying");
+
+        if (!writer->Write(msg))
+        {
+            write_failures_++;
+            break;
+        }
+        uav_sent_++;
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    writer->WritesDone();
+    writer->Finish();
+}
+
+void LoadGenerator::MonitorLoop()
+{
+    auto stub = fusion::FusionMonitor::NewStub(MakeChannel(config_.monitor_addr));
+    grpc::ClientContext ctx;
+    {
+        std::lock_guard<std::mutex> lock(monitor_ctx_mtx_);
+        monitor_ctx_ = &ctx;
+    }
+
+    fusion::MonitorRequest req;
+    req.set_continuous(true);
+    auto reader = stub->SubscribeFusedTracks(&ctx, req);
+    monitoring_ = true;
+
+    std::vector<int64_t> last_ts(config_.targets, 0);
+    fusion::MonitorResponse resp;
+    while (reader->Read(&resp))
+    {
+        auto now = Clock::now();
+        for (const auto &t : resp.tracks())
+        {
+            const std::string &ext = t.external_id();
+            if (ext.compare(0, TARGET_PREFIX.size(), TARGET_PREFIX) != 0)
+                continue;
+            int target = std::atoi(ext.c_str() + TARGET_PREFIX.size());
+            if (target < 0 || target >= config_.targets || t.measurement_ts() <= last_ts[target])
+                continue;
+
+            // Every message for this target up to measurement_ts is now visible.
+            last_ts[target] = t.measurement_ts();
+            ++track_updates_;
+            PendingTarget &p = *pending_[target];
+            std::lock_guard<std::mutex> lock(p.mtx);
+            while (!p.sent.empty() && p.sent.front().first <= t.measurement_ts())
+            {
+                if (p.sent.front().second >= measure_from_)
+                    latencies_ms_.push_back(std::chrono::duration<double, std::milli>(now - p.sent.front().second).count());
+                p.sent.pop_front();
+            }
+        }
+    }
+
+    grpc::Status status = reader->Finish();
+    if (!status.ok() && status.error_code() != grpc::StatusCode::CANCELLED)
+        std::cerr << "[LOADGEN] Monitor subscription failed: " << status.error_message() << std::endl;
+
+    std::lock_guard<std::mutex> lock(monitor_ctx_mtx_);
+    monitor_ctx_ = nullptr;
+    monitoring_ = false;
+}
+
+LoadReport LoadGenerator::Run()
+{
+    start_ = Clock::now();
+    measure_from_ = start_ + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double>(config_.warmup_sec));
+
+    std::thread monitor_thread(&LoadGenerator::MonitorLoop, this);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    sending_ = true;
+    std::vector<std::thread> senders;
+    for (int i = 0; i < config_.radar_streams; ++i)
+        senders.emplace_back(&LoadGenerator::RadarStreamLoop, this, i);
+    for (int i = 0; i < config_.uav_streams; ++i)
+        senders.emplace_back(&LoadGenerator::UAVStreamLoop, this, i);
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(config_.duration_sec));
+    sending_ = false;
+    for (auto &t : senders)
+        t.join();
+    auto send_end = Clock::now();
+
+    // Give the service a few fusion cycles to publish what is still queued.
+    auto drain_deadline = Clock::now() + std::chrono::seconds(3);
+    while (Clock::now() < drain_deadline && monitoring_)
+    {
+        bool drained = true;
+        for (auto &p : pending_)
+        {
+            std::lock_guard<std::mutex> lock(p->mtx);
+            if (!p->sent.empty())
+            {
+                drained = false;
+                break;
+            }
+        }
+        if (drained)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(monitor_ctx_mtx_);
+        if (monitor_ctx_)
+            monitor_ctx_->TryCancel();
+    }
+    monitor_thread.join();
+
+    LoadReport report;
+    report.radar_sent = radar_sent_;
+    report.uav_sent = uav_sent_;
+    report.write_failures = write_failures_;
+    report.track_updates = track_updates_;
+    report.elapsed_sec = std::chrono::duration<double>(send_end - measure_from_).count();
+    report.published = latencies_ms_.size();
+    for (auto &p : pending_)
+    {
+        for (const auto &entry : p->sent)
+        {
+            if (entry.second >= measure_from_)
+                report.unpublished++;
+        }
+    }
+
+    std::sort(latencies_ms_.begin(), latencies_ms_.end());
+    report.p50_ms = Percentile(latencies_ms_, 0.50);
+    report.p99_ms = Percentile(latencies_ms_, 0.99);
+    report.p999_ms = Percentile(latencies_ms_, 0.999);
+    report.max_ms = latencies_ms_.empty() ? 0.0 : latencies_ms_.back();
+    return report;
+}
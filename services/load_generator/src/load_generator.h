@@ -0,0 +1,87 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "fusion/fusion.grpc.pb.h"
+
+// Load profile for one run. Rates are per stream.
+struct LoadConfig
+{
+    std::string fusion_addr = "localhost:6000";
+    std::string monitor_addr = "localhost:6005";
+    int radar_streams = 4;
+    int uav_streams = 1;
+    double radar_rate_hz = 100.0;
+    double uav_rate_hz = 10.0;
+    int targets = 10;
+    double duration_sec = 10.0;
+    double warmup_sec = 1.0;
+};
+
+struct LoadReport
+{
+    uint64_t radar_sent = 0;
+    uint64_t uav_sent = 0;
+    uint64_t write_failures = 0;
+    uint64_t published = 0;   // Radar messages observed in a published track update
+    uint64_t unpublished = 0; // Radar messages never observed before the run ended
+    uint64_t track_updates = 0;
+    double elapsed_sec = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double p999_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+// Drives concurrent StreamRadar/StreamUAV streams against a fusion_service and
+// measures sensor-to-publish latency through a continuous FusionMonitor
+// subscription.
+class LoadGenerator
+{
+public:
+    explicit LoadGenerator(const LoadConfig &config);
+
+    LoadReport Run();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Messages sent for one target that have not been seen in a publish yet.
+    struct PendingTarget
+    {
+        std::mutex mtx;
+        std::deque<std::pair<int64_t, Clock::time_point>> sent; // header ts (ms), send time
+    };
+
+    void RadarStreamLoop(int stream_index);
+    void UAVStreamLoop(int stream_index);
+    void MonitorLoop();
+
+    // Deterministic straight-line trajectory per target.
+    void TargetPosition(int target, double t_sec, double &lat, double &lon) const;
+    std::shared_ptr<grpc::Channel> MakeChannel(const std::string &addr) const;
+
+    LoadConfig config_;
+    Clock::time_point start_;
+    Clock::time_point measure_from_;
+    std::atomic<bool> sending_{false};
+    std::atomic<bool> monitoring_{false};
+    grpc::ClientContext *monitor_ctx_ = nullptr;
+    std::mutex monitor_ctx_mtx_;
+
+    std::vector<std::unique_ptr<PendingTarget>> pending_;
+
+    std::atomic<uint64_t> radar_sent_{0};
+    std::atomic<uint64_t> uav_sent_{0};
+    std::atomic<uint64_t> write_failures_{0};
+    uint64_t track_updates_ = 0;
+    std::vector<double> latencies_ms_; // Owned by the monitor thread
+};
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+
+#include "load_generator.h"
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: load_generator [options]\n"
+                  << "  --fusion=ADDR         FusionService address (default localhost:6000)\n"
+                  << "  --monitor=ADDR        FusionMonitor address (default localhost:6005)\n"
+                  << "  --radar-streams=N     Concurrent StreamRadar streams (default 4)\n"
+                  << "  --uav-streams=N       Concurrent StreamUAV streams (default 1)\n"
+                  << "  --radar-rate=HZ       Detections per second per radar stream (default 100)\n"
+                  << "  --uav-rate=HZ         Telemetry messages per second per UAV stream (default 10)\n"
+                  << "  --targets=N           Number of simulated targets (default 10)\n"
+                  << "  --duration=SEC        Measurement duration (default 10)\n"
+                  << "  --warmup=SEC          Leading seconds excluded from latency stats (default 1)\n";
+    }
+
+    bool ParseArg(const std::string &arg, const std::string &key, std::string &value)
+    {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    LoadConfig cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], v;
+        if (ParseArg(arg, "fusion", v)) cfg.fusion_addr = v;
+        else if (ParseArg(arg, "monitor", v)) cfg.monitor_addr = v;
+        else if (ParseArg(arg, "radar-streams", v)) cfg.radar_streams = std::stoi(v);
+        else if (ParseArg(arg, "uav-streams", v)) cfg.uav_streams = std::stoi(v);
+        else if (ParseArg(arg, "radar-rate", v)) cfg.radar_rate_hz = std::stod(v);
+        else if (ParseArg(arg, "uav-rate", v)) cfg.uav_rate_hz = std::stod(v);
+        else if (ParseArg(arg, "targets", v)) cfg.targets = std::stoi(v);
+        else if (ParseArg(arg, "duration", v)) cfg.duration_sec = std::stod(v);
+        else if (ParseArg(arg, "warmup", v)) cfg.warmup_sec = std::stod(v);
+        else
+        {
+            PrintUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    if (cfg.targets <= 0 || cfg.radar_rate_hz <= 0 || cfg.uav_rate_hz <= 0)
+    {
+        std::cerr << "[LOADGEN] targets and rates must be positive." << std::endl;
+        return 1;
+    }
+
+    std::cout << "[LOADGEN] " << cfg.radar_streams << " radar x " << cfg.radar_rate_hz << " Hz, "
+              << cfg.uav_streams << " uav x " << cfg.uav_rate_hz << " Hz, "
+              << cfg.targets << " targets, " << cfg.duration_sec << " s -> "
+              << cfg.fusion_addr << " / " << cfg.monitor_addr << std::endl;
+
+    LoadGenerator generator(cfg);
+    LoadReport r = generator.Run();
+
+    double window = r.elapsed_sec > 0 ? r.elapsed_sec : 1.0;
+    std::cout << "==================== LOAD REPORT ====================\n"
+              << std::fixed << std::setprecision(1)
+              << "Radar sent        : " << r.radar_sent << " (" << r.radar_sent / cfg.duration_sec << " msg/s)\n"
+              << "UAV sent          : " << r.uav_sent << "\n"
+              << "Write failures    : " << r.write_failures << "\n"
+              << "Published         : " << r.published << " (" << r.published / window << " msg/s)\n"
+              << "Unpublished       : " << r.unpublished << "\n"
+              << "Track updates     : " << r.track_updates << "\n"
+              << std::setprecision(2)
+              << "Latency p50  (ms) : " << r.p50_ms << "\n"
+              << "Latency p99  (ms) : " << r.p99_ms << "\n"
+              << "Latency p999 (ms) : " << r.p999_ms << "\n"
+              << "Latency max  (ms) : " << r.max_ms << "\n"
+              << "=====================================================" << std::endl;
+    return 0;
+}
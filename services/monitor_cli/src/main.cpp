@@ -1,19 +1,91 @@
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
-#include <chrono>
-#include <thread>
-#include <iomanip>
 
 #include "monitor_cli.h"
 
+namespace {
+    void PrintUsage() {
+        std::cout << "Usage: monitor_cli [ADDR] [options]\n"
+                  << "  ADDR                  FusionMonitor address (default localhost:6005)\n"
+                  << "  --sort=KEY            id, error or conf (default id)\n"
+                  << "  --desc                Sort descending\n"
+                  << "  --source=SENSOR       Only tracks fed by this sensor (e.g. RADAR-1)\n"
+                  << "  --region=A,B,C,D      Only tracks inside min_lat,min_lon,max_lat,max_lon\n"
+                  << "  --smoothed            Show the fixed-lag smoothed tracks\n"
+                  << "  --multicast=GROUP:PORT  Read the fusion multicast output instead of gRPC\n"
+                  << "  --refresh-ms=N        Screen refresh / key poll interval (default 250)\n";
+    }
+
+    bool ParseArg(const std::string& arg, const std::string& key, std::string& value) {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+
+    bool ParseRegion(const std::string& v, fusion::GeoRegion& region) {
+        std::istringstream in(v);
+        double c[4];
+        char sep;
+        for (int i = 0; i < 4; ++i) {
+            if (!(in >> c[i]) || (i < 3 && !(in >> sep && sep == ',')))
+                return false;
+        }
+        region.set_min_lat(c[0]);
+        region.set_min_lon(c[1]);
+        region.set_max_lat(c[2]);
+        region.set_max_lon(c[3]);
+        return true;
+    }
+
+    bool ParseGroup(const std::string& v, MonitorCLI::Options& options) {
+        size_t colon = v.rfind(':');
+        options.multicast_group = v.substr(0, colon);
+        if (colon != std::string::npos)
+            options.multicast_port = std::atoi(v.c_str() + colon + 1);
+        return !options.multicast_group.empty() && options.multicast_port > 0;
+    }
+}
+
 int main(int argc, char** argv) {
     std::string monitor_addr = "localhost:6005";
-    if (argc > 1) monitor_addr = argv[1];
+    MonitorCLI::Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i], v;
+        if (ParseArg(arg, "sort", v) && (v == "id" || v == "error" || v == "conf")) {
+            options.sort = v == "error" ? MonitorCLI::SortKey::ERROR
+                         : v == "conf"  ? MonitorCLI::SortKey::CONFIDENCE
+                                        : MonitorCLI::SortKey::ID;
+        }
+        else if (arg == "--desc") options.descending = true;
+        else if (arg == "--smoothed") options.smoothed = true;
+        else if (ParseArg(arg, "source", v)) options.source = v;
+        else if (ParseArg(arg, "region", v) && ParseRegion(v, options.region)) options.has_region = true;
+        else if (ParseArg(arg, "refresh-ms", v)) options.refresh_ms = std::max(std::stoi(v), 10);
+        else if (ParseArg(arg, "multicast", v) && ParseGroup(v, options)) continue;
+        else if (arg.compare(0, 2, "--") != 0 && arg != "-h") monitor_addr = arg;
+        else {
+            PrintUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    if (options.smoothed && !options.multicast_group.empty()) {
+        std::cerr << "--smoothed is only available over gRPC" << std::endl;
+        return 1;
+    }
 
-    std::cout << "Monitor CLI connecting to " << monitor_addr << "..." << std::endl;
-    MonitorCLI cli(monitor_addr);
+    if (options.multicast_group.empty())
+        std::cout << "Monitor CLI connecting to " << monitor_addr << "..." << std::endl;
+    else
+        std::cout << "Monitor CLI joining " << options.multicast_group << ":" << options.multicast_port << "..." << std::endl;
+    MonitorCLI cli(monitor_addr, options);
     cli.Run();
 
     return 0;
-}
\ No newline at end of file
+}
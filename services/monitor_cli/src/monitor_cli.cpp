@@ -1,135 +1,375 @@
 #include "monitor_cli.h"
-#include <iostream>
+#include "track_multicast.h"
+#include <algorithm>
 #include <chrono>
-#include <thread>
-#include <iomanip>
+#include <csignal>
+#include <cstdio>
 
-MonitorCLI::MonitorCLI(const std::string &fusion_addr)
+namespace
 {
+    volatile std::sig_atomic_t g_stop = 0;
+
+    void OnSignal(int)
+    {
+        g_stop = 1;
+    }
+
+    constexpr int HEADER_ROWS = 3; // Title, column names, rule
+    constexpr int FOOTER_ROWS = 1; // Keys and connection status
+
+    const char *SortName(MonitorCLI::SortKey key)
+    {
+        switch (key)
+        {
+        case MonitorCLI::SortKey::ERROR:
+            return "error";
+        case MonitorCLI::SortKey::CONFIDENCE:
+            return "conf";
+        default:
+            return "id";
+        }
+    }
+
+    bool HasSource(const fusion::FusedTrack &t, const std::string &source)
+    {
+        for (const auto &s : t.source_sensors())
+        {
+            if (s == source)
+                return true;
+        }
+        return false;
+    }
+}
+
+MonitorCLI::MonitorCLI(const std::string &fusion_addr, const Options &options)
+    : addr_(fusion_addr), options_(options)
+{
+    if (!options_.multicast_group.empty())
+    {
+        addr_ = "udp://" + options_.multicast_group + ":" + std::to_string(options_.multicast_port);
+        status_ = "Waiting for keyframe...";
+        subscriber_ = std::thread(&MonitorCLI::MulticastLoop, this);
+        return;
+    }
     auto channel = grpc::CreateChannel(fusion_addr, grpc::InsecureChannelCredentials());
     stub_ = fusion::FusionMonitor::NewStub(channel);
+    status_ = "Connecting...";
+    subscriber_ = std::thread(&MonitorCLI::SubscribeLoop, this);
 }
 
-void MonitorCLI::ClearScreen()
+MonitorCLI::~MonitorCLI()
 {
-#ifdef _WIN32
-    system("cls");
-#else
-    // ANSI clear for most UNIX terminals
-    std::cout << "\033[2J\033[H";
-#endif
+    {
+        std::lock_guard<std::mutex> lock(picture_mtx_);
+        running_ = false;
+        if (active_ctx_)
+            active_ctx_->TryCancel();
+    }
+    if (subscriber_.joinable())
+        subscriber_.join();
 }
 
-void MonitorCLI::PrintTable(const std::vector<fusion::FusedTrack> &tracks)
+void MonitorCLI::SubscribeLoop()
 {
-    std::cout << "==================== FUSED TRACK MONITOR ====================\n";
-    std::cout << std::left << std::setw(12) << "TRACK ID"
-              << std::setw(12) << "LAT"
-              << std::setw(12) << "LON"
-              << std::setw(14) << "ALT(m)"
-              << std::setw(10) << "CONF"
-              << std::setw(12) << "ERR(m)"
-              << std::setw(18) << "SOURCES"
-              << "\n";
-    std::cout << "------------------------------------------------------------\n";
-
-    for (const auto &t : tracks)
+    fusion::MonitorRequest req;
+    req.set_continuous(true);
+    req.set_smoothed(options_.smoothed);
+    if (options_.has_region)
+        *req.mutable_region() = options_.region;
+
+    while (running_)
     {
-        // If we have a UAV source, show external UAV id as the primary label (Estimated)
-        std::string primary_label;
-        for (int i = 0; i < t.source_sensors_size(); ++i)
+        grpc::ClientContext ctx;
         {
-            if (t.source_sensors(i).rfind("UAV", 0) == 0)
-            {
-                primary_label = t.source_sensors(i) + std::string(" (Estimated)");
+            std::lock_guard<std::mutex> lock(picture_mtx_);
+            if (!running_)
                 break;
-            }
+            active_ctx_ = &ctx;
         }
-        if (primary_label.empty())
-            primary_label = std::to_string(t.track_id());
-
-        std::cout << std::left << std::setw(12) << primary_label
-                  << std::fixed << std::setprecision(5)
-                  << std::setw(12) << t.position().lat()
-                  << std::setw(12) << t.position().lon()
-                  << std::setw(14) << t.position().alt()
-                  << std::setw(10) << std::setprecision(3) << t.confidence()
-                  << std::setprecision(6);
-
-        // Build sources string
-        std::string srcs;
-        for (int i = 0; i < t.source_sensors_size(); ++i)
+
+        // Every message is a whole picture; only the newest is kept.
+        std::unique_ptr<grpc::ClientReader<fusion::MonitorResponse>> reader(stub_->SubscribeFusedTracks(&ctx, req));
+        auto resp = std::make_shared<fusion::MonitorResponse>();
+        while (reader->Read(resp.get()))
         {
-            if (i)
-                srcs += ",";
-            srcs += t.source_sensors(i);
+            std::lock_guard<std::mutex> lock(picture_mtx_);
+            picture_ = std::move(resp);
+            ++picture_seq_;
+            status_.clear();
+            resp = std::make_shared<fusion::MonitorResponse>();
         }
-        // print error (if present) and sources
-        double err = 0.0;
-        // fused proto now contains uav_error_m
-        err = t.uav_error_m();
-        std::cout << std::setw(12) << std::fixed << std::setprecision(1) << err;
-        std::cout << std::setw(18) << srcs << "\n";
-
-        // If we have a reported UAV position, print it on a separate line for comparison
-        if (t.uav_reported().lat() != 0.0 || t.uav_reported().lon() != 0.0)
+        grpc::Status status = reader->Finish();
+
         {
-            std::string uav_id;
-            for (int i = 0; i < t.source_sensors_size(); ++i)
-            {
-                // heuristically pick the first source that starts with "UAV"
-                if (t.source_sensors(i).rfind("UAV", 0) == 0)
-                {
-                    uav_id = t.source_sensors(i);
-                    break;
-                }
-            }
-            if (uav_id.empty())
+            std::lock_guard<std::mutex> lock(picture_mtx_);
+            active_ctx_ = nullptr;
+            status_ = status.ok() ? "Stream closed, reconnecting..."
+                                  : "Fusion service unreachable: " + status.error_message();
+        }
+        for (int i = 0; i < 10 && running_; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+void MonitorCLI::MulticastLoop()
+{
+    std::unique_ptr<mcast::Receiver> rx = mcast::Receiver::Open(options_.multicast_group, options_.multicast_port);
+    if (!rx)
+    {
+        std::lock_guard<std::mutex> lock(picture_mtx_);
+        status_ = "Cannot join multicast group " + options_.multicast_group;
+        return;
+    }
+
+    // Datagrams are applied as they arrive; the picture handed to the UI
+    // is rebuilt at most once per refresh interval.
+    const fusion::GeoRegion &region = options_.region;
+    auto last_build = std::chrono::steady_clock::now() - std::chrono::hours(1);
+    uint64_t built_cycle = 0;
+    while (running_)
+    {
+        rx->Poll(std::min(options_.refresh_ms, 100));
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_build < std::chrono::milliseconds(options_.refresh_ms))
+            continue;
+
+        std::string status;
+        const mcast::Receiver::Stats &st = rx->stats();
+        if (!rx->synced())
+            status = "Waiting for keyframe...";
+        if (st.lost > 0)
+            status += (status.empty() ? "" : " ") + std::to_string(st.lost) + " datagrams lost";
+
+        std::shared_ptr<fusion::MonitorResponse> resp;
+        if (rx->last_cycle() != built_cycle)
+        {
+            built_cycle = rx->last_cycle();
+            resp = std::make_shared<fusion::MonitorResponse>();
+            for (const auto &entry : rx->tracks())
             {
-                uav_id = "UAV-?";
+                const mcast::TrackRecord &r = entry.second;
+                if (options_.has_region &&
+                    (r.lat < region.min_lat() || r.lat > region.max_lat() || r.lon < region.min_lon() ||
+                     r.lon > region.max_lon()))
+                    continue;
+                fusion::FusedTrack *t = resp->add_tracks();
+                t->set_track_id(r.track_id);
+                t->set_external_id(mcast::GetExternalId(r));
+                t->mutable_position()->set_lat(r.lat);
+                t->mutable_position()->set_lon(r.lon);
+                t->mutable_position()->set_alt(r.alt);
+                t->set_confidence(r.confidence);
+                t->set_measurement_ts(r.measurement_ts);
+                t->mutable_covariance()->set_north_north(r.var_north);
+                t->mutable_covariance()->set_north_east(r.cov_north_east);
+                t->mutable_covariance()->set_east_east(r.var_east);
+                if (r.flags & mcast::HAS_ERROR)
+                    t->set_uav_error_m(r.uav_error_m);
             }
-            std::cout << "  " << std::left << std::setw(12) << (uav_id + std::string(" (reported)"))
-                      << std::setw(12) << std::fixed << std::setprecision(5) << t.uav_reported().lat()
-                      << std::setw(12) << t.uav_reported().lon()
-                      << std::setw(14) << t.uav_reported().alt()
-                      << std::setw(10) << "-" << std::setw(18) << "\n";
         }
+        last_build = now;
+
+        std::lock_guard<std::mutex> lock(picture_mtx_);
+        if (resp)
+        {
+            picture_ = std::move(resp);
+            ++picture_seq_;
+        }
+        status_ = status;
     }
-    std::cout << "=============================================================" << std::endl;
 }
 
-void MonitorCLI::Run()
+size_t MonitorCLI::PageRows() const
+{
+    return (size_t)std::max(screen_.rows() - HEADER_ROWS - FOOTER_ROWS, 1);
+}
+
+void MonitorCLI::BuildView()
 {
-    while (true)
+    view_.clear();
+    sources_.clear();
+    if (!shown_)
+        return;
+
+    view_.reserve(shown_->tracks_size());
+    for (const auto &t : shown_->tracks())
     {
-        fusion::MonitorRequest req;
-        grpc::ClientContext ctx;
+        for (const auto &s : t.source_sensors())
+            sources_.insert(s);
+        if (options_.source.empty() || HasSource(t, options_.source))
+            view_.push_back(&t);
+    }
 
-        std::unique_ptr<grpc::ClientReader<fusion::MonitorResponse>> reader(
-            stub_->SubscribeFusedTracks(&ctx, req));
+    size_t rows = PageRows();
+    size_t pages = std::max<size_t>((view_.size() + rows - 1) / rows, 1);
+    page_ = std::min(page_, pages - 1);
 
-        fusion::MonitorResponse resp;
-        std::vector<fusion::FusedTrack> tracks;
-        while (reader->Read(&resp))
+    // Only the rows up to the end of this page need to be in order.
+    SortKey key = options_.sort;
+    bool desc = options_.descending;
+    auto less = [key, desc](const fusion::FusedTrack *a, const fusion::FusedTrack *b)
+    {
+        double va = 0.0, vb = 0.0;
+        if (key == SortKey::ERROR)
         {
-            for (const auto &t : resp.tracks())
-                tracks.push_back(t);
+            va = a->uav_error_m();
+            vb = b->uav_error_m();
         }
+        else if (key == SortKey::CONFIDENCE)
+        {
+            va = a->confidence();
+            vb = b->confidence();
+        }
+        if (va != vb)
+            return desc ? va > vb : va < vb;
+        return desc ? a->track_id() > b->track_id() : a->track_id() < b->track_id();
+    };
+    size_t end = std::min(view_.size(), (page_ + 1) * rows);
+    std::partial_sort(view_.begin(), view_.begin() + end, view_.end(), less);
+}
 
-        grpc::Status status = reader->Finish();
+std::vector<std::string> MonitorCLI::Frame() const
+{
+    std::vector<std::string> lines;
+    size_t rows = PageRows();
+    size_t pages = std::max<size_t>((view_.size() + rows - 1) / rows, 1);
+    size_t total = shown_ ? (size_t)shown_->tracks_size() : 0;
+    char buf[512];
+
+    std::string title = std::string(options_.smoothed ? "SMOOTHED" : "FUSED") + " TRACK MONITOR  " + addr_ +
+                        "  |  " + std::to_string(view_.size()) + "/" +
+                        std::to_string(total) + " tracks  |  sort " + SortName(options_.sort) +
+                        (options_.descending ? " desc" : " asc") + "  |  source " +
+                        (options_.source.empty() ? std::string("all") : options_.source);
+    if (options_.has_region)
+    {
+        const fusion::GeoRegion &r = options_.region;
+        std::snprintf(buf, sizeof(buf), "  |  region %.3f,%.3f..%.3f,%.3f", r.min_lat(), r.min_lon(), r.max_lat(),
+                      r.max_lon());
+        title += buf;
+    }
+    title += "  |  page " + std::to_string(page_ + 1) + "/" + std::to_string(pages);
+    lines.push_back(title);
+
+    std::snprintf(buf, sizeof(buf), "%-10s %-18s %11s %11s %9s %6s %9s  %s", "TRACK ID", "EXTERNAL ID", "LAT", "LON",
+                  "ALT(m)", "CONF", "ERR(m)", "SOURCES");
+    lines.push_back(buf);
+    lines.push_back(std::string((size_t)screen_.cols(), '-'));
+
+    size_t begin = std::min(view_.size(), page_ * rows);
+    size_t end = std::min(view_.size(), begin + rows);
+    std::string sources;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const fusion::FusedTrack &t = *view_[i];
+        sources.clear();
+        for (int s = 0; s < t.source_sensors_size(); ++s)
+        {
+            if (s)
+                sources += ",";
+            sources += t.source_sensors(s);
+        }
+        std::snprintf(buf, sizeof(buf), "%-10u %-18.18s %11.5f %11.5f %9.1f %6.3f %9.1f  %s", t.track_id(),
+                      t.external_id().c_str(), t.position().lat(), t.position().lon(), t.position().alt(),
+                      t.confidence(), t.uav_error_m(), sources.c_str());
+        lines.push_back(buf);
+    }
 
-        ClearScreen();
+    lines.resize((size_t)std::max(screen_.rows() - FOOTER_ROWS, 0));
+    lines.push_back("[n/p] page  [g/G] first/last  [s] sort  [r] reverse  [f] source  [q] quit" +
+                    (status_.empty() ? std::string() : "  |  " + status_));
+    return lines;
+}
+
+bool MonitorCLI::HandleKey(int key)
+{
+    size_t rows = PageRows();
+    size_t pages = std::max<size_t>((view_.size() + rows - 1) / rows, 1);
+    switch (key)
+    {
+    case 'q':
+    case 'Q':
+        return false;
+    case 'n':
+    case ' ':
+    case TerminalScreen::KEY_PAGE_DOWN:
+    case TerminalScreen::KEY_DOWN:
+        page_ = std::min(page_ + 1, pages - 1);
+        break;
+    case 'p':
+    case TerminalScreen::KEY_PAGE_UP:
+    case TerminalScreen::KEY_UP:
+        page_ = page_ > 0 ? page_ - 1 : 0;
+        break;
+    case 'g':
+    case TerminalScreen::KEY_HOME:
+        page_ = 0;
+        break;
+    case 'G':
+    case TerminalScreen::KEY_END:
+        page_ = pages - 1;
+        break;
+    case 's':
+        options_.sort = options_.sort == SortKey::ID      ? SortKey::ERROR
+                        : options_.sort == SortKey::ERROR ? SortKey::CONFIDENCE
+                                                          : SortKey::ID;
+        page_ = 0;
+        break;
+    case 'r':
+        options_.descending = !options_.descending;
+        page_ = 0;
+        break;
+    case 'f':
+    {
+        // All sources, then each source seen in the picture in turn
+        auto it = options_.source.empty() ? sources_.begin() : sources_.upper_bound(options_.source);
+        options_.source = it == sources_.end() ? std::string() : *it;
+        page_ = 0;
+        break;
+    }
+    default:
+        break;
+    }
+    return true;
+}
 
-        if (!status.ok())
+void MonitorCLI::Run()
+{
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    uint64_t seen_seq = 0;
+    std::string seen_status;
+    bool dirty = true;
+    while (!g_stop)
+    {
+        int key = screen_.ReadKey(options_.refresh_ms);
+        if (key != TerminalScreen::KEY_NONE)
         {
-            std::cout << "[MonitorCLI] Fusion service unreachable: "
-                      << status.error_message() << std::endl;
+            if (!HandleKey(key))
+                break;
+            dirty = true;
         }
-        else
+        if (screen_.UpdateSize())
+            dirty = true;
         {
-            PrintTable(tracks);
+            std::lock_guard<std::mutex> lock(picture_mtx_);
+            if (picture_seq_ != seen_seq)
+            {
+                seen_seq = picture_seq_;
+                shown_ = picture_;
+                dirty = true;
+            }
+            if (status_ != seen_status)
+            {
+                seen_status = status_;
+                dirty = true;
+            }
         }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(800));
+        if (!dirty)
+            continue;
+        BuildView();
+        screen_.Draw(Frame());
+        dirty = false;
     }
 }
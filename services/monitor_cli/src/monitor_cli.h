@@ -2,18 +2,78 @@
 
 #include <grpcpp/grpcpp.h>
 #include "fusion/fusion.grpc.pb.h"
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "terminal_screen.h"
+
+// Track table for a live fusion picture.
+//
+// A background thread keeps one continuous SubscribeFusedTracks stream open
+// (reconnecting when it drops) and holds on to the newest picture only. The
+// UI thread filters and sorts it client-side, formats just the visible page
+// and hands it to TerminalScreen, which rewrites only the changed cells, so
+// the cost per refresh is one pass over the tracks plus one page of output.
+// With a multicast group set, the picture comes from the fusion UDP
+// multicast output instead (no server connection, no source sensors).
 class MonitorCLI {
 public:
-    explicit MonitorCLI(const std::string& fusion_addr);
+    enum class SortKey { ID, ERROR, CONFIDENCE };
+
+    struct Options {
+        SortKey sort = SortKey::ID;
+        bool descending = false;
+        std::string source;           // Only tracks fed by this sensor; empty = all
+        bool has_region = false;
+        fusion::GeoRegion region;     // Filtered server-side through the spatial index
+        int refresh_ms = 250;
+        bool smoothed = false;        // Fixed-lag smoothed picture instead of the filtered one
+        std::string multicast_group;  // Read the picture from this group instead of gRPC
+        int multicast_port = 6020;
+    };
 
+    MonitorCLI(const std::string& fusion_addr, const Options& options);
+    ~MonitorCLI();
+
+    // Runs until 'q' or SIGINT/SIGTERM.
     void Run();
 
 private:
+    void SubscribeLoop();
+    // Keeps the picture from the fusion multicast output instead; the
+    // region filter is applied here, client-side.
+    void MulticastLoop();
+
+    // Filters the current picture into view_, sorting the rows up to the
+    // end of the current page.
+    void BuildView();
+    std::vector<std::string> Frame() const;
+    bool HandleKey(int key);
+    size_t PageRows() const;
+
+    std::string addr_;
+    Options options_;
     std::unique_ptr<fusion::FusionMonitor::Stub> stub_;
 
-    void ClearScreen();
-    void PrintTable(const std::vector<fusion::FusedTrack>& tracks);
+    // Shared with the subscription thread
+    std::mutex picture_mtx_;
+    std::shared_ptr<const fusion::MonitorResponse> picture_;
+    uint64_t picture_seq_ = 0;
+    std::string status_;
+    grpc::ClientContext* active_ctx_ = nullptr;
+    std::atomic<bool> running_{true};
+    std::thread subscriber_;
+
+    // UI thread only
+    TerminalScreen screen_;
+    std::shared_ptr<const fusion::MonitorResponse> shown_;
+    std::vector<const fusion::FusedTrack*> view_;
+    std::set<std::string> sources_;   // Seen in the current picture, for 'f'
+    size_t page_ = 0;
 };
@@ -0,0 +1,160 @@
+#include "terminal_screen.h"
+
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    void WriteAll(const std::string &s)
+    {
+        size_t done = 0;
+        while (done < s.size())
+        {
+            ssize_t n = ::write(STDOUT_FILENO, s.data() + done, s.size() - done);
+            if (n <= 0)
+                return;
+            done += (size_t)n;
+        }
+    }
+}
+
+TerminalScreen::TerminalScreen() : tty_(::isatty(STDOUT_FILENO) && ::isatty(STDIN_FILENO))
+{
+    if (!tty_)
+        return;
+    if (::tcgetattr(STDIN_FILENO, &saved_) == 0)
+    {
+        struct termios raw = saved_;
+        raw.c_lflag &= ~(ICANON | ECHO); // Signals (Ctrl-C) still work
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        raw_ = ::tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+    // Alternate screen, hidden cursor
+    WriteAll("\033[?1049h\033[?25l");
+    UpdateSize();
+}
+
+TerminalScreen::~TerminalScreen()
+{
+    if (!tty_)
+        return;
+    WriteAll("\033[?25h\033[?1049l");
+    if (raw_)
+        ::tcsetattr(STDIN_FILENO, TCSANOW, &saved_);
+}
+
+bool TerminalScreen::UpdateSize()
+{
+    if (!tty_)
+        return false;
+    struct winsize ws;
+    if (::ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_row == 0 || ws.ws_col == 0)
+        return false;
+    if (ws.ws_row == rows_ && ws.ws_col == cols_)
+        return false;
+    rows_ = ws.ws_row;
+    cols_ = ws.ws_col;
+    full_redraw_ = true;
+    return true;
+}
+
+void TerminalScreen::Draw(const std::vector<std::string> &lines)
+{
+    if (!tty_)
+    {
+        // Plain text, only when the frame changed
+        std::vector<std::string> frame(lines.begin(), lines.begin() + std::min(lines.size(), (size_t)rows_));
+        if (frame == shown_)
+            return;
+        shown_ = std::move(frame);
+        out_.clear();
+        for (const std::string &line : shown_)
+            out_ += line + "\n";
+        out_ += "\n";
+        WriteAll(out_);
+        return;
+    }
+
+    out_.clear();
+    if (full_redraw_)
+    {
+        out_ += "\033[2J";
+        shown_.assign(rows_, std::string(cols_, ' '));
+    }
+
+    std::string row;
+    char move[48];
+    for (int r = 0; r < rows_; ++r)
+    {
+        row.assign(r < (int)lines.size() ? lines[r] : std::string());
+        row.resize(cols_, ' ');
+        std::string &old = shown_[r];
+        if (!full_redraw_ && row == old)
+            continue;
+
+        size_t first = 0, last = (size_t)cols_;
+        if (!full_redraw_)
+        {
+            while (row[first] == old[first])
+                ++first;
+            while (row[last - 1] == old[last - 1])
+                --last;
+        }
+        // The last cell of the bottom row would scroll some terminals.
+        if (r == rows_ - 1 && last == (size_t)cols_)
+            --last;
+        if (first < last)
+        {
+            std::snprintf(move, sizeof(move), "\033[%d;%zuH", r + 1, first + 1);
+            out_ += move;
+            out_.append(row, first, last - first);
+        }
+        old.swap(row);
+    }
+    full_redraw_ = false;
+    if (!out_.empty())
+        WriteAll(out_);
+}
+
+int TerminalScreen::ReadKey(int timeout_ms)
+{
+    if (!tty_)
+    {
+        ::usleep((useconds_t)timeout_ms * 1000);
+        return KEY_NONE;
+    }
+    struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+    if (::poll(&pfd, 1, timeout_ms) <= 0)
+        return KEY_NONE;
+
+    unsigned char buf[8];
+    ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+    if (n <= 0)
+        return KEY_NONE;
+    if (buf[0] != 0x1b || n < 3 || (buf[1] != '[' && buf[1] != 'O'))
+        return buf[0];
+
+    // CSI sequences for the navigation keys
+    switch (buf[2])
+    {
+    case 'A':
+        return KEY_UP;
+    case 'B':
+        return KEY_DOWN;
+    case 'H':
+        return KEY_HOME;
+    case 'F':
+        return KEY_END;
+    case '5':
+        return KEY_PAGE_UP;
+    case '6':
+        return KEY_PAGE_DOWN;
+    default:
+        return KEY_NONE;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <termios.h>
+
+// Full-screen terminal output that only rewrites what changed.
+//
+// The screen keeps the frame it last drew. Each Draw compares the new frame
+// row by row and emits, for every row that differs, one cursor move plus the
+// span from its first to its last changed column; unchanged rows cost
+// nothing. A resize (or the first frame) clears and redraws everything.
+//
+// While it exists on a terminal, stdin is in non-canonical, no-echo mode and
+// the alternate screen is active; both are restored by the destructor. When
+// stdout is not a terminal every changed frame is printed as plain text.
+class TerminalScreen {
+public:
+    enum Key {
+        KEY_NONE = -1,
+        KEY_PAGE_UP = 0x100,
+        KEY_PAGE_DOWN,
+        KEY_UP,
+        KEY_DOWN,
+        KEY_HOME,
+        KEY_END,
+    };
+
+    TerminalScreen();
+    ~TerminalScreen();
+
+    TerminalScreen(const TerminalScreen&) = delete;
+    TerminalScreen& operator=(const TerminalScreen&) = delete;
+
+    // Re-reads the terminal size. True when it changed since the last call.
+    bool UpdateSize();
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+    // Draws one line per screen row (missing rows are blank, long lines are
+    // cut at the screen width).
+    void Draw(const std::vector<std::string>& lines);
+
+    // Waits up to timeout_ms for a key press: a character, a Key, or
+    // KEY_NONE on timeout or signal.
+    int ReadKey(int timeout_ms);
+
+private:
+    bool tty_;
+    bool raw_ = false;
+    struct termios saved_;
+    int rows_ = 24;
+    int cols_ = 100;
+    std::vector<std::string> shown_; // Last frame, each row exactly cols_ wide
+    bool full_redraw_ = true;
+    std::string out_;                // Scratch escape-sequence buffer
+};
@@ -7,10 +7,10 @@
 #include <fstream>
 #include <iomanip>
 #include <string>
+#include <vector>
 
 #include "config.h"
-#include "geo_utils.h"
-#include "physics.h"
+#include "sensor_models.h"
 
 int main()
 {
@@ -25,31 +25,60 @@ int main()
     std::string radar_id = env_id ? env_id : "RADAR-X";
 
     // Get env variables
-    double radar_lat = utils::GetEnvDouble("RADAR_LAT", 39.9);
-    double radar_lon = utils::GetEnvDouble("RADAR_LON", 32.8);
-    double radar_sensitivity = utils::GetEnvDouble("RADAR_SENSITIVITY", 1e-12);
-    double range_sigma_val = utils::GetEnvDouble("RADAR_RANGE_SIGMA", 30.0);
-    double bearing_sigma_val = utils::GetEnvDouble("RADAR_BEARING_SIGMA", 1.0);
+    models::RadarConfig radar;
+    radar.id = radar_id;
+    radar.lat = utils::GetEnvDouble("RADAR_LAT", 39.9);
+    radar.lon = utils::GetEnvDouble("RADAR_LON", 32.8);
+    radar.alt = utils::GetEnvDouble("RADAR_ALT", 0.0);
+    radar.sensitivity = utils::GetEnvDouble("RADAR_SENSITIVITY", 1e-12);
+    radar.range_sigma = utils::GetEnvDouble("RADAR_RANGE_SIGMA", 30.0);
+    radar.bearing_sigma = utils::GetEnvDouble("RADAR_BEARING_SIGMA", 1.0);
+    radar.dynamic_rcs = enable_dynamic_rcs;
     double sim_duration = utils::GetEnvDouble("SIM_DURATION_SEC", 0.0);
 
     // --- Advanced Radar Parameters ---
-    double radar_carrier_freq_hz = utils::GetEnvDouble("RADAR_CARRIER_FREQ_HZ", 3e9); // S-band
-    double rain_rate_mmh = utils::GetEnvDouble("RAIN_RATE_MMH", 0.0);                 // mm/h
-    double radar_frequency_ghz = radar_carrier_freq_hz / 1e9;                         // Convert to GHz
+    radar.carrier_freq_hz = utils::GetEnvDouble("RADAR_CARRIER_FREQ_HZ", 3e9); // S-band
+    radar.rain_rate_mmh = utils::GetEnvDouble("RAIN_RATE_MMH", 0.0);           // mm/h
+    radar.doppler_sigma_hz = utils::GetEnvDouble("RADAR_DOPPLER_SIGMA_HZ", 20.0); // 0 disables range rate
+    radar.clutter_rate = utils::GetEnvDouble("RADAR_CLUTTER_RATE", 0.0);            // False alarms per scan
+    radar.clutter_range_m = utils::GetEnvDouble("RADAR_CLUTTER_RANGE_KM", 0.0) * 1000.0;
 
     // --- Init ---
-    auto channel = grpc::CreateChannel(fusion_target, grpc::InsecureChannelCredentials());
-    RadarClient client(channel);
+    models::RadarModel model(radar);
+    auto channel = transport::CreateChannel(fusion_target, transport::LoadTransportConfig(radar_id));
+    RadarClient client(channel, radar_id);
 
     const char *env_truth = std::getenv("SHARED_TRUTH_PATH");
     std::string truth_path = env_truth ? env_truth : "/workspace/shared/ground_truth.txt";
 
     std::mt19937 gen(std::random_device{}());
-    std::normal_distribution<> range_noise(0.0, range_sigma_val);
-    std::normal_distribution<> bearing_noise(0.0, bearing_sigma_val);
 
     std::cout << "[" << radar_id << "] Booted. RCS_MODEL=" << (enable_dynamic_rcs ? "ON" : "OFF")
-              << " | SENSITIVITY=" << radar_sensitivity << std::endl;
+              << " | SENSITIVITY=" << radar.sensitivity << " | CLUTTER=" << radar.clutter_rate << "/scan" << std::endl;
+
+    // False alarms carry no track id; fusion has to tell them from the target.
+    auto to_message = [&](const models::RadarDetection &det, const std::string &track_id, double alt)
+    {
+        sensors::RadarDetection msg;
+        auto now = std::chrono::system_clock::now().time_since_epoch();
+        msg.mutable_header()->set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+        msg.mutable_header()->set_timestamp_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                   std::chrono::steady_clock::now().time_since_epoch()).count());
+        msg.mutable_header()->set_sensor_id(radar_id);
+        msg.set_track_id(track_id);
+        msg.set_range(det.range);
+        msg.set_bearing(det.bearing);
+        msg.set_radar_lat(det.lat);
+        msg.set_radar_lon(det.lon);
+        msg.set_radar_alt(alt);
+        msg.set_rcs(det.rcs);
+        msg.set_velocity(det.range_rate);
+        msg.set_velocity_sigma(model.range_rate_sigma());
+        msg.set_range_sigma(radar.range_sigma);
+        msg.set_bearing_sigma(radar.bearing_sigma);
+        return msg;
+    };
+    std::vector<models::RadarDetection> clutter;
 
     auto start_time = std::chrono::steady_clock::now();
 
@@ -72,58 +101,16 @@ int main()
 
         if (ifs >> gt_lat >> gt_lon >> gt_alt >> gt_ts >> gt_heading)
         {
-            double true_rng = geo_utils::CalculateHaversine(radar_lat, radar_lon, gt_lat, gt_lon);
-            double rcs_to_use = 2.0;
-
-            if (enable_dynamic_rcs)
-            {
-                rcs_to_use = physics::CalculateAspectRCS(gt_lat, gt_lon, gt_heading, radar_lat, radar_lon);
-            }
-
-            // === ADVANCED PHYSICS CALCULATIONS ===
-
-            // 1. Rain attenuation (two-way path loss from weather)
-            double rain_atten_db = physics::CalculateRainAttenuation(radar_frequency_ghz,
-                                                                     true_rng / 1000.0, rain_rate_mmh);
-            double weather_factor = std::pow(10.0, -rain_atten_db / 10.0);
-
-            // Bearing
-            double bearing_to_uav = geo_utils::BearingDegrees(radar_lat, radar_lon, gt_lat, gt_lon);
-
-            // Composite signal strength with all physical effects
-            // Signal = (RCS * antenna_gain) / range^4 * weather_attenuation
-            double signal_strength = physics::CalculateSignalStrength(rcs_to_use, true_rng) * weather_factor;
-
-            if (signal_strength > radar_sensitivity)
+            // Velocity columns are optional (older truth writers); without
+            // them the radar sees a hovering target.
+            double gt_v_north = 0.0, gt_v_east = 0.0;
+            if (!(ifs >> gt_v_north >> gt_v_east))
+                gt_v_north = gt_v_east = 0.0;
+
+            models::RadarDetection det;
+            if (model.Detect({gt_lat, gt_lon, gt_alt, gt_heading, gt_v_north, gt_v_east}, gen, det))
             {
-                double noisy_rng = true_rng + range_noise(gen);
-                double noisy_brg = bearing_to_uav + bearing_noise(gen);
-
-                // Compute target GPS from radar origin, range and bearing using polar-to-geo conversion
-                // (Similar to PolarToGeo but returning simple pair instead of protobuf)
-                const double R_EARTH = 6371000.0;
-                double ad = noisy_rng / R_EARTH;
-                double brng = noisy_brg * M_PI / 180.0;
-                double phi1 = radar_lat * M_PI / 180.0;
-                double lam1 = radar_lon * M_PI / 180.0;
-                double phi2 = std::asin(std::sin(phi1) * std::cos(ad) + std::cos(phi1) * std::sin(ad) * std::cos(brng));
-                double lam2 = lam1 + std::atan2(std::sin(brng) * std::sin(ad) * std::cos(phi1), std::cos(ad) - std::sin(phi1) * std::sin(phi2));
-                double target_lat = phi2 * 180.0 / M_PI;
-                double target_lon = lam2 * 180.0 / M_PI;
-
-                sensors::RadarDetection msg;
-                auto now = std::chrono::system_clock::now().time_since_epoch();
-                msg.mutable_header()->set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
-                msg.mutable_header()->set_sensor_id(radar_id);
-                msg.set_track_id("UAV-ALFA");
-                msg.set_range(noisy_rng);
-                msg.set_bearing(noisy_brg);
-                msg.set_radar_lat(target_lat);
-                msg.set_radar_lon(target_lon);
-                msg.set_radar_alt(gt_alt);
-                msg.set_rcs(rcs_to_use);
-
-                client.sendDetection(msg);
+                client.sendDetection(to_message(det, "UAV-ALFA", gt_alt));
             }
             else
             {
@@ -134,6 +121,12 @@ int main()
             }
         }
         ifs.close();
+
+        clutter.clear();
+        model.Clutter(gen, clutter);
+        for (const auto &fa : clutter)
+            client.sendDetection(to_message(fa, "", radar.alt));
+
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     return 0;
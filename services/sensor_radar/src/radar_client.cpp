@@ -1,39 +1,60 @@
 #include "radar_client.h"
 #include <iostream>
 
-RadarClient::RadarClient(std::shared_ptr<grpc::Channel> channel)
+RadarClient::RadarClient(std::shared_ptr<grpc::Channel> channel, const std::string &radar_id)
 {
+    transport::TransportConfig config = transport::LoadTransportConfig(radar_id);
     stub_ = fusion::FusionService::NewStub(channel);
-    writer_ = stub_->StreamRadar(&context_, &ack_);
+    transport_ = std::make_unique<transport::StreamTransport<sensors::RadarDetection, fusion::FusionAck>>(
+        radar_id, channel,
+        [this](grpc::ClientContext *context, fusion::FusionAck *ack)
+        { return stub_->StreamRadar(context, ack); },
+        config);
+    if (config.shared_memory)
+        shm_ = shm::Producer::Create(shm::SegmentDir(), radar_id, config.shm_records);
 }
 
 RadarClient::~RadarClient()
 {
-    if (writer_)
-    {
-        writer_->WritesDone();
-        grpc::Status status = writer_->Finish();
+    grpc::Status status = transport_->Close();
 
-        if (!status.ok())
-        {
-            std::cerr << "[RADAR] Stream closed with error: "
-                      << status.error_message() << std::endl;
-        }
+    if (!status.ok())
+    {
+        std::cerr << "[RADAR] Stream closed with error: "
+                  << status.error_message() << std::endl;
     }
 }
 
 bool RadarClient::sendDetection(const sensors::RadarDetection &msg)
 {
-    if (!writer_)
+    if (shm_ && shm_->ConsumerAlive())
     {
-        std::cerr << "[RADAR] Writer not initialized!" << std::endl;
-        return false;
+        if (shm::MeasurementRecord *r = shm_->Claim())
+        {
+            r->timestamp_ms = msg.header().timestamp();
+            r->timestamp_ns = msg.header().timestamp_ns();
+            r->kind = shm::RecordKind::RADAR;
+            r->lat = msg.radar_lat();
+            r->lon = msg.radar_lon();
+            r->alt = msg.radar_alt();
+            r->range = msg.range();
+            r->bearing = msg.bearing();
+            r->elevation = msg.elevation();
+            r->rcs = msg.rcs();
+            r->velocity = msg.velocity();
+            r->velocity_sigma = (float)msg.velocity_sigma();
+            r->range_sigma = (float)msg.range_sigma();
+            r->bearing_sigma = (float)msg.bearing_sigma();
+            r->speed = r->heading = 0.0;
+            shm::SetId(r->sensor_id, msg.header().sensor_id());
+            shm::SetId(r->target_id, msg.track_id());
+            shm_->Commit();
+            return true;
+        }
+        // Ring full: fusion is behind, let gRPC spool take the overflow.
     }
 
-    if (!writer_->Write(msg))
-    {
-        std::cerr << "[RADAR] Stream write failed!" << std::endl;
-        return false;
-    }
-    return true;
-}
\ No newline at end of file
+    // Only fails when the spool overflowed (logged by the transport);
+    // a lost stream is retried in the background.
+    return transport_->Send(msg);
+}
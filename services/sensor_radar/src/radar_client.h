@@ -1,20 +1,25 @@
 #pragma once
 #include "fusion/fusion.grpc.pb.h"
 #include "sensors/radar.pb.h"
+#include "sensor_transport.h"
+#include "shm_ring.h"
 #include <grpcpp/grpcpp.h>
 #include <memory>
+#include <string>
 
 class RadarClient
 {
 public:
-    explicit RadarClient(std::shared_ptr<grpc::Channel> channel);
+    RadarClient(std::shared_ptr<grpc::Channel> channel, const std::string &radar_id);
     ~RadarClient();
 
+    // Writes the detection to the shared-memory ring while fusion reads it
+    // (SENSOR_TRANSPORT=shm); otherwise spools it for the gRPC stream, whose
+    // delivery and reconnects happen in the background.
     bool sendDetection(const sensors::RadarDetection &msg);
 
 private:
+    std::unique_ptr<shm::Producer> shm_;
     std::unique_ptr<fusion::FusionService::Stub> stub_;
-    std::unique_ptr<grpc::ClientWriter<sensors::RadarDetection>> writer_;
-    grpc::ClientContext context_;
-    fusion::FusionAck ack_;
-};
\ No newline at end of file
+    std::unique_ptr<transport::StreamTransport<sensors::RadarDetection, fusion::FusionAck>> transport_;
+};
@@ -11,7 +11,7 @@ int main()
 
     const char *env_addr = std::getenv("FUSION_ADDR");
     std::string fusion_target = env_addr ? env_addr : std::string("fusion_service:6000");
-    auto channel = grpc::CreateChannel(fusion_target, grpc::InsecureChannelCredentials());
+    auto channel = transport::CreateChannel(fusion_target, transport::LoadTransportConfig("sigint"));
     SigintClient client(channel);
 
     double current_power = -40.0;
@@ -39,6 +39,8 @@ int main()
         auto now = std::chrono::system_clock::now().time_since_epoch();
         msg.mutable_header()->set_timestamp(
             std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+        msg.mutable_header()->set_timestamp_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                   std::chrono::steady_clock::now().time_since_epoch()).count());
         msg.mutable_header()->set_sensor_id("SIGINT-01");
 
         // Payload: try reading ground truth to correlate signal
@@ -63,14 +65,8 @@ int main()
         msg.set_confidence(current_confidence);
         msg.set_bearing(bearing_val);
 
-        if (!client.sendHit(msg))
-        {
-            std::cerr << "[SIGINT] Failed to send. Retrying in 5s..." << std::endl;
-            // Wait for 5 seconds
-            std::this_thread::sleep_for(std::chrono::seconds(5));
-            // A reconnect logic would go here in a real scenario
-            break;
-        }
+        // Spooled and retried in the background while the fusion service is down
+        client.sendHit(msg);
 
         std::cout << "[SIGINT] Sent packet #" << ++packet_count
                   << " | Freq: " << msg.frequency()
@@ -2,6 +2,7 @@
 
 #include "fusion/fusion.grpc.pb.h"
 #include "sensors/sigint.pb.h"
+#include "sensor_transport.h"
 #include <grpcpp/grpcpp.h>
 #include <memory>
 
@@ -10,11 +11,11 @@ class SigintClient
 public:
     explicit SigintClient(std::shared_ptr<grpc::Channel> channel);
     ~SigintClient();
+
+    // Spools the hit; delivery and reconnects happen in the background.
     bool sendHit(const sensors::SigintHit &msg);
 
 private:
     std::unique_ptr<fusion::FusionService::Stub> stub_;
-    std::unique_ptr<grpc::ClientWriter<sensors::SigintHit>> writer_;
-    grpc::ClientContext context_;
-    fusion::FusionAck ack_;
+    std::unique_ptr<transport::StreamTransport<sensors::SigintHit, fusion::FusionAck>> transport_;
 };
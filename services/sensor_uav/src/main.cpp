@@ -1,4 +1,5 @@
 #include "uav_client.h"
+#include "sensor_models.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -27,20 +28,20 @@ int main()
 {
     const char *env_addr = std::getenv("FUSION_ADDR");
     std::string fusion_target = env_addr ? env_addr : std::string("fusion_service:6000");
-    auto channel = grpc::CreateChannel(fusion_target, grpc::InsecureChannelCredentials());
+    auto channel = transport::CreateChannel(fusion_target, transport::LoadTransportConfig("uav"));
     UAVClient client(channel);
 
     // Parameters from docker compose or defaults
-    double current_lat = get_env_double("UAV_START_LAT", 39.920);
-    double current_lon = get_env_double("UAV_START_LON", 32.850);
-    double current_alt = get_env_double("UAV_START_ALT", 1200.0);
-    double current_heading = get_env_double("UAV_START_HEADING", 45.0);
-    double current_speed = get_env_double("UAV_SPEED", 80.0);
+    models::UavState uav;
+    uav.lat = get_env_double("UAV_START_LAT", 39.920);
+    uav.lon = get_env_double("UAV_START_LON", 32.850);
+    uav.alt = get_env_double("UAV_START_ALT", 1200.0);
+    uav.heading = get_env_double("UAV_START_HEADING", 45.0);
+    uav.speed = get_env_double("UAV_SPEED", 80.0);
 
     std::cout << "[UAV] Simulation started with settings:" << std::endl;
-    std::cout << "      Lat: " << current_lat << " Lon: " << current_lon << " Speed: " << current_speed << std::endl;
+    std::cout << "      Lat: " << uav.lat << " Lon: " << uav.lon << " Speed: " << uav.speed << std::endl;
 
-    double time_s = 0.0;
     const char *env_truth = std::getenv("SHARED_TRUTH_PATH");
     std::string truth_path = env_truth ? env_truth : std::string("/workspace/shared/ground_truth.txt");
 
@@ -59,7 +60,7 @@ int main()
 
     while (true)
     {
-        if (max_time > 0 && time_s >= max_time) {
+        if (max_time > 0 && uav.time_s >= max_time) {
             std::cout << "[UAV] Simulation time finished. Exiting." << std::endl;
             break; 
         }
@@ -70,27 +71,22 @@ int main()
         auto now = std::chrono::system_clock::now().time_since_epoch();
         msg.mutable_header()->set_timestamp(
             std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+        msg.mutable_header()->set_timestamp_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                   std::chrono::steady_clock::now().time_since_epoch()).count());
         msg.set_uav_id("UAV-ALFA");
 
-        // Movement simulation. Changes in the position based on simple functions.
-        current_lat += 0.0005;
-        current_lon += std::sin(time_s / 50.0) * 0.0002;
-        current_alt += std::cos(time_s / 10.0) * 5.0;
+        // Movement simulation (shared with the campaign runner).
+        models::StepUav(uav);
 
-        msg.mutable_position()->set_lat(current_lat);
-        msg.mutable_position()->set_lon(current_lon);
-        msg.mutable_position()->set_alt(current_alt);
-
-        current_heading += std::sin(time_s / 10.0) * 2.0;
-        msg.set_speed(current_speed);
-        msg.set_heading(current_heading);
+        msg.mutable_position()->set_lat(uav.lat);
+        msg.mutable_position()->set_lon(uav.lon);
+        msg.mutable_position()->set_alt(uav.alt);
+        msg.set_speed(uav.speed);
+        msg.set_heading(uav.heading);
         msg.set_status("Flying");
 
-        if (!client.sendTelemetry(msg))
-        {
-            std::cerr << "[UAV] Connection lost." << std::endl;
-            break;
-        }
+        // Spooled while the fusion service is unreachable
+        client.sendTelemetry(msg);
 
         // Ground Truth
         try
@@ -104,7 +100,9 @@ int main()
                     << msg.position().lon() << " "
                     << msg.position().alt() << " "
                     << msg.header().timestamp() << " "
-                    << msg.heading() << "\n";
+                    << msg.heading() << " "
+                    << uav.v_north << " "
+                    << uav.v_east << "\n";
                 ofs.close();
             }
         }
@@ -114,7 +112,6 @@ int main()
 
         // Send data at 1 Hz
         std::this_thread::sleep_for(std::chrono::seconds(1));
-        time_s += 1.0;
     }
     return 0;
 }
\ No newline at end of file
@@ -3,44 +3,59 @@
 
 UAVClient::UAVClient(std::shared_ptr<grpc::Channel> channel)
 {
+    transport::TransportConfig config = transport::LoadTransportConfig("uav");
     stub_ = fusion::FusionService::NewStub(channel);
-    writer_ = stub_->StreamUAV(&context_, &ack_);
+    transport_ = std::make_unique<transport::StreamTransport<sensors::UAVTelemetry, fusion::FusionAck>>(
+        "UAV", channel,
+        [this](grpc::ClientContext *context, fusion::FusionAck *ack)
+        { return stub_->StreamUAV(context, ack); },
+        config);
+    if (config.shared_memory)
+        shm_ = shm::Producer::Create(shm::SegmentDir(), "uav", config.shm_records);
 }
 
 UAVClient::~UAVClient()
 {
-    if (writer_)
-    {
-        writer_->WritesDone();
-
-        // Check server's final status
-        grpc::Status status = writer_->Finish();
+    // Flush what is still spooled, then check server's final status
+    grpc::Status status = transport_->Close();
 
-        if (status.ok())
-        {
-            std::cout << "[UAV] Stream closed successfully. Server ACK: "
-                      << ack_.message() << std::endl;
-        }
-        else
-        {
-            std::cerr << "[UAV] Stream closed with error: "
-                      << status.error_code() << ": " << status.error_message() << std::endl;
-        }
+    if (status.ok())
+    {
+        std::cout << "[UAV] Stream closed successfully. Server ACK: "
+                  << transport_->ack().message() << std::endl;
+    }
+    else
+    {
+        std::cerr << "[UAV] Stream closed with error: "
+                  << status.error_code() << ": " << status.error_message() << std::endl;
     }
 }
 
 bool UAVClient::sendTelemetry(const sensors::UAVTelemetry &msg)
 {
-    if (!writer_)
-    {
-        std::cerr << "[UAV] Writer not initialized!" << std::endl;
-        return false;
-    }
-    // If writing fails, the stream is likely broken
-    if (!writer_->Write(msg))
+    if (shm_ && shm_->ConsumerAlive())
     {
-        std::cerr << "[UAV] Stream write failed!" << std::endl;
-        return false;
+        if (shm::MeasurementRecord *r = shm_->Claim())
+        {
+            r->timestamp_ms = msg.header().timestamp();
+            r->timestamp_ns = msg.header().timestamp_ns();
+            r->kind = shm::RecordKind::UAV;
+            r->lat = msg.position().lat();
+            r->lon = msg.position().lon();
+            r->alt = msg.position().alt();
+            r->range = r->bearing = r->elevation = r->rcs = r->velocity = 0.0;
+            r->velocity_sigma = r->range_sigma = r->bearing_sigma = 0.0f;
+            r->speed = msg.speed();
+            r->heading = msg.heading();
+            shm::SetId(r->sensor_id, msg.header().sensor_id());
+            shm::SetId(r->target_id, msg.uav_id());
+            shm_->Commit();
+            return true;
+        }
+        // Ring full: fusion is behind, let gRPC spool take the overflow.
     }
-    return true;
-}
\ No newline at end of file
+
+    // Only fails when the spool overflowed (logged by the transport);
+    // a lost stream is retried in the background.
+    return transport_->Send(msg);
+}
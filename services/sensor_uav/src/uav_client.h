@@ -2,6 +2,8 @@
 
 #include "fusion/fusion.grpc.pb.h"
 #include "sensors/uav.pb.h"
+#include "sensor_transport.h"
+#include "shm_ring.h"
 #include <grpcpp/grpcpp.h>
 #include <memory>
 
@@ -11,11 +13,13 @@ public:
     explicit UAVClient(std::shared_ptr<grpc::Channel> channel);
     ~UAVClient();
 
+    // Writes to the shared-memory ring while fusion reads it
+    // (SENSOR_TRANSPORT=shm); otherwise spools the telemetry for the gRPC
+    // stream, whose delivery and reconnects happen in the background.
     bool sendTelemetry(const sensors::UAVTelemetry &msg);
 
 private:
+    std::unique_ptr<shm::Producer> shm_;
     std::unique_ptr<fusion::FusionService::Stub> stub_;
-    std::unique_ptr<grpc::ClientWriter<sensors::UAVTelemetry>> writer_;
-    grpc::ClientContext context_;
-    fusion::FusionAck ack_;
-};
\ No newline at end of file
+    std::unique_ptr<transport::StreamTransport<sensors::UAVTelemetry, fusion::FusionAck>> transport_;
+};
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "config.h"
+#include "scenario.h"
+#include "scheduler.h"
+#include "sensor_tasks.h"
+
+namespace
+{
+    uint64_t SplitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // Periodic progress line, in virtual time.
+    sim::Task ReportTask(sim::Scheduler& sched, const Outlet& out, sim::SimTime every)
+    {
+        auto wall_start = std::chrono::steady_clock::now();
+        while (true)
+        {
+            co_await sched.Sleep(every);
+            double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+            double virt = static_cast<double>(sched.Now()) / sim::SECONDS;
+            std::cout << "[SIM_HOST] t=" << std::fixed << std::setprecision(1) << virt << "s"
+                      << " radar=" << out.radar() << " uav=" << out.uav() << " sigint=" << out.sigint()
+                      << " dropped=" << out.dropped() << " events=" << sched.events()
+                      << " speed=" << std::setprecision(1) << (wall > 0.0 ? virt / wall : 0.0) << "x" << std::endl;
+        }
+    }
+}
+
+int main()
+{
+    // --- Environment Config ---
+    std::string scenario_path = utils::GetEnvString("SIM_HOST_SCENARIO", "");
+    std::string output = utils::GetEnvString("SIM_HOST_OUTPUT", "grpc");  // grpc | none
+    std::string fusion_target = utils::GetEnvString("FUSION_ADDR", "fusion_service:6000");
+    bool fast = utils::GetEnvString("SIM_HOST_PACE", "wall") == "fast";
+    double speed = utils::GetEnvDouble("SIM_HOST_SPEED", 1.0);
+    double duration = utils::GetEnvDouble("SIM_DURATION_SEC", 0.0);
+    double report_sec = utils::GetEnvDouble("SIM_HOST_REPORT_SEC", 10.0);
+    size_t grid_radars = static_cast<size_t>(utils::GetEnvDouble("SIM_HOST_RADARS", 0.0));
+    uint64_t seed = static_cast<uint64_t>(utils::GetEnvDouble("SIM_HOST_SEED", 0.0));
+
+    Scenario scenario = DefaultScenario();
+    if (!scenario_path.empty())
+    {
+        std::string error;
+        if (!LoadScenario(scenario_path, scenario, error))
+        {
+            std::cerr << "[SIM_HOST] Cannot load scenario " << scenario_path << ": " << error << std::endl;
+            return 1;
+        }
+    }
+    if (grid_radars > 0)
+    {
+        RadarSpec tmpl;
+        tmpl.radar.sensitivity = 1e-16;
+        tmpl.scan_period_s = 4.0;
+        AddRadarGrid(scenario, grid_radars, utils::GetEnvDouble("SIM_HOST_GRID_LAT", 39.9),
+                     utils::GetEnvDouble("SIM_HOST_GRID_LON", 32.8),
+                     utils::GetEnvDouble("SIM_HOST_GRID_SPACING_KM", 5.0), tmpl);
+    }
+    double rain = utils::GetEnvDouble("RAIN_RATE_MMH", 0.0);
+    for (auto& r : scenario.radars)
+        r.radar.rain_rate_mmh = std::max(r.radar.rain_rate_mmh, rain);
+    if (seed == 0)
+        seed = std::random_device{}();
+
+    // --- Init ---
+    World world;
+    world.epoch_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+    world.truth_path = utils::GetEnvString("SHARED_TRUTH_PATH", "");
+    for (const auto& u : scenario.uavs)
+    {
+        world.ids.push_back(u.id);
+        world.targets.push_back({u.state.lat, u.state.lon, u.state.alt, u.state.heading});
+    }
+
+    Outlet out(output == "none" ? std::string() : fusion_target);
+    sim::Scheduler sched;
+    for (size_t i = 0; i < scenario.uavs.size(); ++i)
+        sched.Spawn(UavTask(sched, world, i, scenario.uavs[i], out, SplitMix64(seed)));
+    for (const auto& r : scenario.radars)
+        sched.Spawn(RadarTask(sched, world, r, out, SplitMix64(seed)));
+    for (const auto& g : scenario.sigints)
+        sched.Spawn(SigintTask(sched, world, g, out, SplitMix64(seed)));
+    if (report_sec > 0.0)
+        sched.Spawn(ReportTask(sched, out, static_cast<sim::SimTime>(report_sec * sim::SECONDS)));
+
+    std::cout << "[SIM_HOST] Hosting " << scenario.uavs.size() << " UAVs, " << scenario.radars.size()
+              << " radars, " << scenario.sigints.size() << " SIGINT sensors | pace="
+              << (fast ? "fast" : "wall") << (fast ? "" : " x" + std::to_string(speed))
+              << " | output=" << (output == "none" ? "none" : fusion_target) << std::endl;
+
+    // --- Run ---
+    auto wall_start = std::chrono::steady_clock::now();
+    sim::SimTime until = duration > 0.0 ? static_cast<sim::SimTime>(duration * sim::SECONDS)
+                                        : std::numeric_limits<sim::SimTime>::max();
+    sched.Run(until, fast ? sim::Pacing::AsFastAsPossible : sim::Pacing::WallClock, speed);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    std::cout << "[SIM_HOST] Done: " << static_cast<double>(sched.Now()) / sim::SECONDS << " s simulated in "
+              << wall << " s | radar=" << out.radar() << " uav=" << out.uav() << " sigint=" << out.sigint()
+              << " | " << sched.events() << " events (" << static_cast<uint64_t>(sched.events() / std::max(wall, 1e-9))
+              << "/s)" << std::endl;
+    return 0;
+}
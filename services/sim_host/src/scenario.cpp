@@ -0,0 +1,162 @@
+#include "scenario.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+
+    void ReadLatency(const YAML::Node& node, LatencyModel& l)
+    {
+        if (!node)
+            return;
+        l.mean_ms = node["mean_ms"].as<double>(l.mean_ms);
+        l.jitter_ms = node["jitter_ms"].as<double>(l.jitter_ms);
+    }
+
+    void ReadRadar(const YAML::Node& node, RadarSpec& r)
+    {
+        models::RadarConfig& c = r.radar;
+        c.id = node["id"].as<std::string>(c.id);
+        c.lat = node["lat"].as<double>(c.lat);
+        c.lon = node["lon"].as<double>(c.lon);
+        c.alt = node["alt"].as<double>(c.alt);
+        c.sensitivity = node["sensitivity"].as<double>(c.sensitivity);
+        c.range_sigma = node["range_sigma"].as<double>(c.range_sigma);
+        c.bearing_sigma = node["bearing_sigma"].as<double>(c.bearing_sigma);
+        c.carrier_freq_hz = node["freq_ghz"].as<double>(c.carrier_freq_hz / 1e9) * 1e9;
+        c.rain_rate_mmh = node["rain_rate_mmh"].as<double>(c.rain_rate_mmh);
+        c.doppler_sigma_hz = node["doppler_sigma_hz"].as<double>(c.doppler_sigma_hz);
+        c.clutter_rate = node["clutter_rate"].as<double>(c.clutter_rate);
+        c.clutter_range_m = node["clutter_range_km"].as<double>(c.clutter_range_m / 1000.0) * 1000.0;
+        c.dynamic_rcs = node["rcs"].as<bool>(c.dynamic_rcs);
+        r.scan_period_s = node["scan_period_s"].as<double>(r.scan_period_s);
+        r.dwell_ms = node["dwell_ms"].as<double>(r.dwell_ms);
+        ReadLatency(node["latency"], r.latency);
+    }
+}
+
+bool LoadScenario(const std::string& path, Scenario& out, std::string& error)
+{
+    try
+    {
+        YAML::Node root = YAML::LoadFile(path);
+        Scenario s;
+        for (const auto& node : root["uavs"])
+        {
+            UavSpec u;
+            u.id = node["id"].as<std::string>(u.id);
+            u.state.lat = node["lat"].as<double>(u.state.lat);
+            u.state.lon = node["lon"].as<double>(u.state.lon);
+            u.state.alt = node["alt"].as<double>(u.state.alt);
+            u.state.heading = node["heading"].as<double>(u.state.heading);
+            u.state.speed = node["speed"].as<double>(u.state.speed);
+            u.period_s = node["period_s"].as<double>(u.period_s);
+            ReadLatency(node["latency"], u.latency);
+            s.uavs.push_back(u);
+        }
+        for (const auto& node : root["radars"])
+        {
+            RadarSpec r;
+            ReadRadar(node, r);
+            s.radars.push_back(r);
+        }
+        if (const YAML::Node& grid = root["radar_grid"])
+        {
+            RadarSpec tmpl;
+            if (grid["template"])
+                ReadRadar(grid["template"], tmpl);
+            const YAML::Node& center = grid["center"];
+            AddRadarGrid(s, grid["count"].as<size_t>(0), center["lat"].as<double>(39.9),
+                         center["lon"].as<double>(32.8), grid["spacing_km"].as<double>(5.0), tmpl);
+        }
+        for (const auto& node : root["sigint"])
+        {
+            SigintSpec g;
+            g.id = node["id"].as<std::string>(g.id);
+            g.lat = node["lat"].as<double>(g.lat);
+            g.lon = node["lon"].as<double>(g.lon);
+            g.period_s = node["period_s"].as<double>(g.period_s);
+            g.freq_mean = node["freq_mean"].as<double>(g.freq_mean);
+            g.freq_sigma = node["freq_sigma"].as<double>(g.freq_sigma);
+            g.bearing_sigma = node["bearing_sigma"].as<double>(g.bearing_sigma);
+            ReadLatency(node["latency"], g.latency);
+            s.sigints.push_back(g);
+        }
+        if (s.uavs.empty())
+        {
+            error = "no uavs defined";
+            return false;
+        }
+        out = std::move(s);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+        return false;
+    }
+}
+
+Scenario DefaultScenario()
+{
+    Scenario s;
+
+    UavSpec uav;
+    s.uavs.push_back(uav);
+
+    RadarSpec long_range;
+    long_range.radar.id = "TPS-77-LONG-RANGE";
+    long_range.radar.lat = 39.750;
+    long_range.radar.lon = 32.700;
+    long_range.radar.range_sigma = 50.0;
+    long_range.radar.bearing_sigma = 1.5;
+    long_range.radar.dynamic_rcs = true;
+    long_range.radar.sensitivity = 1e-20;
+    long_range.radar.carrier_freq_hz = 1.3e9;
+    long_range.scan_period_s = 10.0;
+    long_range.dwell_ms = 40.0;
+    long_range.latency = {150.0, 40.0};
+    s.radars.push_back(long_range);
+
+    RadarSpec patriot;
+    patriot.radar.id = "AN-MPQ-53-PATRIOT";
+    patriot.radar.lat = 39.940;
+    patriot.radar.lon = 32.855;
+    patriot.radar.range_sigma = 5.0;
+    patriot.radar.bearing_sigma = 0.1;
+    patriot.radar.dynamic_rcs = true;
+    patriot.radar.sensitivity = 1e-15;
+    patriot.radar.carrier_freq_hz = 5.5e9;
+    patriot.scan_period_s = 1.0;
+    patriot.dwell_ms = 10.0;
+    patriot.latency = {30.0, 5.0};
+    s.radars.push_back(patriot);
+
+    s.sigints.push_back(SigintSpec());
+    return s;
+}
+
+void AddRadarGrid(Scenario& s, size_t count, double lat, double lon, double spacing_km, const RadarSpec& tmpl)
+{
+    if (count == 0)
+        return;
+    size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    double dlat = spacing_km * 1000.0 / METERS_PER_DEG_LAT;
+    double dlon = dlat / std::cos(lat * M_PI / 180.0);
+    double half = (side - 1) / 2.0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        RadarSpec r = tmpl;
+        char id[32];
+        std::snprintf(id, sizeof(id), "GRID-RADAR-%04zu", i + 1);
+        r.radar.id = id;
+        r.radar.lat = lat + (static_cast<double>(i / side) - half) * dlat;
+        r.radar.lon = lon + (static_cast<double>(i % side) - half) * dlon;
+        s.radars.push_back(r);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "sensor_models.h"
+
+// Sensors hosted by one sim_host process.
+//
+// Loaded from YAML (see scenario.example.yaml):
+//   uavs:
+//     - {id: UAV-ALFA, lat: 39.92, lon: 32.85, alt: 1200, heading: 45}
+//   radars:
+//     - id: TPS-77-LONG-RANGE
+//       lat: 39.75
+//       lon: 32.70
+//       scan_period_s: 10
+//       dwell_ms: 40
+//       latency: {mean_ms: 150, jitter_ms: 40}
+//   radar_grid:                  # generated radars on a square grid
+//     count: 500
+//     center: {lat: 39.9, lon: 32.8}
+//     spacing_km: 4
+//     template: {scan_period_s: 4, sensitivity: 1e-16}
+//   sigint:
+//     - {id: SIGINT-01, lat: 39.88, lon: 32.80}
+//
+// Omitted keys keep the defaults below.
+
+// Delay from measurement to the message leaving the sensor, drawn per
+// message from a normal distribution clipped at zero.
+struct LatencyModel
+{
+    double mean_ms = 50.0;
+    double jitter_ms = 10.0;
+};
+
+struct RadarSpec
+{
+    models::RadarConfig radar;
+    double scan_period_s = 1.0;     // One antenna revolution
+    double dwell_ms = 20.0;         // Time on target; the report follows the dwell
+    LatencyModel latency;
+};
+
+struct UavSpec
+{
+    std::string id = "UAV-ALFA";
+    models::UavState state;
+    double period_s = 1.0;          // Telemetry and motion step
+    LatencyModel latency;
+};
+
+struct SigintSpec
+{
+    std::string id = "SIGINT-01";
+    double lat = 39.88;
+    double lon = 32.80;
+    double period_s = 1.0;
+    double freq_mean = 1450.0;      // MHz
+    double freq_sigma = 5.0;
+    double bearing_sigma = 2.0;     // degrees
+    LatencyModel latency;
+};
+
+struct Scenario
+{
+    std::vector<UavSpec> uavs;
+    std::vector<RadarSpec> radars;
+    std::vector<SigintSpec> sigints;
+};
+
+bool LoadScenario(const std::string& path, Scenario& out, std::string& error);
+
+// The docker-compose sensors: one UAV, the two radars and one SIGINT sensor.
+Scenario DefaultScenario();
+
+// Appends `count` copies of `tmpl` on a square grid `spacing_km` apart,
+// centred on (lat, lon), with ids GRID-RADAR-0001...
+void AddRadarGrid(Scenario& s, size_t count, double lat, double lon, double spacing_km, const RadarSpec& tmpl);
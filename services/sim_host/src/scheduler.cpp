@@ -0,0 +1,45 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace sim {
+
+Scheduler::~Scheduler()
+{
+    while (!queue_.empty())
+    {
+        queue_.top().handle.destroy();
+        queue_.pop();
+    }
+}
+
+void Scheduler::Run(SimTime until, Pacing pacing, double speed)
+{
+    const auto wall_start = std::chrono::steady_clock::now();
+    const SimTime virtual_start = now_;
+    if (speed <= 0.0)
+        speed = 1.0;
+
+    while (!queue_.empty() && queue_.top().time <= until)
+    {
+        Event ev = queue_.top();
+        queue_.pop();
+
+        if (pacing == Pacing::WallClock && ev.time > now_)
+        {
+            auto offset = std::chrono::duration<double, std::micro>((ev.time - virtual_start) / speed);
+            std::this_thread::sleep_until(wall_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset));
+        }
+
+        now_ = ev.time;
+        ++events_;
+        ev.handle.resume();
+    }
+    // Stopped at the horizon rather than out of work: time has reached it.
+    if (!queue_.empty())
+        now_ = std::max(now_, until);
+}
+
+} // namespace sim
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <queue>
+#include <vector>
+
+// Discrete-event scheduler for sensor coroutines.
+//
+// Every sensor is a sim::Task that suspends on `co_await sched.Sleep(dt)`;
+// the scheduler resumes suspended tasks in virtual-time order (ties in
+// scheduling order) from one thread, so sensors need no locking between
+// themselves. Virtual time is in microseconds.
+namespace sim {
+
+using SimTime = int64_t;
+
+constexpr SimTime MILLIS = 1000;
+constexpr SimTime SECONDS = 1000 * MILLIS;
+
+// Fire-and-forget coroutine. It starts suspended; Scheduler::Spawn queues it
+// and it frees itself when its body returns.
+class Task
+{
+public:
+    struct promise_type
+    {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task()
+    {
+        if (handle_)
+            handle_.destroy(); // Never spawned
+    }
+
+    std::coroutine_handle<> Release()
+    {
+        std::coroutine_handle<> h = handle_;
+        handle_ = nullptr;
+        return h;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+enum class Pacing
+{
+    WallClock,  // Virtual time follows the wall clock (times `speed`)
+    AsFastAsPossible,
+};
+
+class Scheduler
+{
+public:
+    Scheduler() = default;
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+    ~Scheduler();  // Destroys tasks that are still suspended
+
+    SimTime Now() const { return now_; }
+
+    // Queues a task to start at the current virtual time.
+    void Spawn(Task task) { Schedule(now_, task.Release()); }
+
+    struct SleepAwaiter
+    {
+        Scheduler& sched;
+        SimTime wake;
+        bool await_ready() const noexcept { return false; }  // Always queue, so ties stay FIFO
+        void await_suspend(std::coroutine_handle<> h) { sched.Schedule(wake, h); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await sched.Sleep(dt): resume dt later in virtual time (dt <= 0
+    // yields to other tasks due now).
+    SleepAwaiter Sleep(SimTime dt) { return SleepAwaiter{*this, now_ + (dt > 0 ? dt : 0)}; }
+    SleepAwaiter Until(SimTime t) { return SleepAwaiter{*this, t > now_ ? t : now_}; }
+
+    // Runs events up to virtual time `until` (or until none are left).
+    // With WallClock pacing, an event at virtual t runs at
+    // start + t / speed on the steady clock.
+    void Run(SimTime until, Pacing pacing, double speed = 1.0);
+
+    uint64_t events() const { return events_; }
+    size_t pending() const { return queue_.size(); }
+
+private:
+    struct Event
+    {
+        SimTime time;
+        uint64_t seq;
+        std::coroutine_handle<> handle;
+        bool operator>(const Event& o) const { return time != o.time ? time > o.time : seq > o.seq; }
+    };
+
+    void Schedule(SimTime t, std::coroutine_handle<> h) { queue_.push(Event{t, seq_++, h}); }
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> queue_;
+    SimTime now_ = 0;
+    uint64_t seq_ = 0;
+    uint64_t events_ = 0;
+};
+
+} // namespace sim
@@ -0,0 +1,220 @@
+#include "sensor_tasks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+#include "geo_utils.h"
+
+namespace
+{
+    sim::SimTime SampleLatency(const LatencyModel& l, std::mt19937& gen)
+    {
+        std::normal_distribution<> dist(l.mean_ms, l.jitter_ms);
+        return static_cast<sim::SimTime>(std::max(0.0, dist(gen)) * sim::MILLIS);
+    }
+
+    sim::SimTime Period(double seconds)
+    {
+        return std::max<sim::SimTime>(static_cast<sim::SimTime>(seconds * sim::SECONDS), sim::MILLIS);
+    }
+
+    template <typename Msg>
+    sim::Task Deliver(sim::Scheduler& sched, Outlet& out, Msg msg, sim::SimTime delay)
+    {
+        co_await sched.Sleep(delay);
+        out.Send(msg);
+    }
+
+    void WriteTruth(const World& world, int64_t timestamp_ms)
+    {
+        // Same format as sensor_uav, for the analysis scripts
+        std::ofstream ofs(world.truth_path, std::ofstream::trunc);
+        if (!ofs)
+            return;
+        const models::TargetState& t = world.targets[0];
+        ofs << std::fixed << std::setprecision(9) << t.lat << " " << t.lon << " " << t.alt << " "
+            << timestamp_ms << " " << t.heading << " " << t.v_north << " " << t.v_east << "\n";
+    }
+}
+
+// ==================== Outlet ====================
+
+Outlet::Outlet(const std::string& target)
+{
+    if (target.empty())
+        return;
+    transport::TransportConfig config = transport::LoadTransportConfig("sim_host");
+    auto channel = transport::CreateChannel(target, config);
+    stub_ = fusion::FusionService::NewStub(channel);
+    radar_stream_ = std::make_unique<transport::StreamTransport<sensors::RadarDetection, fusion::FusionAck>>(
+        "SIM_HOST/RADAR", channel,
+        [this](grpc::ClientContext* context, fusion::FusionAck* ack) { return stub_->StreamRadar(context, ack); },
+        config);
+    uav_stream_ = std::make_unique<transport::StreamTransport<sensors::UAVTelemetry, fusion::FusionAck>>(
+        "SIM_HOST/UAV", channel,
+        [this](grpc::ClientContext* context, fusion::FusionAck* ack) { return stub_->StreamUAV(context, ack); },
+        config);
+    sigint_stream_ = std::make_unique<transport::StreamTransport<sensors::SigintHit, fusion::FusionAck>>(
+        "SIM_HOST/SIGINT", channel,
+        [this](grpc::ClientContext* context, fusion::FusionAck* ack) { return stub_->StreamSigint(context, ack); },
+        config);
+}
+
+Outlet::~Outlet()
+{
+    // Flush what is still spooled before the stub goes away
+    if (radar_stream_)
+        radar_stream_->Close();
+    if (uav_stream_)
+        uav_stream_->Close();
+    if (sigint_stream_)
+        sigint_stream_->Close();
+}
+
+void Outlet::Send(const sensors::RadarDetection& msg)
+{
+    ++radar_;
+    if (radar_stream_ && !radar_stream_->Send(msg))
+        ++dropped_;
+}
+
+void Outlet::Send(const sensors::UAVTelemetry& msg)
+{
+    ++uav_;
+    if (uav_stream_ && !uav_stream_->Send(msg))
+        ++dropped_;
+}
+
+void Outlet::Send(const sensors::SigintHit& msg)
+{
+    ++sigint_;
+    if (sigint_stream_ && !sigint_stream_->Send(msg))
+        ++dropped_;
+}
+
+// ==================== Sensors ====================
+
+sim::Task UavTask(sim::Scheduler& sched, World& world, size_t index, UavSpec spec, Outlet& out, uint64_t seed)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
+    const sim::SimTime period = Period(spec.period_s);
+    models::UavState& s = spec.state;
+
+    while (true)
+    {
+        models::StepUav(s);
+        world.targets[index] = {s.lat, s.lon, s.alt, s.heading, s.v_north, s.v_east};
+        if (index == 0 && !world.truth_path.empty())
+            WriteTruth(world, world.TimestampMs(sched.Now()));
+
+        sensors::UAVTelemetry msg;
+        msg.mutable_header()->set_timestamp(world.TimestampMs(sched.Now()));
+        msg.mutable_header()->set_sensor_id(spec.id);
+        msg.set_uav_id(spec.id);
+        msg.mutable_position()->set_lat(s.lat);
+        msg.mutable_position()->set_lon(s.lon);
+        msg.mutable_position()->set_alt(s.alt);
+        msg.set_speed(s.speed);
+        msg.set_heading(s.heading);
+        msg.set_status("Flying");
+        sched.Spawn(Deliver(sched, out, std::move(msg), SampleLatency(spec.latency, gen)));
+
+        co_await sched.Sleep(period);
+    }
+}
+
+sim::Task RadarTask(sim::Scheduler& sched, const World& world, RadarSpec spec, Outlet& out, uint64_t seed)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
+    models::RadarModel model(spec.radar);
+    const models::RadarConfig& radar = model.config();
+    const sim::SimTime period = Period(spec.scan_period_s);
+    const sim::SimTime dwell = static_cast<sim::SimTime>(spec.dwell_ms * sim::MILLIS);
+
+    // Radars do not start in step: random antenna phase.
+    co_await sched.Sleep(std::uniform_int_distribution<sim::SimTime>(0, period - 1)(gen));
+
+    // (time the beam crosses the target, target index), per revolution.
+    // Indices past the targets are this revolution's false alarms.
+    std::vector<std::pair<sim::SimTime, size_t>> crossings;
+    std::vector<models::RadarDetection> clutter;
+    const size_t n_targets = world.targets.size();
+    while (true)
+    {
+        const sim::SimTime scan_start = sched.Now();
+        crossings.clear();
+        for (size_t i = 0; i < n_targets; ++i)
+        {
+            double bearing = geo_utils::BearingDegrees(radar.lat, radar.lon, world.targets[i].lat, world.targets[i].lon);
+            crossings.emplace_back(scan_start + static_cast<sim::SimTime>(bearing / 360.0 * period), i);
+        }
+        clutter.clear();
+        model.Clutter(gen, clutter);
+        for (size_t k = 0; k < clutter.size(); ++k)
+            crossings.emplace_back(scan_start + static_cast<sim::SimTime>(clutter[k].bearing / 360.0 * period), n_targets + k);
+        std::sort(crossings.begin(), crossings.end());
+
+        for (const auto& c : crossings)
+        {
+            co_await sched.Until(c.first);
+
+            // Look at where the target is now; the report leaves after the dwell.
+            models::RadarDetection det;
+            bool false_alarm = c.second >= n_targets;
+            if (false_alarm)
+                det = clutter[c.second - n_targets];
+            else if (!model.Detect(world.targets[c.second], gen, det))
+                continue;
+
+            sensors::RadarDetection msg;
+            msg.mutable_header()->set_timestamp(world.TimestampMs(sched.Now()));
+            msg.mutable_header()->set_sensor_id(radar.id);
+            msg.set_track_id(false_alarm ? "" : world.ids[c.second]);
+            msg.set_range(det.range);
+            msg.set_bearing(det.bearing);
+            msg.set_radar_lat(det.lat);
+            msg.set_radar_lon(det.lon);
+            msg.set_radar_alt(false_alarm ? radar.alt : world.targets[c.second].alt);
+            msg.set_rcs(det.rcs);
+            msg.set_velocity(det.range_rate);
+            msg.set_velocity_sigma(model.range_rate_sigma());
+            msg.set_range_sigma(radar.range_sigma);
+            msg.set_bearing_sigma(radar.bearing_sigma);
+            sched.Spawn(Deliver(sched, out, std::move(msg), dwell + SampleLatency(spec.latency, gen)));
+        }
+
+        co_await sched.Until(scan_start + period);
+    }
+}
+
+sim::Task SigintTask(sim::Scheduler& sched, const World& world, SigintSpec spec, Outlet& out, uint64_t seed)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
+    std::normal_distribution<> freq_dist(spec.freq_mean, spec.freq_sigma);
+    std::normal_distribution<> bearing_noise(0.0, spec.bearing_sigma);
+    std::uniform_real_distribution<> power_jitter(0.0, 10.0);
+    const sim::SimTime period = Period(spec.period_s);
+
+    co_await sched.Sleep(std::uniform_int_distribution<sim::SimTime>(0, period - 1)(gen));
+    while (true)
+    {
+        // Intercepts the first target's emitter.
+        const models::TargetState& t = world.targets[0];
+        double bearing = geo_utils::BearingDegrees(spec.lat, spec.lon, t.lat, t.lon) + bearing_noise(gen);
+
+        sensors::SigintHit msg;
+        msg.mutable_header()->set_timestamp(world.TimestampMs(sched.Now()));
+        msg.mutable_header()->set_sensor_id(spec.id);
+        // Higher altitude -> slightly higher frequency, as in sensor_sigint
+        msg.set_frequency(freq_dist(gen) + (t.alt - 1000.0) * 0.01);
+        msg.set_power(-40.0 + power_jitter(gen));
+        msg.set_confidence(0.95);
+        msg.set_bearing(std::fmod(bearing + 360.0, 360.0));
+        sched.Spawn(Deliver(sched, out, std::move(msg), SampleLatency(spec.latency, gen)));
+
+        co_await sched.Sleep(period);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fusion/fusion.grpc.pb.h"
+#include "scenario.h"
+#include "scheduler.h"
+#include "sensor_models.h"
+#include "sensor_transport.h"
+#include "sensors/radar.pb.h"
+#include "sensors/sigint.pb.h"
+#include "sensors/uav.pb.h"
+
+// Ground truth shared by the hosted sensors. Only touched from the
+// scheduler thread.
+struct World
+{
+    int64_t epoch_ms = 0;                       // Wall-clock ms at virtual time 0
+    std::vector<std::string> ids;
+    std::vector<models::TargetState> targets;   // Parallel to ids
+    std::string truth_path;                     // Ground truth file for targets[0]; empty disables
+
+    int64_t TimestampMs(sim::SimTime t) const { return epoch_ms + t / sim::MILLIS; }
+};
+
+// Where hosted sensors send their messages: one gRPC stream per message
+// type, shared by every sensor of that type (the header carries the sensor
+// id), or nowhere when only counting.
+class Outlet
+{
+public:
+    // Empty target: count messages without sending them.
+    explicit Outlet(const std::string& target);
+    ~Outlet();
+
+    void Send(const sensors::RadarDetection& msg);
+    void Send(const sensors::UAVTelemetry& msg);
+    void Send(const sensors::SigintHit& msg);
+
+    uint64_t radar() const { return radar_; }
+    uint64_t uav() const { return uav_; }
+    uint64_t sigint() const { return sigint_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    std::unique_ptr<fusion::FusionService::Stub> stub_;
+    std::unique_ptr<transport::StreamTransport<sensors::RadarDetection, fusion::FusionAck>> radar_stream_;
+    std::unique_ptr<transport::StreamTransport<sensors::UAVTelemetry, fusion::FusionAck>> uav_stream_;
+    std::unique_ptr<transport::StreamTransport<sensors::SigintHit, fusion::FusionAck>> sigint_stream_;
+
+    uint64_t radar_ = 0;
+    uint64_t uav_ = 0;
+    uint64_t sigint_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+// Sensor coroutines. Each keeps its own period and RNG (seeded with `seed`)
+// and hands every message to a short-lived delivery task that sleeps out
+// the sensor's latency, so a slow link never delays the next measurement.
+sim::Task UavTask(sim::Scheduler& sched, World& world, size_t index, UavSpec spec, Outlet& out, uint64_t seed);
+sim::Task RadarTask(sim::Scheduler& sched, const World& world, RadarSpec spec, Outlet& out, uint64_t seed);
+sim::Task SigintTask(sim::Scheduler& sched, const World& world, SigintSpec spec, Outlet& out, uint64_t seed);
@@ -0,0 +1,88 @@
+#include "aggregator_monitor.h"
+
+#include <chrono>
+
+#include "geo_utils.h"
+
+void AggregatorMonitorServiceImpl::Publish(std::shared_ptr<const fusion::MonitorResponse> picture)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        picture_ = std::move(picture);
+        ++seq_;
+    }
+    cv_.notify_all();
+}
+
+bool AggregatorMonitorServiceImpl::Selected(const fusion::MonitorRequest& request,
+                                            const fusion::FusedTrack& track)
+{
+    double lat = track.position().lat(), lon = track.position().lon();
+    if (request.has_region()) {
+        const auto& b = request.region();
+        bool in_lon = (b.min_lon() <= b.max_lon()) ? (lon >= b.min_lon() && lon <= b.max_lon())
+                                                   : (lon >= b.min_lon() || lon <= b.max_lon());
+        if (lat < b.min_lat() || lat > b.max_lat() || !in_lon)
+            return false;
+    }
+    if (request.has_radius()) {
+        const auto& r = request.radius();
+        if (geo_utils::CalculateHaversine(r.center().lat(), r.center().lon(), lat, lon) > r.radius_m())
+            return false;
+    }
+    return true;
+}
+
+void AggregatorMonitorServiceImpl::Filter(const fusion::MonitorRequest& request,
+                                          const fusion::MonitorResponse& picture,
+                                          fusion::MonitorResponse& resp)
+{
+    resp.Clear();
+    for (const auto& t : picture.tracks()) {
+        if (Selected(request, t))
+            *resp.add_tracks() = t;
+    }
+}
+
+grpc::Status AggregatorMonitorServiceImpl::SubscribeFusedTracks(
+    grpc::ServerContext* context,
+    const fusion::MonitorRequest* request,
+    grpc::ServerWriter<fusion::MonitorResponse>* writer)
+{
+    // Merged tracks carry no trail; include_history is ignored.
+    const bool filtered = request->has_region() || request->has_radius();
+    std::shared_ptr<const fusion::MonitorResponse> picture;
+    uint64_t seen_seq = 0;
+    fusion::MonitorResponse resp;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        picture = picture_;
+        seen_seq = seq_;
+    }
+
+    while (true)
+    {
+        bool ok;
+        if (!picture)
+            ok = writer->Write(fusion::MonitorResponse());
+        else if (!filtered)
+            ok = writer->Write(*picture);
+        else {
+            Filter(*request, *picture, resp);
+            ok = writer->Write(resp);
+        }
+        if (!ok || !request->continuous())
+            return grpc::Status::OK;
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        // Wake up periodically to notice cancelled subscribers.
+        while (seq_ == seen_seq) {
+            if (context->IsCancelled())
+                return grpc::Status::OK;
+            cv_.wait_for(lock, std::chrono::milliseconds(500));
+        }
+        picture = picture_;
+        seen_seq = seq_;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "fusion/fusion.grpc.pb.h"
+
+// Serves the merged picture over the same FusionMonitor API as a fusion
+// node, so monitor_cli and further aggregation tiers can subscribe to it.
+// Region and radius filters are applied by a linear scan of the picture.
+class AggregatorMonitorServiceImpl final : public fusion::FusionMonitor::Service {
+public:
+    // Installs a new merged picture and wakes continuous subscribers.
+    void Publish(std::shared_ptr<const fusion::MonitorResponse> picture);
+
+    grpc::Status SubscribeFusedTracks(grpc::ServerContext* context,
+                                      const fusion::MonitorRequest* request,
+                                      grpc::ServerWriter<fusion::MonitorResponse>* writer) override;
+
+private:
+    static bool Selected(const fusion::MonitorRequest& request, const fusion::FusedTrack& track);
+    static void Filter(const fusion::MonitorRequest& request, const fusion::MonitorResponse& picture,
+                       fusion::MonitorResponse& resp);
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::shared_ptr<const fusion::MonitorResponse> picture_; // Guarded by mtx_
+    uint64_t seq_ = 0;                                        // Guarded by mtx_
+};
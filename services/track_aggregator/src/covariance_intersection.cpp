@@ -0,0 +1,123 @@
+#include "covariance_intersection.h"
+
+#include <cmath>
+
+namespace
+{
+    bool Valid(const Estimate2D& e)
+    {
+        return e.pxx > 0.0 && e.pyy > 0.0 && e.pxx * e.pyy - e.pxy * e.pxy > 0.0;
+    }
+
+    // Information form: I = P^-1, i = P^-1 x.
+    struct Info {
+        double ixx = 0.0, ixy = 0.0, iyy = 0.0;
+        double ix = 0.0, iy = 0.0;
+
+        void Add(const Estimate2D& e, double w)
+        {
+            double det = e.pxx * e.pyy - e.pxy * e.pxy;
+            double a = e.pyy / det, b = -e.pxy / det, c = e.pxx / det;
+            ixx += w * a;
+            ixy += w * b;
+            iyy += w * c;
+            ix += w * (a * e.x + b * e.y);
+            iy += w * (b * e.x + c * e.y);
+        }
+
+        Estimate2D ToEstimate() const
+        {
+            double det = ixx * iyy - ixy * ixy;
+            Estimate2D out;
+            out.pxx = iyy / det;
+            out.pxy = -ixy / det;
+            out.pyy = ixx / det;
+            out.x = out.pxx * ix + out.pxy * iy;
+            out.y = out.pxy * ix + out.pyy * iy;
+            return out;
+        }
+
+        double CovTrace() const
+        {
+            return (ixx + iyy) / (ixx * iyy - ixy * ixy);
+        }
+    };
+
+    Info Pair(const Estimate2D& a, const Estimate2D& b, double w)
+    {
+        Info info;
+        info.Add(a, w);
+        info.Add(b, 1.0 - w);
+        return info;
+    }
+}
+
+Estimate2D CovarianceIntersection(const std::vector<Estimate2D>& in)
+{
+    std::vector<const Estimate2D*> valid;
+    valid.reserve(in.size());
+    for (const auto& e : in)
+    {
+        if (Valid(e))
+            valid.push_back(&e);
+    }
+
+    if (valid.empty())
+    {
+        // No usable covariance: plain average.
+        Estimate2D out;
+        for (const auto& e : in)
+        {
+            out.x += e.x / in.size();
+            out.y += e.y / in.size();
+        }
+        return out;
+    }
+    if (valid.size() == 1)
+        return *valid.front();
+
+    if (valid.size() == 2)
+    {
+        const Estimate2D& a = *valid[0];
+        const Estimate2D& b = *valid[1];
+        const double phi = 0.5 * (std::sqrt(5.0) - 1.0);
+        double lo = 0.0, hi = 1.0;
+        double w1 = hi - phi * (hi - lo), w2 = lo + phi * (hi - lo);
+        double f1 = Pair(a, b, w1).CovTrace(), f2 = Pair(a, b, w2).CovTrace();
+        for (int i = 0; i < 24; ++i)
+        {
+            if (f1 < f2)
+            {
+                hi = w2;
+                w2 = w1;
+                f2 = f1;
+                w1 = hi - phi * (hi - lo);
+                f1 = Pair(a, b, w1).CovTrace();
+            }
+            else
+            {
+                lo = w1;
+                w1 = w2;
+                f1 = f2;
+                w2 = lo + phi * (hi - lo);
+                f2 = Pair(a, b, w2).CovTrace();
+            }
+        }
+        double w = 0.5 * (lo + hi);
+        // The optimum can sit on the boundary: keep the better input alone.
+        Info best = Pair(a, b, w);
+        if (a.pxx + a.pyy < best.CovTrace())
+            return a;
+        if (b.pxx + b.pyy < best.CovTrace())
+            return b;
+        return best.ToEstimate();
+    }
+
+    double norm = 0.0;
+    for (const Estimate2D* e : valid)
+        norm += 1.0 / (e->pxx + e->pyy);
+    Info info;
+    for (const Estimate2D* e : valid)
+        info.Add(*e, (1.0 / (e->pxx + e->pyy)) / norm);
+    return info.ToEstimate();
+}
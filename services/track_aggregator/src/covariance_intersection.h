@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+// 2-D position estimate in a local metric frame (x east, y north).
+struct Estimate2D {
+    double x = 0.0;
+    double y = 0.0;
+    double pxx = 0.0;
+    double pxy = 0.0;
+    double pyy = 0.0;
+};
+
+// Covariance intersection of estimates with unknown cross-correlation:
+// P^-1 = sum w_i P_i^-1, x = P sum w_i P_i^-1 x_i, sum w_i = 1.
+// Two inputs use the trace-optimal weight (golden-section search); more use
+// the fast trace-proportional weights w_i ~ 1 / tr(P_i). Inputs with a
+// non-positive-definite covariance are ignored unless all of them are.
+Estimate2D CovarianceIntersection(const std::vector<Estimate2D>& in);
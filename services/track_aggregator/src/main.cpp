@@ -0,0 +1,134 @@
+#include "aggregator_monitor.h"
+#include "track_aggregator.h"
+#include "config.h"
+#include "sensor_transport.h"
+
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // AGGREGATOR_SOURCES: comma-separated "name=host:port" entries; a bare
+    // address is named after itself.
+    std::vector<std::pair<std::string, std::string>> ParseSources(const std::string& spec)
+    {
+        std::vector<std::pair<std::string, std::string>> sources;
+        std::stringstream ss(spec);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            if (item.empty())
+                continue;
+            auto eq = item.find('=');
+            if (eq == std::string::npos)
+                sources.emplace_back(item, item);
+            else
+                sources.emplace_back(item.substr(0, eq), item.substr(eq + 1));
+        }
+        return sources;
+    }
+
+    // Keeps a continuous monitor subscription to one fusion node open and
+    // hands every picture it pushes to the aggregator.
+    void SubscribeNode(const std::string& name, const std::string& address, TrackAggregator& aggregator,
+                       const transport::TransportConfig& config)
+    {
+        auto channel = transport::CreateChannel(address, config);
+        auto stub = fusion::FusionMonitor::NewStub(channel);
+        transport::Backoff backoff(config.backoff_initial_ms, config.backoff_max_ms);
+
+        fusion::MonitorRequest request;
+        request.set_continuous(true);
+
+        while (true)
+        {
+            grpc::ClientContext context;
+            auto reader = stub->SubscribeFusedTracks(&context, request);
+            bool received = false;
+            auto picture = std::make_shared<fusion::MonitorResponse>();
+            while (reader->Read(picture.get()))
+            {
+                if (!received)
+                {
+                    std::cout << "[AGGREGATOR] Subscribed to " << name << " at " << address << std::endl;
+                    received = true;
+                    backoff.Reset();
+                }
+                aggregator.UpdateNode(name, std::move(picture));
+                picture = std::make_shared<fusion::MonitorResponse>();
+            }
+            grpc::Status status = reader->Finish();
+            if (received)
+                std::cerr << "[AGGREGATOR] Lost " << name << " (" << status.error_message() << "), reconnecting"
+                          << std::endl;
+            std::this_thread::sleep_for(backoff.Next());
+        }
+    }
+}
+
+int main()
+{
+    std::string address("0.0.0.0:" + std::to_string((int)utils::GetEnvDouble("AGGREGATOR_PORT", 6300)));
+    auto sources = ParseSources(utils::GetEnvString("AGGREGATOR_SOURCES", "localhost:6005"));
+    auto period = std::chrono::milliseconds((int)utils::GetEnvDouble("AGGREGATOR_PERIOD_MS", 100));
+    double gate_m = utils::GetEnvDouble("AGGREGATOR_GATE_M", 500.0);
+    double stale_sec = utils::GetEnvDouble("AGGREGATOR_STALE_SEC", 5.0);
+    double default_sigma_m = utils::GetEnvDouble("AGGREGATOR_DEFAULT_SIGMA_M", 100.0);
+
+    if (sources.empty())
+    {
+        std::cerr << "[AGGREGATOR] AGGREGATOR_SOURCES is empty" << std::endl;
+        return 1;
+    }
+
+    TrackAggregator aggregator(gate_m, stale_sec, default_sigma_m);
+    AggregatorMonitorServiceImpl monitor;
+
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&monitor);
+    std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+    if (!server)
+    {
+        std::cerr << "[AGGREGATOR] Failed to listen on " << address << std::endl;
+        return 1;
+    }
+    std::cout << "[AGGREGATOR] Running at " << address << ", gate " << gate_m << " m" << std::endl;
+
+    transport::TransportConfig config = transport::LoadTransportConfig("aggregator");
+    for (const auto& s : sources)
+    {
+        std::thread(SubscribeNode, s.first, s.second, std::ref(aggregator), config).detach();
+    }
+
+    auto next = std::chrono::steady_clock::now();
+    auto last_log = next;
+    while (true)
+    {
+        next += period;
+        std::this_thread::sleep_until(next);
+
+        auto merged = std::make_shared<fusion::MonitorResponse>();
+        auto started = std::chrono::steady_clock::now();
+        aggregator.Fuse(*merged);
+        auto fuse_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        monitor.Publish(std::move(merged));
+
+        if (std::chrono::steady_clock::now() - last_log >= std::chrono::seconds(5))
+        {
+            last_log = std::chrono::steady_clock::now();
+            const auto& st = aggregator.last_cycle();
+            std::cout << "[AGGREGATOR] " << st.input_tracks << " node tracks -> " << st.fused_tracks
+                      << " merged (" << st.new_bindings << " new bindings), cycle " << fuse_us << " us"
+                      << std::endl;
+        }
+    }
+    return 0;
+}
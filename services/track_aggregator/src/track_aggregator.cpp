@@ -0,0 +1,262 @@
+#include "track_aggregator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "covariance_intersection.h"
+#include "geo_utils.h"
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+}
+
+TrackAggregator::TrackAggregator(double gate_m, double stale_sec, double default_sigma_m)
+    : gate_m_(gate_m),
+      cell_deg_(std::max(gate_m, 1.0) / METERS_PER_DEG_LAT),
+      stale_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(stale_sec))),
+      default_var_m2_(default_sigma_m * default_sigma_m)
+{}
+
+void TrackAggregator::UpdateNode(const std::string& node, std::shared_ptr<const fusion::MonitorResponse> picture)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& n : nodes_)
+    {
+        if (n.name == node)
+        {
+            n.picture = std::move(picture);
+            n.received = std::chrono::steady_clock::now();
+            return;
+        }
+    }
+    nodes_.push_back({node, std::move(picture), std::chrono::steady_clock::now()});
+}
+
+// Cells are gate-sized in meters: longitude is scaled by cos(lat) so the
+// 3x3 neighbourhood always covers the gate.
+int64_t TrackAggregator::Cell(double lat, double lon) const
+{
+    int64_t row = (int64_t)std::floor(lat / cell_deg_);
+    int64_t col = (int64_t)std::floor(lon * std::cos(lat * M_PI / 180.0) / cell_deg_);
+    return (row << 32) ^ (col & 0xffffffff);
+}
+
+bool TrackAggregator::HasMember(const Aggregate& a, uint32_t node) const
+{
+    for (const Member& m : a.members)
+    {
+        if (m.node == node)
+            return true;
+    }
+    return false;
+}
+
+uint32_t TrackAggregator::Associate(uint32_t node, const fusion::FusedTrack& t)
+{
+    const double lat = t.position().lat(), lon = t.position().lon();
+
+    if (!t.external_id().empty())
+    {
+        auto it = by_external_.find(t.external_id());
+        if (it != by_external_.end())
+        {
+            auto agg = aggregates_.find(it->second);
+            if (agg != aggregates_.end() && !HasMember(agg->second, node))
+                return it->second;
+        }
+    }
+
+    uint32_t best = 0;
+    double best_d = gate_m_;
+    int64_t row = (int64_t)std::floor(lat / cell_deg_);
+    int64_t col = (int64_t)std::floor(lon * std::cos(lat * M_PI / 180.0) / cell_deg_);
+    for (int64_t dr = -1; dr <= 1; ++dr)
+    {
+        for (int64_t dc = -1; dc <= 1; ++dc)
+        {
+            auto cell = grid_.find(((row + dr) << 32) ^ ((col + dc) & 0xffffffff));
+            if (cell == grid_.end())
+                continue;
+            for (uint32_t id : cell->second)
+            {
+                auto agg = aggregates_.find(id);
+                if (agg == aggregates_.end() || HasMember(agg->second, node))
+                    continue;
+                double d = geo_utils::CalculateHaversine(lat, lon, agg->second.lat, agg->second.lon);
+                if (d <= best_d)
+                {
+                    best_d = d;
+                    best = id;
+                }
+            }
+        }
+    }
+    if (best != 0)
+        return best;
+
+    uint32_t id = next_id_++;
+    Aggregate& a = aggregates_[id];
+    a.lat = lat;
+    a.lon = lon;
+    a.external_id = t.external_id();
+    if (!a.external_id.empty())
+        by_external_[a.external_id] = id;
+    // Visible to the remaining nodes of this cycle, so a target first seen
+    // by two nodes at once does not start two aggregate tracks.
+    grid_[Cell(lat, lon)].push_back(id);
+    return id;
+}
+
+void TrackAggregator::Fuse(fusion::MonitorResponse& out)
+{
+    std::vector<NodePicture> nodes;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        nodes = nodes_;
+    }
+
+    stats_ = CycleStats();
+    auto now = std::chrono::steady_clock::now();
+    for (auto& kv : aggregates_)
+        kv.second.members.clear();
+
+    std::unordered_map<uint64_t, uint32_t> bindings;
+    bindings.reserve(bindings_.size());
+    for (uint32_t n = 0; n < nodes.size(); ++n)
+    {
+        // A node that stopped reporting drops out; its tracks age away.
+        if (!nodes[n].picture || now - nodes[n].received > stale_)
+            continue;
+
+        for (const fusion::FusedTrack& t : nodes[n].picture->tracks())
+        {
+            stats_.input_tracks++;
+            uint64_t key = Key(n, t.track_id());
+            uint32_t id = 0;
+
+            auto bound = bindings_.find(key);
+            if (bound != bindings_.end())
+            {
+                auto agg = aggregates_.find(bound->second);
+                if (agg != aggregates_.end() && !HasMember(agg->second, n) &&
+                    geo_utils::CalculateHaversine(t.position().lat(), t.position().lon(),
+                                                  agg->second.lat, agg->second.lon) <= 2.0 * gate_m_)
+                    id = bound->second;
+            }
+            if (id == 0)
+            {
+                id = Associate(n, t);
+                stats_.new_bindings++;
+            }
+
+            aggregates_[id].members.push_back({n, &t});
+            bindings.emplace(key, id);
+        }
+    }
+    bindings_.swap(bindings);
+
+    out.Clear();
+    grid_.clear();
+    for (auto it = aggregates_.begin(); it != aggregates_.end();)
+    {
+        Aggregate& a = it->second;
+        if (a.members.empty())
+        {
+            auto ext = by_external_.find(a.external_id);
+            if (ext != by_external_.end() && ext->second == it->first)
+                by_external_.erase(ext);
+            it = aggregates_.erase(it);
+            continue;
+        }
+
+        fusion::FusedTrack* ft = out.add_tracks();
+        FuseAggregate(it->first, a, nodes, *ft);
+        a.lat = ft->position().lat();
+        a.lon = ft->position().lon();
+        grid_[Cell(a.lat, a.lon)].push_back(it->first);
+        ++it;
+    }
+    stats_.fused_tracks = (size_t)out.tracks_size();
+
+    // Pictures are only referenced until the merged tracks are written.
+    for (auto& kv : aggregates_)
+        kv.second.members.clear();
+}
+
+void TrackAggregator::FuseAggregate(uint32_t id, const Aggregate& a, const std::vector<NodePicture>& nodes,
+                                    fusion::FusedTrack& out) const
+{
+    // Fuse in a local east/north frame around the first member.
+    const fusion::FusedTrack& ref = *a.members.front().track;
+    const double lat0 = ref.position().lat(), lon0 = ref.position().lon();
+    const double m_lon = METERS_PER_DEG_LAT * std::cos(lat0 * M_PI / 180.0);
+
+    std::vector<Estimate2D> estimates;
+    estimates.reserve(a.members.size());
+    const fusion::FusedTrack* tightest = &ref;
+    double tightest_trace = 0.0;
+    int64_t newest_ts = 0;
+    double alt = 0.0;
+    for (const Member& m : a.members)
+    {
+        const fusion::FusedTrack& t = *m.track;
+        Estimate2D e;
+        double dlon = t.position().lon() - lon0;
+        if (dlon > 180.0)
+            dlon -= 360.0;
+        else if (dlon < -180.0)
+            dlon += 360.0;
+        e.x = dlon * m_lon;
+        e.y = (t.position().lat() - lat0) * METERS_PER_DEG_LAT;
+        if (t.has_covariance())
+        {
+            e.pxx = t.covariance().east_east();
+            e.pxy = t.covariance().north_east();
+            e.pyy = t.covariance().north_north();
+        }
+        else
+        {
+            e.pxx = e.pyy = default_var_m2_;
+        }
+        double trace = e.pxx + e.pyy;
+        if (estimates.empty() || trace < tightest_trace)
+        {
+            tightest = &t;
+            tightest_trace = trace;
+        }
+        estimates.push_back(e);
+        newest_ts = std::max<int64_t>(newest_ts, t.measurement_ts());
+        alt += t.position().alt() / a.members.size();
+    }
+
+    Estimate2D fused = CovarianceIntersection(estimates);
+
+    // Kinematics and metadata come from the most certain member.
+    out = *tightest;
+    out.set_track_id(id);
+    out.set_measurement_ts(newest_ts);
+    double lon = lon0 + fused.x / m_lon;
+    if (lon > 180.0)
+        lon -= 360.0;
+    else if (lon <= -180.0)
+        lon += 360.0;
+    out.mutable_position()->set_lat(lat0 + fused.y / METERS_PER_DEG_LAT);
+    out.mutable_position()->set_lon(lon);
+    out.mutable_position()->set_alt(alt);
+    out.mutable_covariance()->set_north_north(fused.pyy);
+    out.mutable_covariance()->set_north_east(fused.pxy);
+    out.mutable_covariance()->set_east_east(fused.pxx);
+    out.clear_history();
+    out.clear_source_sensors();
+    out.clear_source_nodes();
+    for (const Member& m : a.members)
+    {
+        out.add_source_nodes(nodes[m.node].name);
+        for (const std::string& s : m.track->source_sensors())
+        {
+            if (std::find(out.source_sensors().begin(), out.source_sensors().end(), s) == out.source_sensors().end())
+                out.add_source_sensors(s);
+        }
+    }
+}
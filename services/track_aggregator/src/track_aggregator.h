@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fusion/fusion.pb.h"
+
+// Merges the track pictures of several fusion nodes into one.
+//
+// Node tracks are bound to aggregate tracks once and stay bound while they
+// remain within twice the gate of the aggregate position. Unbound tracks
+// associate by external id first, then to the nearest aggregate track
+// within the gate (grid-hashed, so a cycle is linear in the number of node
+// tracks). An aggregate track holds at most one track per node, and its
+// members are fused with covariance intersection.
+class TrackAggregator {
+public:
+    TrackAggregator(double gate_m, double stale_sec, double default_sigma_m);
+
+    // Replaces the picture of one node. Thread-safe.
+    void UpdateNode(const std::string& node, std::shared_ptr<const fusion::MonitorResponse> picture);
+
+    // Runs one association/fusion cycle over the latest pictures and writes
+    // the merged picture. Called from a single thread.
+    void Fuse(fusion::MonitorResponse& out);
+
+    struct CycleStats {
+        size_t input_tracks = 0;
+        size_t fused_tracks = 0;
+        size_t new_bindings = 0;
+    };
+    const CycleStats& last_cycle() const { return stats_; }
+
+private:
+    struct NodePicture {
+        std::string name;
+        std::shared_ptr<const fusion::MonitorResponse> picture;
+        std::chrono::steady_clock::time_point received;
+    };
+
+    struct Member {
+        uint32_t node;
+        const fusion::FusedTrack* track;
+    };
+
+    struct Aggregate {
+        double lat = 0.0;
+        double lon = 0.0;
+        std::string external_id;
+        std::vector<Member> members; // Rebuilt every cycle
+    };
+
+    static uint64_t Key(uint32_t node, uint32_t track_id) { return ((uint64_t)node << 32) | track_id; }
+    int64_t Cell(double lat, double lon) const;
+    uint32_t Associate(uint32_t node, const fusion::FusedTrack& t);
+    bool HasMember(const Aggregate& a, uint32_t node) const;
+    void FuseAggregate(uint32_t id, const Aggregate& a, const std::vector<NodePicture>& nodes,
+                       fusion::FusedTrack& out) const;
+
+    double gate_m_;
+    double cell_deg_;
+    std::chrono::steady_clock::duration stale_;
+    double default_var_m2_;
+
+    std::mutex mtx_;
+    std::vector<NodePicture> nodes_; // Guarded by mtx_
+
+    // Fusion-thread state
+    std::unordered_map<uint64_t, uint32_t> bindings_;    // (node, node track id) -> aggregate id
+    std::unordered_map<std::string, uint32_t> by_external_;
+    std::unordered_map<uint32_t, Aggregate> aggregates_;
+    std::unordered_map<int64_t, std::vector<uint32_t>> grid_; // Aggregate positions of the previous cycle
+    uint32_t next_id_ = 1;
+    CycleStats stats_;
+};
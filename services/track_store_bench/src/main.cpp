@@ -0,0 +1,212 @@
+// Checks that the compact track store filters like the double-precision
+// KalmanFilter it replaces, and compares their memory and per-update cost.
+// Both paths fuse the same simulated measurements for every target: one
+// keeps a KalmanFilter per track, the other loads each track from a
+// TrackStore, runs the cycle and stores it back, as the fusion loop does.
+// Exits non-zero when the two estimates drift apart by more than the
+// tolerance.
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kalman_filter.h"
+#include "track_store.h"
+#include "track_update.h"
+
+namespace
+{
+    constexpr double METERS_PER_DEG_LAT = 111320.0;
+
+    // Sensors by MeasurementSigma: 5, 50 and 30 m
+    const char *const SENSORS[] = {"AN-MPQ-53-PATRIOT", "TPS-77-LONG-RANGE", "OTHER"};
+
+    struct BenchConfig
+    {
+        size_t tracks = 100000;
+        size_t cycles = 20;
+        size_t warmup = 5;         // Cycles not scored
+        double dt = 0.5;           // s between a track's measurements
+        double budget_mb = 64.0;
+        double tolerance_m = 0.01; // Max position difference between the paths
+        uint64_t seed = 1;
+    };
+
+    struct Target
+    {
+        double lat, lon;   // deg
+        double v_n, v_e;   // m/s
+    };
+
+    size_t HeapBytes()
+    {
+        struct mallinfo2 mi = mallinfo2();
+        return mi.uordblks + mi.hblkhd; // Small chunks plus mmapped ones
+    }
+
+    double DistanceM(double lat1, double lon1, double lat2, double lon2)
+    {
+        double dn = (lat1 - lat2) * METERS_PER_DEG_LAT;
+        double de = (lon1 - lon2) * METERS_PER_DEG_LAT * std::cos(lat1 * M_PI / 180.0);
+        return std::sqrt(dn * dn + de * de);
+    }
+
+    bool ParseArg(const std::string &arg, const std::string &key, std::string &value)
+    {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], v;
+        if (ParseArg(arg, "tracks", v)) cfg.tracks = std::stoul(v);
+        else if (ParseArg(arg, "cycles", v)) cfg.cycles = std::stoul(v);
+        else if (ParseArg(arg, "warmup", v)) cfg.warmup = std::stoul(v);
+        else if (ParseArg(arg, "dt", v)) cfg.dt = std::stod(v);
+        else if (ParseArg(arg, "budget-mb", v)) cfg.budget_mb = std::stod(v);
+        else if (ParseArg(arg, "tolerance-m", v)) cfg.tolerance_m = std::stod(v);
+        else if (ParseArg(arg, "seed", v)) cfg.seed = std::stoull(v);
+        else
+        {
+            std::cout << "Usage: track_store_bench [options]\n"
+                      << "  --tracks=N          Simulated targets (default 100000)\n"
+                      << "  --cycles=N          Measurements per target (default 20)\n"
+                      << "  --warmup=N          Leading cycles not scored (default 5)\n"
+                      << "  --dt=SEC            Interval between a target's measurements (default 0.5)\n"
+                      << "  --budget-mb=MB      Track store budget (default 64)\n"
+                      << "  --tolerance-m=M     Allowed position difference between the paths (default 0.01)\n"
+                      << "  --seed=N            Random seed (default 1)\n";
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+    if (cfg.tracks == 0 || cfg.cycles <= cfg.warmup)
+    {
+        std::cerr << "[BENCH] tracks must be positive and cycles larger than warmup." << std::endl;
+        return 1;
+    }
+
+    std::cout << "[BENCH] " << cfg.tracks << " tracks x " << cfg.cycles << " cycles, dt " << cfg.dt << " s"
+              << std::endl;
+
+    std::mt19937_64 rng(cfg.seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<Target> targets(cfg.tracks);
+    for (Target &t : targets)
+    {
+        double speed = 50.0 + 200.0 * uniform(rng);
+        double heading = 2.0 * M_PI * uniform(rng);
+        t = {38.0 + 3.0 * uniform(rng), 30.0 + 6.0 * uniform(rng), speed * std::cos(heading), speed * std::sin(heading)};
+    }
+
+    size_t heap_before = HeapBytes();
+    std::vector<KalmanFilter> filters(cfg.tracks);
+    size_t double_bytes = HeapBytes() - heap_before;
+
+    heap_before = HeapBytes();
+    TrackStore store((size_t)(cfg.budget_mb * 1024 * 1024));
+    KalmanFilter scratch;
+    std::vector<uint32_t> evicted;
+
+    double sum_sq_double = 0.0, sum_sq_compact = 0.0, max_diff = 0.0, max_v_diff = 0.0;
+    size_t scored = 0;
+    int64_t double_ns = 0, compact_ns = 0;
+    std::vector<double> lat(cfg.tracks), lon(cfg.tracks);
+    size_t store_bytes = 0;
+
+    for (size_t c = 0; c < cfg.cycles; ++c)
+    {
+        double dt = c == 0 ? 0.0 : cfg.dt;
+        for (size_t i = 0; i < cfg.tracks; ++i)
+        {
+            Target &t = targets[i];
+            t.v_n += 2.0 * normal(rng);
+            t.v_e += 2.0 * normal(rng);
+            t.lat += t.v_n * dt / METERS_PER_DEG_LAT;
+            t.lon += t.v_e * dt / (METERS_PER_DEG_LAT * std::cos(t.lat * M_PI / 180.0));
+            double sigma = MeasurementSigma(SENSORS[i % 3]);
+            lat[i] = t.lat + sigma * normal(rng) / METERS_PER_DEG_LAT;
+            lon[i] = t.lon + sigma * normal(rng) / (METERS_PER_DEG_LAT * std::cos(t.lat * M_PI / 180.0));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < cfg.tracks; ++i)
+        {
+            filters[i].Predict(dt);
+            GatedUpdate(filters[i], SENSORS[i % 3], lat[i], lon[i]);
+        }
+        auto mid = std::chrono::steady_clock::now();
+        uint64_t time_ns = (uint64_t)((c + 1) * cfg.dt * 1e9);
+        for (size_t i = 0; i < cfg.tracks; ++i)
+        {
+            if (!store.Load((uint32_t)i, scratch))
+                scratch.Reset();
+            scratch.Predict(dt);
+            GatedUpdate(scratch, SENSORS[i % 3], lat[i], lon[i]);
+            store.Store((uint32_t)i, scratch, time_ns, evicted);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count();
+        compact_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count();
+        if (c == 0)
+            store_bytes = HeapBytes() - heap_before;
+
+        if (c < cfg.warmup)
+            continue;
+        for (size_t i = 0; i < cfg.tracks; ++i)
+        {
+            if (!store.Load((uint32_t)i, scratch))
+                continue;
+            double d_lat, d_lon, d_vn, d_ve, c_lat, c_lon, c_vn, c_ve;
+            filters[i].GetState(d_lat, d_lon, d_vn, d_ve);
+            scratch.GetState(c_lat, c_lon, c_vn, c_ve);
+            const Target &t = targets[i];
+            double e_double = DistanceM(d_lat, d_lon, t.lat, t.lon);
+            double e_compact = DistanceM(c_lat, c_lon, t.lat, t.lon);
+            sum_sq_double += e_double * e_double;
+            sum_sq_compact += e_compact * e_compact;
+            max_diff = std::max(max_diff, DistanceM(d_lat, d_lon, c_lat, c_lon));
+            max_v_diff = std::max(max_v_diff, std::hypot(d_vn - c_vn, d_ve - c_ve) * METERS_PER_DEG_LAT);
+            ++scored;
+        }
+    }
+
+    double updates = (double)cfg.tracks * cfg.cycles;
+    std::cout << "path       bytes/track   ns/update   RMSE m\n"
+              << std::fixed << std::setprecision(1)
+              << "double  " << std::setw(14) << (double)double_bytes / cfg.tracks
+              << std::setw(12) << double_ns / updates
+              << std::setprecision(3) << std::setw(10) << std::sqrt(sum_sq_double / scored) << "\n"
+              << std::setprecision(1)
+              << "compact " << std::setw(14) << (double)store_bytes / cfg.tracks
+              << std::setw(12) << compact_ns / updates
+              << std::setprecision(3) << std::setw(10) << std::sqrt(sum_sq_compact / scored) << "\n"
+              << std::setprecision(6)
+              << "max position difference " << max_diff << " m, max velocity difference " << max_v_diff
+              << " m/s over " << scored << " scored updates";
+    if (!evicted.empty())
+        std::cout << " (" << evicted.size() << " tracks evicted, budget too small)";
+    std::cout << std::endl;
+
+    if (max_diff > cfg.tolerance_m)
+    {
+        std::cout << "PARITY FAIL: position difference above " << cfg.tolerance_m << " m" << std::endl;
+        return 1;
+    }
+    std::cout << "PARITY OK" << std::endl;
+    return 0;
+}
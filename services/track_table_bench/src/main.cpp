@@ -0,0 +1,233 @@
+// Measures what track churn costs the published-track table: allocations
+// and time per created and deleted track, for the slab-backed TrackTable
+// the fusion service uses and for the unordered_map it replaced. Both see
+// the same churn: every cycle updates the live tracks, starts `churn`
+// tentative tracks and deletes the `churn` oldest. Exits non-zero when the
+// two tables end up with different contents or a handle to a deleted track
+// still resolves.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fusion/fusion.pb.h"
+#include "fused_track_table.h"
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};
+}
+
+// Every heap allocation in the process goes through here, so the table
+// code can be measured by the allocations made between two points.
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+namespace
+{
+    struct BenchConfig
+    {
+        size_t live = 10000;       // Confirmed tracks kept throughout
+        size_t churn = 2000;       // Tentative tracks created and deleted per cycle
+        size_t cycles = 50;
+        size_t warmup = 5;         // Cycles not measured (tables reach their peak size)
+    };
+
+    struct Result
+    {
+        uint64_t allocations = 0;
+        int64_t ns = 0;
+    };
+
+    // Fills a track the way a fusion cycle publishes one.
+    void Publish(fusion::FusedTrack &ft, uint32_t id, size_t cycle)
+    {
+        ft.set_track_id(id);
+        ft.mutable_position()->set_lat(39.0 + (id % 1000) * 1e-3);
+        ft.mutable_position()->set_lon(32.0 + cycle * 1e-4);
+        ft.mutable_position()->set_alt(1250.0);
+        ft.set_confidence(0.95);
+        ft.set_measurement_ts((int64_t)cycle * 500);
+        ft.mutable_covariance()->set_north_north(100.0);
+        ft.mutable_covariance()->set_east_east(100.0);
+        ft.clear_source_sensors();
+        ft.add_source_sensors("TPS-77-LONG-RANGE-RADAR-NORTH");
+        if (id % 2 == 0)
+            ft.add_source_sensors("AN-MPQ-53-PATRIOT-BATTERY-2");
+        ft.set_uav_error_m((double)(id % 97));
+    }
+
+    // Runs the churn on one table. `Table` adapts a container to
+    // Emplace / Erase / Find.
+    template <typename Table>
+    Result Run(Table &table, const BenchConfig &cfg)
+    {
+        Result r;
+        std::deque<uint32_t> tentative;
+        std::vector<std::string> names;
+        uint32_t next_id = 1;
+
+        for (; next_id <= cfg.live; ++next_id)
+        {
+            fusion::FusedTrack &ft = table.Emplace(next_id);
+            ft.set_external_id("UAV-" + std::to_string(next_id));
+            Publish(ft, next_id, 0);
+        }
+
+        for (size_t c = 0; c < cfg.cycles; ++c)
+        {
+            // Names are built up front so only the table is measured.
+            names.resize(cfg.churn);
+            for (size_t i = 0; i < cfg.churn; ++i)
+                names[i] = "TENTATIVE-" + std::to_string(next_id + i);
+
+            uint64_t allocs = g_allocations.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t id = 1; id <= cfg.live; ++id)
+                Publish(*table.Find(id), id, c);
+            for (size_t i = 0; i < cfg.churn; ++i)
+            {
+                fusion::FusedTrack &ft = table.Emplace(next_id);
+                ft.set_external_id(names[i]);
+                Publish(ft, next_id, c);
+                tentative.push_back(next_id++);
+            }
+            while (tentative.size() > cfg.churn)
+            {
+                table.Erase(tentative.front());
+                tentative.pop_front();
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (c >= cfg.warmup)
+            {
+                r.allocations += g_allocations.load(std::memory_order_relaxed) - allocs;
+                r.ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            }
+        }
+        return r;
+    }
+
+    struct MapTable
+    {
+        std::unordered_map<uint32_t, fusion::FusedTrack> map;
+        fusion::FusedTrack &Emplace(uint32_t id) { return map[id]; }
+        fusion::FusedTrack *Find(uint32_t id)
+        {
+            auto it = map.find(id);
+            return it == map.end() ? nullptr : &it->second;
+        }
+        void Erase(uint32_t id) { map.erase(id); }
+    };
+
+    struct SlabTable
+    {
+        FusedTrackTable table;
+        fusion::FusedTrack &Emplace(uint32_t id) { return table.Emplace(id); }
+        fusion::FusedTrack *Find(uint32_t id) { return table.Find(id); }
+        void Erase(uint32_t id) { table.Erase(id); }
+    };
+
+    bool ParseArg(const std::string &arg, const std::string &key, std::string &value)
+    {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], v;
+        if (ParseArg(arg, "live", v)) cfg.live = std::stoul(v);
+        else if (ParseArg(arg, "churn", v)) cfg.churn = std::stoul(v);
+        else if (ParseArg(arg, "cycles", v)) cfg.cycles = std::stoul(v);
+        else if (ParseArg(arg, "warmup", v)) cfg.warmup = std::stoul(v);
+        else
+        {
+            std::cout << "Usage: track_table_bench [options]\n"
+                      << "  --live=N            Confirmed tracks kept throughout (default 10000)\n"
+                      << "  --churn=N           Tentative tracks created and deleted per cycle (default 2000)\n"
+                      << "  --cycles=N          Fusion cycles (default 50)\n"
+                      << "  --warmup=N          Leading cycles not measured (default 5)\n";
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+    if (cfg.churn == 0 || cfg.cycles <= cfg.warmup)
+    {
+        std::cerr << "[BENCH] churn must be positive and cycles larger than warmup." << std::endl;
+        return 1;
+    }
+
+    std::cout << "[BENCH] " << cfg.live << " live tracks, " << cfg.churn << " tentative tracks created and deleted per cycle, "
+              << cfg.cycles << " cycles" << std::endl;
+
+    MapTable map_table;
+    SlabTable slab_table;
+    Result map = Run(map_table, cfg);
+    Result slab = Run(slab_table, cfg);
+
+    double churned = (double)cfg.churn * (cfg.cycles - cfg.warmup);
+    std::cout << "table      allocs/churned track   ns/cycle\n"
+              << std::fixed << std::setprecision(2)
+              << "map    " << std::setw(24) << map.allocations / churned
+              << std::setprecision(0) << std::setw(12) << (double)map.ns / (cfg.cycles - cfg.warmup) << "\n"
+              << std::setprecision(2)
+              << "slab   " << std::setw(24) << slab.allocations / churned
+              << std::setprecision(0) << std::setw(12) << (double)slab.ns / (cfg.cycles - cfg.warmup) << std::endl;
+
+    // Same contents in both tables
+    bool ok = map_table.map.size() == slab_table.table.size();
+    std::string a, b;
+    for (const auto &kv : map_table.map)
+    {
+        const fusion::FusedTrack *t = slab_table.table.Find(kv.first);
+        if (!t || !kv.second.SerializeToString(&a) || !t->SerializeToString(&b) || a != b)
+        {
+            ok = false;
+            break;
+        }
+    }
+    if (!ok)
+    {
+        std::cout << "PARITY FAIL: tables differ" << std::endl;
+        return 1;
+    }
+
+    // A handle must not follow its slot to the next track.
+    FusedTrackTable &t = slab_table.table;
+    uint32_t victim = (uint32_t)cfg.live + 1, newcomer = 1u << 24;
+    while (!t.Find(victim))
+        ++victim;
+    auto handle = t.HandleOf(victim);
+    t.Erase(victim);
+    t.Emplace(newcomer);
+    if (t.Get(handle) || t.SlotOf(newcomer) != handle.slot || !t.Get(t.HandleOf(newcomer)))
+    {
+        std::cout << "HANDLE FAIL: stale handle resolved" << std::endl;
+        return 1;
+    }
+    std::cout << "PARITY OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,287 @@
+// Compares the per-message CPU cost and delivery latency of the two sensor
+// paths into fusion: a gRPC client stream (protobuf + HTTP/2 over loopback
+// TCP) and the shared-memory ring. Producer and consumer run in this process
+// so both sides are counted; the consumer mimics fusion's ingest loop.
+#include <grpcpp/grpcpp.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "fusion/fusion.grpc.pb.h"
+#include "sensors/radar.pb.h"
+#include "shm_ring.h"
+
+namespace
+{
+    struct BenchConfig
+    {
+        size_t messages = 200000;   // Throughput run
+        double rate_hz = 10000.0;   // Paced run, for latency
+        double paced_sec = 3.0;
+        std::string shm_dir = "/dev/shm";
+    };
+
+    struct Result
+    {
+        double producer_cpu_ns = 0.0; // Per message, sending thread
+        double total_cpu_ns = 0.0;    // Per message, whole process
+        double throughput = 0.0;      // Messages per second
+        std::vector<int64_t> latency_ns;
+    };
+
+    int64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int64_t ThreadCpuNs()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    int64_t ProcessCpuNs()
+    {
+        rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        return ((int64_t)ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000 +
+               ((int64_t)ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000;
+    }
+
+    sensors::RadarDetection MakeDetection(size_t i)
+    {
+        sensors::RadarDetection msg;
+        msg.mutable_header()->set_sensor_id("TPS-77-LONG-RANGE");
+        msg.set_track_id("TGT-" + std::to_string(i % 50));
+        msg.set_range(12000.0 + i % 100);
+        msg.set_bearing(45.0);
+        msg.set_elevation(2.0);
+        msg.set_rcs(10.0);
+        msg.set_velocity(-120.0);
+        msg.set_radar_lat(39.9 + (i % 100) * 1e-4);
+        msg.set_radar_lon(32.8);
+        msg.set_radar_alt(1200.0);
+        return msg;
+    }
+
+    // Sends `count` messages, at `rate_hz` if positive, stamping each with
+    // the send time; returns the sending thread's CPU time.
+    template <typename SendFn>
+    int64_t Produce(size_t count, double rate_hz, SendFn &&send)
+    {
+        sensors::RadarDetection msg = MakeDetection(0);
+        auto start = std::chrono::steady_clock::now();
+        int64_t cpu0 = ThreadCpuNs();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (rate_hz > 0.0)
+            {
+                // Sleep rather than spin so the consumer gets the core on
+                // small hosts.
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds((int64_t)(i * 1e9 / rate_hz)));
+            }
+            msg.set_track_id(i % 2 ? "TGT-1" : "TGT-2");
+            msg.mutable_header()->set_timestamp_ns(NowNs());
+            send(msg);
+        }
+        return ThreadCpuNs() - cpu0;
+    }
+
+    // Minimal fusion endpoint: reads radar messages and records latency.
+    class SinkService final : public fusion::FusionService::Service
+    {
+    public:
+        std::vector<int64_t> latency_ns;
+        std::atomic<size_t> received{0};
+
+        grpc::Status StreamRadar(grpc::ServerContext *, grpc::ServerReader<sensors::RadarDetection> *reader,
+                                 fusion::FusionAck *) override
+        {
+            sensors::RadarDetection msg;
+            while (reader->Read(&msg))
+            {
+                latency_ns.push_back(NowNs() - msg.header().timestamp_ns());
+                received.fetch_add(1, std::memory_order_release);
+            }
+            return grpc::Status::OK;
+        }
+    };
+
+    Result RunGrpc(size_t count, double rate_hz)
+    {
+        SinkService service;
+        service.latency_ns.reserve(count);
+        int port = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&service);
+        std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+
+        auto stub = fusion::FusionService::NewStub(
+            grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+        grpc::ClientContext context;
+        fusion::FusionAck ack;
+        auto writer = stub->StreamRadar(&context, &ack);
+
+        Result r;
+        auto t0 = std::chrono::steady_clock::now();
+        int64_t cpu0 = ProcessCpuNs();
+        int64_t producer_cpu = Produce(count, rate_hz, [&](const sensors::RadarDetection &m) { writer->Write(m); });
+        writer->WritesDone();
+        writer->Finish();
+        while (service.received.load(std::memory_order_acquire) < count)
+            std::this_thread::yield();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        r.total_cpu_ns = (double)(ProcessCpuNs() - cpu0) / count;
+        r.producer_cpu_ns = (double)producer_cpu / count;
+        r.throughput = count / sec;
+        r.latency_ns = std::move(service.latency_ns);
+        server->Shutdown();
+        return r;
+    }
+
+    Result RunShm(size_t count, double rate_hz, const std::string &dir)
+    {
+        auto producer = shm::Producer::Create(dir, "transport-bench." + std::to_string(getpid()), 65536);
+        if (!producer)
+            return {};
+        auto consumer = shm::Consumer::Attach(dir + "/bfsim.transport-bench." + std::to_string(getpid()) + ".ring");
+
+        Result r;
+        r.latency_ns.reserve(count);
+        std::thread reader([&]
+                           {
+                               // Same polling policy as fusion's ShmIngest.
+                               size_t got = 0;
+                               shm::IdleWait idle;
+                               std::string sensor_id, target_id;
+                               while (got < count)
+                               {
+                                   size_t n = consumer->Drain(4096, [&](const shm::MeasurementRecord &rec)
+                                                              {
+                                                                  sensor_id = shm::GetId(rec.sensor_id);
+                                                                  target_id = shm::GetId(rec.target_id);
+                                                                  r.latency_ns.push_back(NowNs() - rec.timestamp_ns);
+                                                              });
+                                   got += n;
+                                   if (n > 0)
+                                       idle.Reset();
+                                   else
+                                       idle.Wait();
+                               }
+                           });
+
+        auto t0 = std::chrono::steady_clock::now();
+        int64_t cpu0 = ProcessCpuNs();
+        int64_t producer_cpu = Produce(count, rate_hz, [&](const sensors::RadarDetection &m)
+                                       {
+                                           shm::MeasurementRecord *rec;
+                                           while (!(rec = producer->Claim()))
+                                               std::this_thread::yield();
+                                           // Same field copy as RadarClient::sendDetection.
+                                           rec->timestamp_ms = m.header().timestamp();
+                                           rec->timestamp_ns = m.header().timestamp_ns();
+                                           rec->kind = shm::RecordKind::RADAR;
+                                           rec->lat = m.radar_lat();
+                                           rec->lon = m.radar_lon();
+                                           rec->alt = m.radar_alt();
+                                           rec->range = m.range();
+                                           rec->bearing = m.bearing();
+                                           rec->elevation = m.elevation();
+                                           rec->rcs = m.rcs();
+                                           rec->velocity = m.velocity();
+                                           rec->velocity_sigma = (float)m.velocity_sigma();
+                                           rec->range_sigma = (float)m.range_sigma();
+                                           rec->bearing_sigma = (float)m.bearing_sigma();
+                                           rec->speed = rec->heading = 0.0;
+                                           shm::SetId(rec->sensor_id, m.header().sensor_id());
+                                           shm::SetId(rec->target_id, m.track_id());
+                                           producer->Commit();
+                                       });
+        reader.join();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        r.total_cpu_ns = (double)(ProcessCpuNs() - cpu0) / count;
+        r.producer_cpu_ns = (double)producer_cpu / count;
+        r.throughput = count / sec;
+        return r;
+    }
+
+    double Percentile(std::vector<int64_t> &v, double p)
+    {
+        if (v.empty())
+            return 0.0;
+        size_t idx = std::min(v.size() - 1, (size_t)(p * v.size()));
+        std::nth_element(v.begin(), v.begin() + idx, v.end());
+        return v[idx] / 1000.0;
+    }
+
+    void Print(const char *name, Result &bulk, Result &paced)
+    {
+        std::cout << std::left << std::setw(6) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << bulk.throughput
+                  << std::setw(12) << bulk.producer_cpu_ns
+                  << std::setw(12) << bulk.total_cpu_ns
+                  << std::setprecision(1)
+                  << std::setw(10) << Percentile(paced.latency_ns, 0.50)
+                  << std::setw(10) << Percentile(paced.latency_ns, 0.99)
+                  << std::setw(10) << Percentile(paced.latency_ns, 1.0) << std::endl;
+    }
+
+    bool ParseArg(const std::string &arg, const std::string &key, std::string &value)
+    {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], v;
+        if (ParseArg(arg, "messages", v)) cfg.messages = std::stoul(v);
+        else if (ParseArg(arg, "rate", v)) cfg.rate_hz = std::stod(v);
+        else if (ParseArg(arg, "paced-seconds", v)) cfg.paced_sec = std::stod(v);
+        else if (ParseArg(arg, "shm-dir", v)) cfg.shm_dir = v;
+        else
+        {
+            std::cout << "Usage: transport_bench [options]\n"
+                      << "  --messages=N         Messages in the throughput run (default 200000)\n"
+                      << "  --rate=HZ            Send rate of the latency run (default 10000)\n"
+                      << "  --paced-seconds=SEC  Length of the latency run (default 3)\n"
+                      << "  --shm-dir=DIR        Segment directory (default /dev/shm)\n";
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    size_t paced = (size_t)(cfg.rate_hz * cfg.paced_sec);
+    std::cout << "[BENCH] Throughput run: " << cfg.messages << " radar detections; latency run: "
+              << paced << " at " << cfg.rate_hz << " Hz" << std::endl;
+
+    Result grpc_bulk = RunGrpc(cfg.messages, 0.0);
+    Result grpc_paced = RunGrpc(paced, cfg.rate_hz);
+    Result shm_bulk = RunShm(cfg.messages, 0.0, cfg.shm_dir);
+    Result shm_paced = RunShm(paced, cfg.rate_hz, cfg.shm_dir);
+
+    std::cout << "path      msg/s   send ns/msg  cpu ns/msg   p50 us    p99 us    max us\n";
+    Print("grpc", grpc_bulk, grpc_paced);
+    Print("shm", shm_bulk, shm_paced);
+    std::cout << "(cpu ns/msg counts both sides; latency is send to consumer read)" << std::endl;
+    return 0;
+}